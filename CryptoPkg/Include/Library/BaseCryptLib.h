@@ -2455,6 +2455,175 @@ Pkcs7Verify (
   IN  UINTN        DataLength
   );
 
+/**
+  Allocates and initializes a PKCS#7 verification context for a trusted/root
+  certificate.
+
+  The context keeps the parsed trusted certificate, so that it is not parsed
+  again for each verification. An implementation may also keep the certificate
+  chains already verified up to it, so that PKCS#7 signed data carrying the
+  same signer and intermediate certificates skip the chain building.
+
+  If TrustedCert is NULL, then return NULL.
+  If CertLength overflow, then return NULL.
+  If this interface is not supported, then return NULL.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 verification context that has been initialized.
+           If the allocations fails, Pkcs7VerifyContextNew() returns NULL.
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  If this interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID  *Pkcs7VerifyContext
+  );
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard", using the trusted certificate of a
+  PKCS#7 verification context. The input signed data could be wrapped in a
+  ContentInfo structure.
+
+  The result is the same as Pkcs7Verify() with the trusted certificate of the
+  context.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]  InData              Pointer to the content to be verified.
+  @param[in]  DataLength          Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  );
+
+/**
+  Allocates and initializes a PKCS#7 streaming verification context.
+
+  The content signed by the detached PKCS#7 signed data is then provided in
+  pieces with Pkcs7VerifyStreamUpdate(), so that it doesn't need to be
+  contiguous in memory, and verified with Pkcs7VerifyStreamFinal(). The result
+  is the same as Pkcs7Verify() over the concatenation of the pieces.
+
+  If P7Data or TrustedCert is NULL, then return NULL.
+  If P7Length or CertLength overflow, then return NULL.
+  If this interface is not supported, then return NULL.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 streaming verification context that has been
+           initialized. If the PKCS#7 message is not a detached signed data, or
+           an allocation fails, Pkcs7VerifyStreamNew() returns NULL.
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyStreamNew (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
+/**
+  Provides the next piece of the content to a PKCS#7 streaming verification
+  context.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If InData is NULL and DataLength is not 0, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+  @param[in]       InData             Pointer to the piece of content.
+  @param[in]       DataLength         Length of InData in bytes.
+
+  @retval  TRUE   The piece of content is processed.
+  @retval  FALSE  The piece of content can't be processed.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamUpdate (
+  IN OUT  VOID         *Pkcs7VerifyStream,
+  IN      CONST UINT8  *InData,
+  IN      UINTN        DataLength
+  );
+
+/**
+  Verifies the validity of the PKCS#7 signed data of a PKCS#7 streaming
+  verification context over all the content provided so far.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamFinal (
+  IN OUT  VOID  *Pkcs7VerifyStream
+  );
+
+/**
+  Release the specified PKCS#7 streaming verification context.
+
+  If this interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyStreamFree (
+  IN  VOID  *Pkcs7VerifyStream
+  );
+
 /**
   This function receives a PKCS7 formatted signature, and then verifies that
   the specified Enhanced or Extended Key Usages (EKU's) are present in the end-entity
@@ -2561,6 +2730,40 @@ AuthenticodeVerify (
   IN  UINTN        HashSize
   );
 
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format", using the trusted certificate
+  of a PKCS#7 verification context created by Pkcs7VerifyContextNew().
+
+  If Pkcs7VerifyContext is NULL, then return FALSE.
+  If AuthData is NULL, then return FALSE.
+  If ImageHash is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                  PE/COFF image to be verified.
+  @param[in]  DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]  ImageHash           Pointer to the original image file hash value. The procedure
+                                  for calculating the image hash value is described in Authenticode
+                                  specification.
+  @param[in]  HashSize            Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize
+  );
+
 /**
   Verifies the validity of a RFC3161 Timestamp CounterSignature embedded in PE/COFF Authenticode
   signature.
@@ -114,18 +114,26 @@ typedef struct {
   } Md5;                            // Deprecated
   union {
     struct {
-      UINT8    Pkcs1v2Encrypt             : 1;
-      UINT8    Pkcs5HashPassword          : 1;
-      UINT8    Pkcs7Verify                : 1;
-      UINT8    VerifyEKUsInPkcs7Signature : 1;
-      UINT8    Pkcs7GetSigners            : 1;
-      UINT8    Pkcs7FreeSigners           : 1;
-      UINT8    Pkcs7Sign                  : 1;
-      UINT8    Pkcs7GetAttachedContent    : 1;
-      UINT8    Pkcs7GetCertificatesList   : 1;
-      UINT8    AuthenticodeVerify         : 1;
-      UINT8    ImageTimestampVerify       : 1;
-      UINT8    Pkcs1v2Decrypt             : 1;
+      UINT8    Pkcs1v2Encrypt                : 1;
+      UINT8    Pkcs5HashPassword             : 1;
+      UINT8    Pkcs7Verify                   : 1;
+      UINT8    VerifyEKUsInPkcs7Signature    : 1;
+      UINT8    Pkcs7GetSigners               : 1;
+      UINT8    Pkcs7FreeSigners              : 1;
+      UINT8    Pkcs7Sign                     : 1;
+      UINT8    Pkcs7GetAttachedContent       : 1;
+      UINT8    Pkcs7GetCertificatesList      : 1;
+      UINT8    AuthenticodeVerify            : 1;
+      UINT8    ImageTimestampVerify          : 1;
+      UINT8    Pkcs1v2Decrypt                : 1;
+      UINT8    Pkcs7VerifyContextNew         : 1;
+      UINT8    Pkcs7VerifyContextFree        : 1;
+      UINT8    Pkcs7VerifyWithContext        : 1;
+      UINT8    AuthenticodeVerifyWithContext : 1;
+      UINT8    Pkcs7VerifyStreamNew          : 1;
+      UINT8    Pkcs7VerifyStreamUpdate       : 1;
+      UINT8    Pkcs7VerifyStreamFinal        : 1;
+      UINT8    Pkcs7VerifyStreamFree         : 1;
     } Services;
     UINT32    Family;
   } Pkcs;
@@ -327,6 +335,7 @@ typedef struct {
       UINT8    HostPrivateKeyEx   : 1;
       UINT8    SignatureAlgoList  : 1;
       UINT8    EcCurve            : 1;
+      UINT8    ResumeSession      : 1;
     } Services;
     UINT32    Family;
   } TlsSet;
@@ -346,6 +355,8 @@ typedef struct {
       UINT8    HostPrivateKey       : 1;
       UINT8    CertRevocationList   : 1;
       UINT8    ExportKey            : 1;
+      UINT8    ResumeSession        : 1;
+      UINT8    SessionReused        : 1;
     } Services;
     UINT32    Family;
   } TlsGet;
@@ -1,23 +1,31 @@
 /** @file
-  Dispatch Block to Aps in Dxe phase for parallelhash algorithm.
+  Dispatch crypto jobs to Aps in Dxe phase.
 
 Copyright (c) 2022, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
-#include "CryptParallelHash.h"
+#include "CryptParallelJob.h"
 #include <Library/UefiBootServicesTableLib.h>
 #include <Protocol/MpService.h>
 
 /**
-  Dispatch the block task to each AP in PEI phase.
+  Dispatch a crypto job to each AP in DXE phase.
+
+  The APs run CryptParallelJobApExecute() with the job as argument. This
+  function returns when all the APs are done with the job.
+
+  @param[in]  Job  Pointer to the job.
+
+  @retval TRUE   The job was dispatched to the APs.
+  @retval FALSE  The MP services are not available.
 
 **/
-VOID
+BOOLEAN
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchJobToAp (
+  IN CRYPT_PARALLEL_JOB  *Job
   )
 {
   EFI_STATUS                Status;
@@ -30,20 +38,20 @@ DispatchBlockToAp (
                   );
   if (EFI_ERROR (Status)) {
     //
-    // Failed to locate MpServices Protocol, do parallel hash by one core.
+    // Failed to locate MpServices Protocol, run the job by one core.
     //
-    DEBUG ((DEBUG_ERROR, "[DispatchBlockToApDxe] Failed to locate MpServices Protocol. Status = %r\n", Status));
-    return;
+    DEBUG ((DEBUG_INFO, "[DispatchJobToApDxe] Failed to locate MpServices Protocol. Status = %r\n", Status));
+    return FALSE;
   }
 
   Status = MpServices->StartupAllAPs (
                          MpServices,
-                         ParallelHashApExecute,
+                         CryptParallelJobApExecute,
                          FALSE,
                          NULL,
                          0,
-                         NULL,
+                         Job,
                          NULL
                          );
-  return;
+  return !EFI_ERROR (Status);
 }
@@ -1,35 +1,46 @@
 /** @file
-  Dispatch the block task to each AP in Smm mode for parallelhash algorithm.
+  Dispatch crypto jobs to each AP in Smm mode.
 
 Copyright (c) 2022, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
-#include "CryptParallelHash.h"
+#include "CryptParallelJob.h"
 #include <Library/MmServicesTableLib.h>
 
 /**
-  Dispatch the block task to each AP in SMM mode.
+  Dispatch a crypto job to each AP in SMM mode.
+
+  The APs run CryptParallelJobApExecute() with the job as argument.
+  MmStartupThisAp() may return before the AP is done, so ApCount is set to
+  the number of APs started.
+
+  @param[in]  Job  Pointer to the job.
+
+  @retval TRUE   The job was dispatched to the APs.
+  @retval FALSE  The MM services are not available.
 
 **/
-VOID
+BOOLEAN
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchJobToAp (
+  IN CRYPT_PARALLEL_JOB  *Job
   )
 {
   UINTN  Index;
 
   if (gMmst == NULL) {
-    return;
+    return FALSE;
   }
 
   for (Index = 0; Index < gMmst->NumberOfCpus; Index++) {
     if (Index != gMmst->CurrentlyExecutingCpu) {
-      gMmst->MmStartupThisAp (ParallelHashApExecute, Index, NULL);
+      if (!EFI_ERROR (gMmst->MmStartupThisAp (CryptParallelJobApExecute, Index, Job))) {
+        Job->ApCount++;
+      }
     }
   }
 
-  return;
+  return TRUE;
 }
@@ -1,25 +1,33 @@
 /** @file
-  Dispatch Block to Aps in Pei phase for parallelhash algorithm.
+  Dispatch crypto jobs to Aps in Pei phase.
 
 Copyright (c) 2022, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
-#include "CryptParallelHash.h"
+#include "CryptParallelJob.h"
 #include <Library/PeiServicesTablePointerLib.h>
 #include <PiPei.h>
 #include <Ppi/MpServices.h>
 #include <Library/PeiServicesLib.h>
 
 /**
-  Dispatch the block task to each AP in PEI phase.
+  Dispatch a crypto job to each AP in PEI phase.
+
+  The APs run CryptParallelJobApExecute() with the job as argument. This
+  function returns when all the APs are done with the job.
+
+  @param[in]  Job  Pointer to the job.
+
+  @retval TRUE   The job was dispatched to the APs.
+  @retval FALSE  The MP services are not available.
 
 **/
-VOID
+BOOLEAN
 EFIAPI
-DispatchBlockToAp (
-  VOID
+DispatchJobToAp (
+  IN CRYPT_PARALLEL_JOB  *Job
   )
 {
   EFI_STATUS               Status;
@@ -36,19 +44,19 @@ DispatchBlockToAp (
                                   );
   if (EFI_ERROR (Status)) {
     //
-    // Failed to locate MpServices Ppi, do parallel hash by one core.
+    // Failed to locate MpServices Ppi, run the job by one core.
     //
-    DEBUG ((DEBUG_ERROR, "[DispatchBlockToApPei] Failed to locate MpServices Ppi. Status = %r\n", Status));
-    return;
+    DEBUG ((DEBUG_INFO, "[DispatchJobToApPei] Failed to locate MpServices Ppi. Status = %r\n", Status));
+    return FALSE;
   }
 
   Status = MpServicesPpi->StartupAllAPs (
                             (CONST EFI_PEI_SERVICES **)PeiServices,
                             MpServicesPpi,
-                            ParallelHashApExecute,
+                            CryptParallelJobApExecute,
                             FALSE,
                             0,
-                            NULL
+                            Job
                             );
-  return;
+  return !EFI_ERROR (Status);
 }
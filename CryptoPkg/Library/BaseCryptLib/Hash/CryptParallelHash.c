@@ -7,65 +7,58 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "CryptParallelHash.h"
-#include <Library/SynchronizationLib.h>
+#include "CryptParallelJob.h"
 
 #define PARALLELHASH_CUSTOMIZATION  "ParallelHash"
 
-UINTN      mBlockNum;
-UINTN      mBlockSize;
-UINTN      mLastBlockSize;
-UINT8      *mInput;
-UINTN      mBlockResultSize;
-UINT8      *mBlockHashResult;
-BOOLEAN    *mBlockIsCompleted;
-SPIN_LOCK  *mSpinLockList;
+//
+// Context of the job computing the digest of each block.
+//
+typedef struct {
+  CONST UINT8    *Input;
+  UINTN          BlockNum;
+  UINTN          BlockSize;
+  UINTN          LastBlockSize;
+  UINTN          BlockResultSize;
+  UINT8          *BlockHashResult;
+} PARALLEL_HASH_JOB;
 
 /**
-  Complete computation of digest of each block.
+  Complete computation of digest of one block.
 
-  Each AP perform the function called by BSP.
+  The BSP and the APs run this task for each block.
 
-  @param[in] ProcedureArgument Argument of the procedure.
+  @param[in]  JobContext  Pointer to the PARALLEL_HASH_JOB.
+  @param[in]  TaskIndex   Index of the block.
+
+  @retval TRUE   The digest of the block is computed.
+  @retval FALSE  The digest computation failed.
 **/
-VOID
+STATIC
+BOOLEAN
 EFIAPI
-ParallelHashApExecute (
-  IN VOID  *ProcedureArgument
+ParallelHashBlockTask (
+  IN VOID   *JobContext,
+  IN UINTN  TaskIndex
   )
 {
-  UINTN    Index;
-  BOOLEAN  Status;
-
-  for (Index = 0; Index < mBlockNum; Index++) {
-    if (AcquireSpinLockOrFail (&mSpinLockList[Index])) {
-      //
-      // Completed, try next one.
-      //
-      if (mBlockIsCompleted[Index]) {
-        ReleaseSpinLock (&mSpinLockList[Index]);
-        continue;
-      }
-
-      //
-      // Calculate CShake256 for this block.
-      //
-      Status = CShake256HashAll (
-                 mInput + Index * mBlockSize,
-                 (Index == (mBlockNum - 1)) ? mLastBlockSize : mBlockSize,
-                 mBlockResultSize,
-                 NULL,
-                 0,
-                 NULL,
-                 0,
-                 mBlockHashResult + Index * mBlockResultSize
-                 );
-      if (!EFI_ERROR (Status)) {
-        mBlockIsCompleted[Index] = TRUE;
-      }
-
-      ReleaseSpinLock (&mSpinLockList[Index]);
-    }
-  }
+  PARALLEL_HASH_JOB  *Job;
+
+  Job = (PARALLEL_HASH_JOB *)JobContext;
+
+  //
+  // Calculate CShake256 for this block.
+  //
+  return CShake256HashAll (
+           Job->Input + TaskIndex * Job->BlockSize,
+           (TaskIndex == (Job->BlockNum - 1)) ? Job->LastBlockSize : Job->BlockSize,
+           Job->BlockResultSize,
+           NULL,
+           0,
+           NULL,
+           0,
+           Job->BlockHashResult + TaskIndex * Job->BlockResultSize
+           );
 }
 
 /**
@@ -97,18 +90,17 @@ ParallelHash256HashAll (
   IN       UINTN  CustomByteLen
   )
 {
-  UINT8    EncBufB[sizeof (UINTN)+1];
-  UINTN    EncSizeB;
-  UINT8    EncBufN[sizeof (UINTN)+1];
-  UINTN    EncSizeN;
-  UINT8    EncBufL[sizeof (UINTN)+1];
-  UINTN    EncSizeL;
-  UINTN    Index;
-  UINT8    *CombinedInput;
-  UINTN    CombinedInputSize;
-  BOOLEAN  AllCompleted;
-  UINTN    Offset;
-  BOOLEAN  ReturnValue;
+  UINT8              EncBufB[sizeof (UINTN)+1];
+  UINTN              EncSizeB;
+  UINT8              EncBufN[sizeof (UINTN)+1];
+  UINTN              EncSizeN;
+  UINT8              EncBufL[sizeof (UINTN)+1];
+  UINTN              EncSizeL;
+  UINT8              *CombinedInput;
+  UINTN              CombinedInputSize;
+  UINTN              Offset;
+  BOOLEAN            ReturnValue;
+  PARALLEL_HASH_JOB  Job;
 
   if ((InputByteLen == 0) || (OutputByteLen == 0) || (BlockSize == 0)) {
     return FALSE;
@@ -122,35 +114,32 @@ ParallelHash256HashAll (
     return FALSE;
   }
 
-  mBlockSize = BlockSize;
+  Job.BlockSize = BlockSize;
 
   //
   // Calculate block number n.
   //
-  mBlockNum = InputByteLen % mBlockSize == 0 ? InputByteLen / mBlockSize : InputByteLen / mBlockSize + 1;
+  Job.BlockNum = InputByteLen % Job.BlockSize == 0 ? InputByteLen / Job.BlockSize : InputByteLen / Job.BlockSize + 1;
 
   //
   // Set hash result size of each block in bytes.
   //
-  mBlockResultSize = OutputByteLen;
+  Job.BlockResultSize = OutputByteLen;
 
   //
   // Encode B, n, L to string and record size.
   //
-  EncSizeB = LeftEncode (EncBufB, mBlockSize);
-  EncSizeN = RightEncode (EncBufN, mBlockNum);
+  EncSizeB = LeftEncode (EncBufB, Job.BlockSize);
+  EncSizeN = RightEncode (EncBufN, Job.BlockNum);
   EncSizeL = RightEncode (EncBufL, OutputByteLen * CHAR_BIT);
 
   //
-  // Allocate buffer for combined input (newX), Block completed flag and SpinLock.
+  // Allocate buffer for combined input (newX).
   //
-  CombinedInputSize = EncSizeB + EncSizeN + EncSizeL + mBlockNum * mBlockResultSize;
+  CombinedInputSize = EncSizeB + EncSizeN + EncSizeL + Job.BlockNum * Job.BlockResultSize;
   CombinedInput     = AllocateZeroPool (CombinedInputSize);
-  mBlockIsCompleted = AllocateZeroPool (mBlockNum * sizeof (BOOLEAN));
-  mSpinLockList     = AllocatePool (mBlockNum * sizeof (SPIN_LOCK));
-  if ((CombinedInput == NULL) || (mBlockIsCompleted == NULL) || (mSpinLockList == NULL)) {
-    ReturnValue = FALSE;
-    goto Exit;
+  if (CombinedInput == NULL) {
+    return FALSE;
   }
 
   //
@@ -159,63 +148,21 @@ ParallelHash256HashAll (
   CopyMem (CombinedInput, EncBufB, EncSizeB);
 
   //
-  // Prepare for parallel hash.
+  // Compute the digest of each block on all processors.
   //
-  mBlockHashResult = CombinedInput + EncSizeB;
-  mInput           = (UINT8 *)Input;
-  mLastBlockSize   = InputByteLen % mBlockSize == 0 ? mBlockSize : InputByteLen % mBlockSize;
+  Job.BlockHashResult = CombinedInput + EncSizeB;
+  Job.Input           = (CONST UINT8 *)Input;
+  Job.LastBlockSize   = InputByteLen % Job.BlockSize == 0 ? Job.BlockSize : InputByteLen % Job.BlockSize;
 
-  //
-  // Initialize SpinLock for each result block.
-  //
-  for (Index = 0; Index < mBlockNum; Index++) {
-    InitializeSpinLock (&mSpinLockList[Index]);
+  ReturnValue = CryptRunParallelJob (ParallelHashBlockTask, &Job, Job.BlockNum);
+  if (!ReturnValue) {
+    goto Exit;
   }
 
-  //
-  // Dispatch blocklist to each AP.
-  //
-  DispatchBlockToAp ();
-
-  //
-  // Wait until all block hash completed.
-  //
-  do {
-    AllCompleted = TRUE;
-    for (Index = 0; Index < mBlockNum; Index++) {
-      if (AcquireSpinLockOrFail (&mSpinLockList[Index])) {
-        if (!mBlockIsCompleted[Index]) {
-          AllCompleted = FALSE;
-          ReturnValue  = CShake256HashAll (
-                           mInput + Index * mBlockSize,
-                           (Index == (mBlockNum - 1)) ? mLastBlockSize : mBlockSize,
-                           mBlockResultSize,
-                           NULL,
-                           0,
-                           NULL,
-                           0,
-                           mBlockHashResult + Index * mBlockResultSize
-                           );
-          if (ReturnValue) {
-            mBlockIsCompleted[Index] = TRUE;
-          }
-
-          ReleaseSpinLock (&mSpinLockList[Index]);
-          break;
-        }
-
-        ReleaseSpinLock (&mSpinLockList[Index]);
-      } else {
-        AllCompleted = FALSE;
-        break;
-      }
-    }
-  } while (!AllCompleted);
-
   //
   // Fill LeftEncode(n).
   //
-  Offset = EncSizeB + mBlockNum * mBlockResultSize;
+  Offset = EncSizeB + Job.BlockNum * Job.BlockResultSize;
   CopyMem (CombinedInput + Offset, EncBufN, EncSizeN);
 
   //
@@ -237,18 +184,7 @@ ParallelHash256HashAll (
 
 Exit:
   ZeroMem (CombinedInput, CombinedInputSize);
-
-  if (CombinedInput != NULL) {
-    FreePool (CombinedInput);
-  }
-
-  if (mSpinLockList != NULL) {
-    FreePool ((VOID *)mSpinLockList);
-  }
-
-  if (mBlockIsCompleted != NULL) {
-    FreePool (mBlockIsCompleted);
-  }
+  FreePool (CombinedInput);
 
   return ReturnValue;
 }
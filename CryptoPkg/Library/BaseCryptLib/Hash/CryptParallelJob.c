@@ -0,0 +1,129 @@
+/** @file
+  Crypto job service, which runs independent tasks of a workload on all
+  processors.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CryptParallelJob.h"
+#include <Library/SynchronizationLib.h>
+
+//
+// Set while a job is dispatched to the APs. The APs run a single procedure
+// at a time, so a job started meanwhile runs on the calling processor.
+//
+volatile UINT32  mCryptParallelJobBusy = 0;
+
+/**
+  Run the tasks of a crypto job until its queue is empty.
+
+  @param[in]  Job  Pointer to the job.
+
+**/
+STATIC
+VOID
+CryptParallelJobWorker (
+  IN CRYPT_PARALLEL_JOB  *Job
+  )
+{
+  UINT32  TaskIndex;
+
+  while (TRUE) {
+    TaskIndex = InterlockedIncrement (&Job->NextTask) - 1;
+    if (TaskIndex >= Job->TaskCount) {
+      break;
+    }
+
+    if (!Job->Task (Job->Context, TaskIndex)) {
+      Job->Failed = 1;
+    }
+  }
+}
+
+/**
+  Run the tasks of a crypto job until its queue is empty.
+
+  Each AP runs this function for the job dispatched by the BSP.
+
+  @param[in] ProcedureArgument  Pointer to the CRYPT_PARALLEL_JOB.
+**/
+VOID
+EFIAPI
+CryptParallelJobApExecute (
+  IN VOID  *ProcedureArgument
+  )
+{
+  CRYPT_PARALLEL_JOB  *Job;
+
+  Job = (CRYPT_PARALLEL_JOB *)ProcedureArgument;
+  CryptParallelJobWorker (Job);
+
+  //
+  // The job must not be touched after this, as the BSP may return.
+  //
+  InterlockedIncrement (&Job->ApDone);
+}
+
+/**
+  Run the tasks of a crypto job on the BSP and on all the APs.
+
+  The tasks are queued and run by the BSP and the APs until the queue is
+  empty. If the MP services are not available, or if another job is already
+  running (e.g. a task calls this function again), all the tasks run on the
+  calling processor.
+
+  @param[in]  Task        The task function.
+  @param[in]  JobContext  Pointer to the context of the job, passed to each task.
+  @param[in]  TaskCount   Number of tasks in the job.
+
+  @retval TRUE   All the tasks succeeded.
+  @retval FALSE  At least one task failed, or TaskCount is too large.
+
+**/
+BOOLEAN
+EFIAPI
+CryptRunParallelJob (
+  IN CRYPT_PARALLEL_TASK  Task,
+  IN VOID                 *JobContext,
+  IN UINTN                TaskCount
+  )
+{
+  CRYPT_PARALLEL_JOB  Job;
+  BOOLEAN             Dispatched;
+
+  if ((Task == NULL) || (TaskCount > MAX_INT32)) {
+    return FALSE;
+  }
+
+  Job.Task      = Task;
+  Job.Context   = JobContext;
+  Job.TaskCount = (UINT32)TaskCount;
+  Job.NextTask  = 0;
+  Job.Failed    = 0;
+  Job.ApCount   = 0;
+  Job.ApDone    = 0;
+
+  Dispatched = FALSE;
+  if ((TaskCount > 1) && (InterlockedCompareExchange32 (&mCryptParallelJobBusy, 0, 1) == 0)) {
+    Dispatched = DispatchJobToAp (&Job);
+    if (!Dispatched) {
+      mCryptParallelJobBusy = 0;
+    }
+  }
+
+  //
+  // Run the tasks left by the APs, or all of them if the job was not
+  // dispatched, then wait for the APs still running.
+  //
+  CryptParallelJobWorker (&Job);
+  while (Job.ApDone < Job.ApCount) {
+    CpuPause ();
+  }
+
+  if (Dispatched) {
+    mCryptParallelJobBusy = 0;
+  }
+
+  return (BOOLEAN)(Job.Failed == 0);
+}
@@ -0,0 +1,115 @@
+/** @file
+  Internal declarations of the crypto job service, which splits a workload
+  into independent tasks and runs them on all processors.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CRYPT_PARALLEL_JOB_H__
+#define __CRYPT_PARALLEL_JOB_H__
+
+#include "InternalCryptLib.h"
+
+/**
+  Run one task of a crypto job.
+
+  A task must only touch the job context and the part of the input and output
+  buffers that belongs to TaskIndex, as tasks run concurrently on different
+  processors.
+
+  @param[in]  JobContext  Pointer to the context of the job.
+  @param[in]  TaskIndex   Index of the task to run, from 0 to TaskCount - 1.
+
+  @retval TRUE   The task succeeded.
+  @retval FALSE  The task failed.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *CRYPT_PARALLEL_TASK)(
+  IN VOID   *JobContext,
+  IN UINTN  TaskIndex
+  );
+
+//
+// A crypto job. The tasks are taken from the queue in order by each processor
+// running the job, so that each task runs exactly once.
+//
+typedef struct {
+  CRYPT_PARALLEL_TASK    Task;
+  VOID                   *Context;
+  UINT32                 TaskCount;
+  //
+  // Number of tasks taken from the queue, possibly beyond TaskCount.
+  //
+  volatile UINT32        NextTask;
+  //
+  // Set if any task failed.
+  //
+  volatile UINT32        Failed;
+  //
+  // Number of APs started asynchronously on the job, and number of APs that
+  // are done with it. The BSP waits for them before the job goes away.
+  //
+  UINT32                 ApCount;
+  volatile UINT32        ApDone;
+} CRYPT_PARALLEL_JOB;
+
+/**
+  Run the tasks of a crypto job on the BSP and on all the APs.
+
+  The tasks are queued and run by the BSP and the APs until the queue is
+  empty. If the MP services are not available, or if another job is already
+  running (e.g. a task calls this function again), all the tasks run on the
+  calling processor.
+
+  @param[in]  Task        The task function.
+  @param[in]  JobContext  Pointer to the context of the job, passed to each task.
+  @param[in]  TaskCount   Number of tasks in the job.
+
+  @retval TRUE   All the tasks succeeded.
+  @retval FALSE  At least one task failed, or TaskCount is too large.
+
+**/
+BOOLEAN
+EFIAPI
+CryptRunParallelJob (
+  IN CRYPT_PARALLEL_TASK  Task,
+  IN VOID                 *JobContext,
+  IN UINTN                TaskCount
+  );
+
+/**
+  Run the tasks of a crypto job until its queue is empty.
+
+  Each AP runs this function for the job dispatched by the BSP.
+
+  @param[in] ProcedureArgument  Pointer to the CRYPT_PARALLEL_JOB.
+**/
+VOID
+EFIAPI
+CryptParallelJobApExecute (
+  IN VOID  *ProcedureArgument
+  );
+
+/**
+  Dispatch a crypto job to each AP.
+
+  The APs run CryptParallelJobApExecute() with the job as argument. If the
+  APs are started asynchronously, this function sets ApCount to the number of
+  APs started, and the caller waits until as many are done with the job.
+
+  @param[in]  Job  Pointer to the job.
+
+  @retval TRUE   The job was dispatched to the APs.
+  @retval FALSE  The MP services are not available.
+
+**/
+BOOLEAN
+EFIAPI
+DispatchJobToAp (
+  IN CRYPT_PARALLEL_JOB  *Job
+  );
+
+#endif
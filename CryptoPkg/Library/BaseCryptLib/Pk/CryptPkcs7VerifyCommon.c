@@ -24,6 +24,42 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 GLOBAL_REMOVE_IF_UNREFERENCED const UINT8  mOidValue[9] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };
 
+//
+// Number of verified certificate chains remembered by a PKCS#7 verification
+// context.
+//
+#define PKCS7_VERIFY_CHAIN_CACHE_SIZE  16
+
+//
+// PKCS#7 verification context, created by Pkcs7VerifyContextNew().
+//
+typedef struct {
+  //
+  // X509 Store holding the trusted certificate.
+  //
+  X509_STORE    *CertStore;
+  //
+  // Keys of the certificate chains verified up to the trusted certificate,
+  // see Pkcs7GetChainKey(). The oldest key is replaced when the cache is full.
+  //
+  UINTN         ChainCount;
+  UINTN         NextChain;
+  UINT8         ChainKey[PKCS7_VERIFY_CHAIN_CACHE_SIZE][SHA256_DIGEST_SIZE];
+} PKCS7_VERIFY_CONTEXT;
+
+//
+// PKCS#7 streaming verification context, created by Pkcs7VerifyStreamNew().
+//
+typedef struct {
+  PKCS7         *Pkcs7;
+  X509_STORE    *CertStore;
+  //
+  // Chain of digest BIOs, one per digest algorithm of the signed data, ending
+  // in a null sink. The content is written to it piece by piece.
+  //
+  BIO           *DataBio;
+} PKCS7_VERIFY_STREAM;
+
 /**
   Check input P7Data is a wrapped ContentInfo structure or not. If not construct
   a new structure to wrap P7Data.
@@ -748,88 +784,257 @@ _Error:
 }
 
 /**
-  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
-  Cryptographic Message Syntax Standard". The input signed data could be wrapped
-  in a ContentInfo structure.
+  Register the digest algorithms needed for the PKCS#7 verifications of this
+  library.
 
-  If P7Data, TrustedCert or InData is NULL, then return FALSE.
-  If P7Length, CertLength or DataLength overflow, then return FALSE.
+  @retval  TRUE   The digest algorithms are registered.
+  @retval  FALSE  The registration failed.
 
-  Caution: This function may receive untrusted input.
-  UEFI Authenticated Variable is external input, so this function will do basic
-  check for PKCS#7 data structure.
+**/
+STATIC
+BOOLEAN
+Pkcs7AddDigests (
+  VOID
+  )
+{
+  if (EVP_add_digest (EVP_md5 ()) == 0) {
+    return FALSE;
+  }
 
-  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
-  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
-  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
-                           is used for certificate chain verification.
+  if (EVP_add_digest (EVP_sha1 ()) == 0) {
+    return FALSE;
+  }
+
+  if (EVP_add_digest (EVP_sha256 ()) == 0) {
+    return FALSE;
+  }
+
+  if (EVP_add_digest (EVP_sha384 ()) == 0) {
+    return FALSE;
+  }
+
+  if (EVP_add_digest (EVP_sha512 ()) == 0) {
+    return FALSE;
+  }
+
+  if (EVP_add_digest_alias (SN_sha1WithRSAEncryption, SN_sha1WithRSA) == 0) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Create an X509 Store holding a trusted certificate, set up for the PKCS#7
+  verifications of this library.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
   @param[in]  CertLength   Length of the trusted certificate in bytes.
-  @param[in]  InData       Pointer to the content to be verified.
-  @param[in]  DataLength   Length of InData in bytes.
 
-  @retval  TRUE  The specified PKCS#7 signed data is valid.
-  @retval  FALSE Invalid PKCS#7 signed data.
+  @return  The X509 Store, or NULL on failure. It's caller's responsibility to
+           free it with X509_STORE_free().
 
 **/
-BOOLEAN
-EFIAPI
-Pkcs7Verify (
-  IN  CONST UINT8  *P7Data,
-  IN  UINTN        P7Length,
+STATIC
+X509_STORE *
+Pkcs7NewCertStore (
   IN  CONST UINT8  *TrustedCert,
-  IN  UINTN        CertLength,
-  IN  CONST UINT8  *InData,
-  IN  UINTN        DataLength
+  IN  UINTN        CertLength
   )
 {
-  PKCS7        *Pkcs7;
-  BIO          *DataBio;
-  BOOLEAN      Status;
   X509         *Cert;
   X509_STORE   *CertStore;
-  UINT8        *SignedData;
   CONST UINT8  *Temp;
-  UINTN        SignedDataSize;
-  BOOLEAN      Wrapped;
 
   //
-  // Check input parameters.
+  // Read DER-encoded root certificate and Construct X509 Certificate
   //
-  if ((P7Data == NULL) || (TrustedCert == NULL) || (InData == NULL) ||
-      (P7Length > INT_MAX) || (CertLength > INT_MAX) || (DataLength > INT_MAX))
-  {
-    return FALSE;
+  Temp = TrustedCert;
+  Cert = d2i_X509 (NULL, &Temp, (long)CertLength);
+  if (Cert == NULL) {
+    return NULL;
   }
 
-  Pkcs7     = NULL;
-  DataBio   = NULL;
-  Cert      = NULL;
-  CertStore = NULL;
+  //
+  // Setup X509 Store for trusted certificate
+  //
+  CertStore = X509_STORE_new ();
+  if (CertStore == NULL) {
+    X509_free (Cert);
+    return NULL;
+  }
+
+  if (!(X509_STORE_add_cert (CertStore, Cert))) {
+    X509_free (Cert);
+    X509_STORE_free (CertStore);
+    return NULL;
+  }
 
   //
-  // Register & Initialize necessary digest algorithms for PKCS#7 Handling
+  // The store holds its own reference to the certificate.
   //
-  if (EVP_add_digest (EVP_md5 ()) == 0) {
+  X509_free (Cert);
+
+  //
+  // Allow partial certificate chains, terminated by a non-self-signed but
+  // still trusted intermediate certificate. Also disable time checks.
+  //
+  X509_STORE_set_flags (
+    CertStore,
+    X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME
+    );
+
+  //
+  // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
+  // doesn't support the extended key usage for Authenticode Code Signing.
+  // Bypass the certificate purpose checking by enabling any purposes setting.
+  //
+  X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
+
+  return CertStore;
+}
+
+/**
+  Compute the key of the certificate chains of a PKCS#7 signed data in the
+  chain cache of a PKCS#7 verification context.
+
+  The key is the SHA-256 digest of the issuer and serial number of every signer,
+  followed by all the certificates embedded in the signed data. The chain
+  building of the signers only depends on these and on the trusted certificate
+  of the context, since the time checks are disabled.
+
+  @param[in]   Pkcs7     Pointer to the PKCS#7 signed data.
+  @param[out]  ChainKey  Receives the key, SHA256_DIGEST_SIZE bytes.
+
+  @retval  TRUE   The key is computed.
+  @retval  FALSE  The key can't be computed.
+
+**/
+STATIC
+BOOLEAN
+Pkcs7GetChainKey (
+  IN  PKCS7  *Pkcs7,
+  OUT UINT8  *ChainKey
+  )
+{
+  EVP_MD_CTX                      *MdCtx;
+  STACK_OF (PKCS7_SIGNER_INFO)    *SignerInfos;
+  PKCS7_SIGNER_INFO               *SignerInfo;
+  STACK_OF (X509)                 *Certs;
+  UINT8                           *Der;
+  INTN                            DerLength;
+  INTN                            Index;
+  INTN                            Result;
+  BOOLEAN                         Status;
+
+  Status = FALSE;
+
+  MdCtx = EVP_MD_CTX_new ();
+  if (MdCtx == NULL) {
     return FALSE;
   }
 
-  if (EVP_add_digest (EVP_sha1 ()) == 0) {
-    return FALSE;
+  if (EVP_DigestInit_ex (MdCtx, EVP_sha256 (), NULL) != 1) {
+    goto _Exit;
   }
 
-  if (EVP_add_digest (EVP_sha256 ()) == 0) {
-    return FALSE;
+  SignerInfos = PKCS7_get_signer_info (Pkcs7);
+  if ((SignerInfos == NULL) || (sk_PKCS7_SIGNER_INFO_num (SignerInfos) <= 0)) {
+    goto _Exit;
   }
 
-  if (EVP_add_digest (EVP_sha384 ()) == 0) {
-    return FALSE;
+  for (Index = 0; Index < sk_PKCS7_SIGNER_INFO_num (SignerInfos); Index++) {
+    SignerInfo = sk_PKCS7_SIGNER_INFO_value (SignerInfos, (int)Index);
+    Der        = NULL;
+    DerLength  = i2d_PKCS7_ISSUER_AND_SERIAL (SignerInfo->issuer_and_serial, &Der);
+    if (DerLength <= 0) {
+      goto _Exit;
+    }
+
+    Result = EVP_DigestUpdate (MdCtx, Der, (size_t)DerLength);
+    OPENSSL_free (Der);
+    if (Result != 1) {
+      goto _Exit;
+    }
   }
 
-  if (EVP_add_digest (EVP_sha512 ()) == 0) {
-    return FALSE;
+  Certs = Pkcs7->d.sign->cert;
+  for (Index = 0; Index < sk_X509_num (Certs); Index++) {
+    Der       = NULL;
+    DerLength = i2d_X509 (sk_X509_value (Certs, (int)Index), &Der);
+    if (DerLength <= 0) {
+      goto _Exit;
+    }
+
+    Result = EVP_DigestUpdate (MdCtx, Der, (size_t)DerLength);
+    OPENSSL_free (Der);
+    if (Result != 1) {
+      goto _Exit;
+    }
   }
 
-  if (EVP_add_digest_alias (SN_sha1WithRSAEncryption, SN_sha1WithRSA) == 0) {
+  if (EVP_DigestFinal_ex (MdCtx, ChainKey, NULL) != 1) {
+    goto _Exit;
+  }
+
+  Status = TRUE;
+
+_Exit:
+  EVP_MD_CTX_free (MdCtx);
+
+  return Status;
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data against an X509 Store set up by
+  Pkcs7NewCertStore().
+
+  If a PKCS#7 verification context is given, the certificate chains of signed
+  data whose chain key is in its chain cache are not built again, and the chain
+  key of signed data verified successfully is added to the cache.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  CertStore    X509 Store holding the trusted certificate.
+  @param[in]  Context      PKCS#7 verification context, or NULL.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+STATIC
+BOOLEAN
+Pkcs7VerifyWithStore (
+  IN  CONST UINT8           *P7Data,
+  IN  UINTN                 P7Length,
+  IN  X509_STORE            *CertStore,
+  IN  PKCS7_VERIFY_CONTEXT  *Context  OPTIONAL,
+  IN  CONST UINT8           *InData,
+  IN  UINTN                 DataLength
+  )
+{
+  PKCS7        *Pkcs7;
+  BIO          *DataBio;
+  BOOLEAN      Status;
+  UINT8        *SignedData;
+  CONST UINT8  *Temp;
+  UINTN        SignedDataSize;
+  BOOLEAN      Wrapped;
+  UINT8        ChainKey[SHA256_DIGEST_SIZE];
+  BOOLEAN      HasChainKey;
+  BOOLEAN      ChainVerified;
+  UINTN        Index;
+  INTN         Flags;
+
+  Pkcs7   = NULL;
+  DataBio = NULL;
+
+  //
+  // Register & Initialize necessary digest algorithms for PKCS#7 Handling
+  //
+  if (!Pkcs7AddDigests ()) {
     return FALSE;
   }
 
@@ -861,68 +1066,505 @@ Pkcs7Verify (
   }
 
   //
-  // Read DER-encoded root certificate and Construct X509 Certificate
+  // For generic PKCS#7 handling, InData may be NULL if the content is present
+  // in PKCS#7 structure. So ignore NULL checking here.
   //
-  Temp = TrustedCert;
-  Cert = d2i_X509 (NULL, &Temp, (long)CertLength);
-  if (Cert == NULL) {
+  DataBio = BIO_new_mem_buf (InData, (int)DataLength);
+  if (DataBio == NULL) {
     goto _Exit;
   }
 
   //
-  // Setup X509 Store for trusted certificate
+  // Look up the certificate chains of the signers in the chain cache.
   //
-  CertStore = X509_STORE_new ();
-  if (CertStore == NULL) {
-    goto _Exit;
+  HasChainKey   = FALSE;
+  ChainVerified = FALSE;
+  if (Context != NULL) {
+    HasChainKey = Pkcs7GetChainKey (Pkcs7, ChainKey);
+    if (HasChainKey) {
+      for (Index = 0; Index < Context->ChainCount; Index++) {
+        if (CompareMem (Context->ChainKey[Index], ChainKey, SHA256_DIGEST_SIZE) == 0) {
+          ChainVerified = TRUE;
+          break;
+        }
+      }
+    }
   }
 
-  if (!(X509_STORE_add_cert (CertStore, Cert))) {
-    goto _Exit;
+  //
+  // Verifies the PKCS#7 signedData structure. The signatures are always
+  // verified, only the chain building is skipped for chains already verified.
+  //
+  Flags = PKCS7_BINARY;
+  if (ChainVerified) {
+    Flags |= PKCS7_NOVERIFY;
+  }
+
+  Status = (BOOLEAN)PKCS7_verify (Pkcs7, NULL, CertStore, DataBio, NULL, (int)Flags);
+
+  if (Status && HasChainKey && !ChainVerified) {
+    CopyMem (Context->ChainKey[Context->NextChain], ChainKey, SHA256_DIGEST_SIZE);
+    Context->NextChain = (Context->NextChain + 1) % PKCS7_VERIFY_CHAIN_CACHE_SIZE;
+    if (Context->ChainCount < PKCS7_VERIFY_CHAIN_CACHE_SIZE) {
+      Context->ChainCount++;
+    }
   }
 
+_Exit:
   //
-  // For generic PKCS#7 handling, InData may be NULL if the content is present
-  // in PKCS#7 structure. So ignore NULL checking here.
+  // Release Resources
   //
-  DataBio = BIO_new_mem_buf (InData, (int)DataLength);
-  if (DataBio == NULL) {
-    goto _Exit;
+  BIO_free (DataBio);
+  PKCS7_free (Pkcs7);
+
+  if (!Wrapped) {
+    OPENSSL_free (SignedData);
   }
 
+  return Status;
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard". The input signed data could be wrapped
+  in a ContentInfo structure.
+
+  If P7Data, TrustedCert or InData is NULL, then return FALSE.
+  If P7Length, CertLength or DataLength overflow, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7Verify (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  X509_STORE  *CertStore;
+  BOOLEAN     Status;
+
   //
-  // Allow partial certificate chains, terminated by a non-self-signed but
-  // still trusted intermediate certificate. Also disable time checks.
+  // Check input parameters.
   //
-  X509_STORE_set_flags (
-    CertStore,
-    X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME
-    );
+  if ((P7Data == NULL) || (TrustedCert == NULL) || (InData == NULL) ||
+      (P7Length > INT_MAX) || (CertLength > INT_MAX) || (DataLength > INT_MAX))
+  {
+    return FALSE;
+  }
+
+  CertStore = Pkcs7NewCertStore (TrustedCert, CertLength);
+  if (CertStore == NULL) {
+    return FALSE;
+  }
+
+  Status = Pkcs7VerifyWithStore (P7Data, P7Length, CertStore, NULL, InData, DataLength);
+
+  X509_STORE_free (CertStore);
+
+  return Status;
+}
+
+/**
+  Allocates and initializes a PKCS#7 verification context for a trusted/root
+  certificate.
+
+  The context keeps the parsed trusted certificate, so that it is not parsed
+  again for each verification, and the certificate chains already verified up
+  to it, so that PKCS#7 signed data carrying the same signer and intermediate
+  certificates skip the chain building.
+
+  If TrustedCert is NULL, then return NULL.
+  If CertLength overflow, then return NULL.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 verification context that has been initialized.
+           If the allocations fails, Pkcs7VerifyContextNew() returns NULL.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  if ((TrustedCert == NULL) || (CertLength > INT_MAX)) {
+    return NULL;
+  }
+
+  Context = AllocateZeroPool (sizeof (PKCS7_VERIFY_CONTEXT));
+  if (Context == NULL) {
+    return NULL;
+  }
+
+  Context->CertStore = Pkcs7NewCertStore (TrustedCert, CertLength);
+  if (Context->CertStore == NULL) {
+    FreePool (Context);
+    return NULL;
+  }
+
+  return Context;
+}
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID  *Pkcs7VerifyContext
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  if (Pkcs7VerifyContext == NULL) {
+    return;
+  }
+
+  Context = (PKCS7_VERIFY_CONTEXT *)Pkcs7VerifyContext;
+  X509_STORE_free (Context->CertStore);
+  FreePool (Context);
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard", using the trusted certificate of a
+  PKCS#7 verification context. The input signed data could be wrapped in a
+  ContentInfo structure.
+
+  The result is the same as Pkcs7Verify() with the trusted certificate of the
+  context.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]  InData              Pointer to the content to be verified.
+  @param[in]  DataLength          Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
 
   //
-  // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
-  // doesn't support the extended key usage for Authenticode Code Signing.
-  // Bypass the certificate purpose checking by enabling any purposes setting.
+  // Check input parameters.
   //
-  X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
+  if ((Pkcs7VerifyContext == NULL) || (P7Data == NULL) || (InData == NULL) ||
+      (P7Length > INT_MAX) || (DataLength > INT_MAX))
+  {
+    return FALSE;
+  }
+
+  Context = (PKCS7_VERIFY_CONTEXT *)Pkcs7VerifyContext;
+
+  return Pkcs7VerifyWithStore (P7Data, P7Length, Context->CertStore, Context, InData, DataLength);
+}
+
+/**
+  Allocates and initializes a PKCS#7 streaming verification context.
+
+  The content signed by the detached PKCS#7 signed data is then provided in
+  pieces with Pkcs7VerifyStreamUpdate(), so that it doesn't need to be
+  contiguous in memory, and verified with Pkcs7VerifyStreamFinal(). The result
+  is the same as Pkcs7Verify() over the concatenation of the pieces.
+
+  If P7Data or TrustedCert is NULL, then return NULL.
+  If P7Length or CertLength overflow, then return NULL.
+
+  Caution: This function may receive untrusted input.
+  UEFI Authenticated Variable is external input, so this function will do basic
+  check for PKCS#7 data structure.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 streaming verification context that has been
+           initialized. If the PKCS#7 message is not a detached signed data, or
+           an allocation fails, Pkcs7VerifyStreamNew() returns NULL.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyStreamNew (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+  UINT8                *SignedData;
+  CONST UINT8          *Temp;
+  UINTN                SignedDataSize;
+  BOOLEAN              Wrapped;
+  BIO                  *NullBio;
 
   //
-  // Verifies the PKCS#7 signedData structure
+  // Check input parameters.
   //
-  Status = (BOOLEAN)PKCS7_verify (Pkcs7, NULL, CertStore, DataBio, NULL, PKCS7_BINARY);
+  if ((P7Data == NULL) || (TrustedCert == NULL) ||
+      (P7Length > INT_MAX) || (CertLength > INT_MAX))
+  {
+    return NULL;
+  }
+
+  if (!Pkcs7AddDigests ()) {
+    return NULL;
+  }
+
+  if (!WrapPkcs7Data (P7Data, P7Length, &Wrapped, &SignedData, &SignedDataSize)) {
+    return NULL;
+  }
+
+  Stream = AllocateZeroPool (sizeof (PKCS7_VERIFY_STREAM));
+  if (Stream == NULL) {
+    goto _Error;
+  }
 
-_Exit:
   //
-  // Release Resources
+  // Retrieve PKCS#7 Data (DER encoding). The content must be detached, as it
+  // is provided by the caller.
   //
-  BIO_free (DataBio);
-  X509_free (Cert);
-  X509_STORE_free (CertStore);
-  PKCS7_free (Pkcs7);
+  if (SignedDataSize > INT_MAX) {
+    goto _Error;
+  }
+
+  Temp          = SignedData;
+  Stream->Pkcs7 = d2i_PKCS7 (NULL, (const unsigned char **)&Temp, (int)SignedDataSize);
+  if ((Stream->Pkcs7 == NULL) || !PKCS7_type_is_signed (Stream->Pkcs7) ||
+      !PKCS7_get_detached (Stream->Pkcs7))
+  {
+    goto _Error;
+  }
+
+  Stream->CertStore = Pkcs7NewCertStore (TrustedCert, CertLength);
+  if (Stream->CertStore == NULL) {
+    goto _Error;
+  }
+
+  NullBio = BIO_new (BIO_s_null ());
+  if (NullBio == NULL) {
+    goto _Error;
+  }
+
+  Stream->DataBio = PKCS7_dataInit (Stream->Pkcs7, NullBio);
+  if (Stream->DataBio == NULL) {
+    BIO_free (NullBio);
+    goto _Error;
+  }
+
+  if (!Wrapped) {
+    OPENSSL_free (SignedData);
+  }
+
+  return Stream;
+
+_Error:
+  Pkcs7VerifyStreamFree (Stream);
 
   if (!Wrapped) {
     OPENSSL_free (SignedData);
   }
 
+  return NULL;
+}
+
+/**
+  Provides the next piece of the content to a PKCS#7 streaming verification
+  context.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If InData is NULL and DataLength is not 0, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+  @param[in]       InData             Pointer to the piece of content.
+  @param[in]       DataLength         Length of InData in bytes.
+
+  @retval  TRUE   The piece of content is processed.
+  @retval  FALSE  The piece of content can't be processed.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamUpdate (
+  IN OUT  VOID         *Pkcs7VerifyStream,
+  IN      CONST UINT8  *InData,
+  IN      UINTN        DataLength
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+  UINTN                Length;
+
+  if ((Pkcs7VerifyStream == NULL) || ((InData == NULL) && (DataLength != 0))) {
+    return FALSE;
+  }
+
+  Stream = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+
+  while (DataLength > 0) {
+    Length = MIN (DataLength, INT_MAX);
+    if (BIO_write (Stream->DataBio, InData, (int)Length) != (int)Length) {
+      return FALSE;
+    }
+
+    InData     += Length;
+    DataLength -= Length;
+  }
+
+  return TRUE;
+}
+
+/**
+  Verifies the validity of the PKCS#7 signed data of a PKCS#7 streaming
+  verification context over all the content provided so far.
+
+  The certificate chains are verified the same way as PKCS7_verify() does,
+  then the signature of each signer is checked against the digests of the
+  content computed by Pkcs7VerifyStreamUpdate().
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamFinal (
+  IN OUT  VOID  *Pkcs7VerifyStream
+  )
+{
+  PKCS7_VERIFY_STREAM             *Stream;
+  BIO                             *EmptyBio;
+  STACK_OF (X509)                 *Signers;
+  STACK_OF (PKCS7_SIGNER_INFO)    *SignerInfos;
+  INTN                            Index;
+  BOOLEAN                         Status;
+
+  if (Pkcs7VerifyStream == NULL) {
+    return FALSE;
+  }
+
+  Stream  = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+  Signers = NULL;
+  Status  = FALSE;
+
+  //
+  // Verify the certificate chains of the signers. The signatures are skipped
+  // here, as the content was not given to PKCS7_verify().
+  //
+  EmptyBio = BIO_new (BIO_s_mem ());
+  if (EmptyBio == NULL) {
+    return FALSE;
+  }
+
+  if (PKCS7_verify (Stream->Pkcs7, NULL, Stream->CertStore, EmptyBio, NULL, PKCS7_BINARY | PKCS7_NOSIGS) != 1) {
+    goto _Exit;
+  }
+
+  //
+  // Verify the signature of each signer over the streamed content.
+  //
+  Signers     = PKCS7_get0_signers (Stream->Pkcs7, NULL, PKCS7_BINARY);
+  SignerInfos = PKCS7_get_signer_info (Stream->Pkcs7);
+  if ((Signers == NULL) || (SignerInfos == NULL) ||
+      (sk_X509_num (Signers) != sk_PKCS7_SIGNER_INFO_num (SignerInfos)))
+  {
+    goto _Exit;
+  }
+
+  for (Index = 0; Index < sk_PKCS7_SIGNER_INFO_num (SignerInfos); Index++) {
+    if (PKCS7_signatureVerify (
+          Stream->DataBio,
+          Stream->Pkcs7,
+          sk_PKCS7_SIGNER_INFO_value (SignerInfos, (int)Index),
+          sk_X509_value (Signers, (int)Index)
+          ) <= 0)
+    {
+      goto _Exit;
+    }
+  }
+
+  Status = TRUE;
+
+_Exit:
+  sk_X509_free (Signers);
+  BIO_free (EmptyBio);
+
   return Status;
 }
+
+/**
+  Release the specified PKCS#7 streaming verification context.
+
+  @param[in]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyStreamFree (
+  IN  VOID  *Pkcs7VerifyStream
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+
+  if (Pkcs7VerifyStream == NULL) {
+    return;
+  }
+
+  Stream = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+  BIO_free_all (Stream->DataBio);
+  X509_STORE_free (Stream->CertStore);
+  PKCS7_free (Stream->Pkcs7);
+  FreePool (Stream);
+}
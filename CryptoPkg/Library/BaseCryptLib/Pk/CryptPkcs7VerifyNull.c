@@ -133,6 +133,167 @@ Pkcs7Verify (
   return FALSE;
 }
 
+/**
+  Allocates and initializes a PKCS#7 verification context for a trusted/root
+  certificate.
+
+  Return NULL to indicate this interface is not supported.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  This function will do nothing to indicate this interface is not supported.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN  VOID  *Pkcs7VerifyContext
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard", using the trusted certificate of a
+  PKCS#7 verification context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]  InData              Pointer to the content to be verified.
+  @param[in]  DataLength          Length of InData in bytes.
+
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Allocates and initializes a PKCS#7 streaming verification context.
+
+  Return NULL to indicate this interface is not supported.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @retval  NULL  This interface is not supported.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyStreamNew (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Provides the next piece of the content to a PKCS#7 streaming verification
+  context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+  @param[in]       InData             Pointer to the piece of content.
+  @param[in]       DataLength         Length of InData in bytes.
+
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamUpdate (
+  IN OUT  VOID         *Pkcs7VerifyStream,
+  IN      CONST UINT8  *InData,
+  IN      UINTN        DataLength
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Verifies the validity of the PKCS#7 signed data of a PKCS#7 streaming
+  verification context over all the content provided so far.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+
+  @retval  FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamFinal (
+  IN OUT  VOID  *Pkcs7VerifyStream
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
+
+/**
+  Release the specified PKCS#7 streaming verification context.
+
+  This function will do nothing to indicate this interface is not supported.
+
+  @param[in]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyStreamFree (
+  IN  VOID  *Pkcs7VerifyStream
+  )
+{
+  ASSERT (FALSE);
+}
+
 /**
   Extracts the attached content from a PKCS#7 signed data if existed. The input signed
   data could be wrapped in a ContentInfo structure.
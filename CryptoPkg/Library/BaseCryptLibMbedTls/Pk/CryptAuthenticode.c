@@ -19,31 +19,34 @@ GLOBAL_REMOVE_IF_UNREFERENCED const UINT8  mSpcIndirectOidValue[] = {
 
 /**
   Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
-  Authenticode Portable Executable Signature Format".
-
-  Return FALSE to indicate this interface is not supported.
-
-  @param[in]  AuthData     Pointer to the Authenticode Signature retrieved from signed
-                           PE/COFF image to be verified.
-  @param[in]  DataSize     Size of the Authenticode Signature in bytes.
-  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
-                           is used for certificate chain verification.
-  @param[in]  CertSize     Size of the trusted certificate in bytes.
-  @param[in]  ImageHash    Pointer to the original image file hash value. The procedure
-                           for calculating the image hash value is described in Authenticode
-                           specification.
-  @param[in]  HashSize     Size of Image hash value in bytes.
-
-  @retval FALSE  This interface is not supported.
+  Authenticode Portable Executable Signature Format", either with a trusted certificate
+  or with a PKCS#7 verification context.
+
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                  PE/COFF image to be verified.
+  @param[in]  DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]  TrustedCert         Pointer to a trusted/root certificate encoded in DER, which
+                                  is used for certificate chain verification. Ignored if
+                                  Pkcs7VerifyContext is not NULL.
+  @param[in]  CertSize            Size of the trusted certificate in bytes.
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context, or NULL.
+  @param[in]  ImageHash           Pointer to the original image file hash value. The procedure
+                                  for calculating the image hash value is described in Authenticode
+                                  specification.
+  @param[in]  HashSize            Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
 
 **/
+STATIC
 BOOLEAN
-EFIAPI
-AuthenticodeVerify (
+AuthenticodeVerifyInternal (
   IN CONST UINT8  *AuthData,
   IN UINTN        DataSize,
   IN CONST UINT8  *TrustedCert,
   IN UINTN        CertSize,
+  IN VOID         *Pkcs7VerifyContext,
   IN CONST UINT8  *ImageHash,
   IN UINTN        HashSize
   )
@@ -61,17 +64,6 @@ AuthenticodeVerify (
 
   OrigAuthData = AuthData;
 
-  //
-  // Check input parameters.
-  //
-  if ((AuthData == NULL) || (TrustedCert == NULL) || (ImageHash == NULL)) {
-    return FALSE;
-  }
-
-  if ((DataSize > INT_MAX) || (CertSize > INT_MAX) || (HashSize > INT_MAX)) {
-    return FALSE;
-  }
-
   if (DataSize <= HashSize) {
     return FALSE;
   }
@@ -206,9 +198,106 @@ AuthenticodeVerify (
   //
   // Verifies the PKCS#7 Signed Data in PE/COFF Authenticode Signature
   //
-  Status = (BOOLEAN)Pkcs7Verify (OrigAuthData, DataSize, TrustedCert, CertSize, SpcIndirectDataContent, ContentSize);
+  if (Pkcs7VerifyContext != NULL) {
+    Status = Pkcs7VerifyWithContext (Pkcs7VerifyContext, OrigAuthData, DataSize, SpcIndirectDataContent, ContentSize);
+  } else {
+    Status = (BOOLEAN)Pkcs7Verify (OrigAuthData, DataSize, TrustedCert, CertSize, SpcIndirectDataContent, ContentSize);
+  }
 
 _Exit:
 
   return Status;
 }
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format".
+
+  If AuthData is NULL, then return FALSE.
+  If ImageHash is NULL, then return FALSE.
+
+  @param[in]  AuthData     Pointer to the Authenticode Signature retrieved from signed
+                           PE/COFF image to be verified.
+  @param[in]  DataSize     Size of the Authenticode Signature in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertSize     Size of the trusted certificate in bytes.
+  @param[in]  ImageHash    Pointer to the original image file hash value. The procedure
+                           for calculating the image hash value is described in Authenticode
+                           specification.
+  @param[in]  HashSize     Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerify (
+  IN CONST UINT8  *AuthData,
+  IN UINTN        DataSize,
+  IN CONST UINT8  *TrustedCert,
+  IN UINTN        CertSize,
+  IN CONST UINT8  *ImageHash,
+  IN UINTN        HashSize
+  )
+{
+  //
+  // Check input parameters.
+  //
+  if ((AuthData == NULL) || (TrustedCert == NULL) || (ImageHash == NULL)) {
+    return FALSE;
+  }
+
+  if ((DataSize > INT_MAX) || (CertSize > INT_MAX) || (HashSize > INT_MAX)) {
+    return FALSE;
+  }
+
+  return AuthenticodeVerifyInternal (AuthData, DataSize, TrustedCert, CertSize, NULL, ImageHash, HashSize);
+}
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format", using the trusted certificate
+  of a PKCS#7 verification context created by Pkcs7VerifyContextNew().
+
+  If Pkcs7VerifyContext is NULL, then return FALSE.
+  If AuthData is NULL, then return FALSE.
+  If ImageHash is NULL, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                  PE/COFF image to be verified.
+  @param[in]  DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]  ImageHash           Pointer to the original image file hash value. The procedure
+                                  for calculating the image hash value is described in Authenticode
+                                  specification.
+  @param[in]  HashSize            Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN VOID         *Pkcs7VerifyContext,
+  IN CONST UINT8  *AuthData,
+  IN UINTN        DataSize,
+  IN CONST UINT8  *ImageHash,
+  IN UINTN        HashSize
+  )
+{
+  //
+  // Check input parameters.
+  //
+  if ((Pkcs7VerifyContext == NULL) || (AuthData == NULL) || (ImageHash == NULL)) {
+    return FALSE;
+  }
+
+  if ((DataSize > INT_MAX) || (HashSize > INT_MAX)) {
+    return FALSE;
+  }
+
+  return AuthenticodeVerifyInternal (AuthData, DataSize, NULL, 0, Pkcs7VerifyContext, ImageHash, HashSize);
+}
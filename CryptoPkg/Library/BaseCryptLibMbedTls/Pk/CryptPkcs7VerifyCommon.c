@@ -1042,6 +1042,71 @@ WrapPkcs7Data (
   return TRUE;
 }
 
+//
+// PKCS#7 verification context. The trusted certificate is parsed once when
+// the context is created.
+//
+typedef struct {
+  mbedtls_x509_crt    TrustedCrt;
+} PKCS7_VERIFY_CONTEXT;
+
+/**
+  Verifies the validity of a PKCS#7 signed data against a parsed trusted
+  certificate.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCrt   Pointer to the parsed trusted/root certificate.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+STATIC
+BOOLEAN
+Pkcs7VerifyWithCrt (
+  IN CONST UINT8       *P7Data,
+  IN UINTN             P7Length,
+  IN mbedtls_x509_crt  *TrustedCrt,
+  IN CONST UINT8       *InData,
+  IN UINTN             DataLength
+  )
+{
+  BOOLEAN           Status;
+  UINT8             *WrapData;
+  UINTN             WrapDataSize;
+  BOOLEAN           Wrapped;
+  MbedtlsPkcs7      Pkcs7;
+  INT32             Ret;
+  mbedtls_x509_crt  *TempCrt;
+
+  Status = WrapPkcs7Data (P7Data, P7Length, &Wrapped, &WrapData, &WrapDataSize);
+
+  if (!Status) {
+    return FALSE;
+  }
+
+  Status = FALSE;
+  MbedTlsPkcs7Init (&Pkcs7);
+
+  Ret = MbedtlsPkcs7ParseDer (WrapData, (INT32)WrapDataSize, &Pkcs7);
+  if (Ret != 0) {
+    goto Cleanup;
+  }
+
+  Status = MbedTlsPkcs7SignedDataVerify (&Pkcs7, TrustedCrt, InData, (INT32)DataLength);
+
+Cleanup:
+  if (Pkcs7.SignedData.Certificates.next != NULL) {
+    TempCrt = Pkcs7.SignedData.Certificates.next;
+    mbedtls_x509_crt_free (TempCrt);
+  }
+
+  return Status;
+}
+
 /**
   Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
   Cryptographic Message Syntax Standard". The input signed data could be wrapped
@@ -1076,13 +1141,8 @@ Pkcs7Verify (
   )
 {
   BOOLEAN           Status;
-  UINT8             *WrapData;
-  UINTN             WrapDataSize;
-  BOOLEAN           Wrapped;
-  MbedtlsPkcs7      Pkcs7;
   INT32             Ret;
   mbedtls_x509_crt  Crt;
-  mbedtls_x509_crt  *TempCrt;
 
   //
   // Check input parameters.
@@ -1093,39 +1153,321 @@ Pkcs7Verify (
     return FALSE;
   }
 
-  Status = WrapPkcs7Data (P7Data, P7Length, &Wrapped, &WrapData, &WrapDataSize);
+  mbedtls_x509_crt_init (&Crt);
 
-  if (!Status) {
+  Status = FALSE;
+  Ret    = mbedtls_x509_crt_parse_der (&Crt, TrustedCert, CertLength);
+  if (Ret == 0) {
+    Status = Pkcs7VerifyWithCrt (P7Data, P7Length, &Crt, InData, DataLength);
+  }
+
+  mbedtls_x509_crt_free (&Crt);
+
+  return Status;
+}
+
+/**
+  Creates a PKCS#7 verification context for a trusted certificate.
+
+  The trusted certificate is parsed once, and reused by each verification
+  done with Pkcs7VerifyWithContext().
+
+  If TrustedCert is NULL, then return NULL.
+  If this interface is not supported, then return NULL.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 verification context, or NULL on failure.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyContextNew (
+  IN CONST UINT8  *TrustedCert,
+  IN UINTN        CertLength
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  if ((TrustedCert == NULL) || (CertLength > INT_MAX)) {
+    return NULL;
+  }
+
+  Context = AllocateZeroPool (sizeof (PKCS7_VERIFY_CONTEXT));
+  if (Context == NULL) {
+    return NULL;
+  }
+
+  mbedtls_x509_crt_init (&Context->TrustedCrt);
+  if (mbedtls_x509_crt_parse_der (&Context->TrustedCrt, TrustedCert, CertLength) != 0) {
+    Pkcs7VerifyContextFree (Context);
+    return NULL;
+  }
+
+  return Context;
+}
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyContextFree (
+  IN VOID  *Pkcs7VerifyContext
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  if (Pkcs7VerifyContext == NULL) {
+    return;
+  }
+
+  Context = (PKCS7_VERIFY_CONTEXT *)Pkcs7VerifyContext;
+  mbedtls_x509_crt_free (&Context->TrustedCrt);
+  FreePool (Context);
+}
+
+/**
+  Verifies the validity of a PKCS#7 signed data with the trusted certificate
+  of a PKCS#7 verification context. The input signed data could be wrapped
+  in a ContentInfo structure.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]  InData              Pointer to the content to be verified.
+  @param[in]  DataLength          Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyWithContext (
+  IN VOID         *Pkcs7VerifyContext,
+  IN CONST UINT8  *P7Data,
+  IN UINTN        P7Length,
+  IN CONST UINT8  *InData,
+  IN UINTN        DataLength
+  )
+{
+  PKCS7_VERIFY_CONTEXT  *Context;
+
+  if ((Pkcs7VerifyContext == NULL) || (P7Data == NULL) || (InData == NULL) ||
+      (P7Length > INT_MAX) || (DataLength > INT_MAX))
+  {
     return FALSE;
   }
 
-  Status = FALSE;
-  MbedTlsPkcs7Init (&Pkcs7);
-  mbedtls_x509_crt_init (&Crt);
+  Context = (PKCS7_VERIFY_CONTEXT *)Pkcs7VerifyContext;
 
-  Ret = MbedtlsPkcs7ParseDer (WrapData, (INT32)WrapDataSize, &Pkcs7);
-  if (Ret != 0) {
-    goto Cleanup;
+  return Pkcs7VerifyWithCrt (P7Data, P7Length, &Context->TrustedCrt, InData, DataLength);
+}
+
+//
+// PKCS#7 streaming verification context. mbedtls verifies the signers over
+// a contiguous content, so the pieces of content are gathered in a buffer.
+//
+#define PKCS7_VERIFY_STREAM_INITIAL_SIZE  SIZE_4KB
+
+typedef struct {
+  mbedtls_x509_crt    TrustedCrt;
+  UINT8               *P7Data;
+  UINTN               P7Length;
+  UINT8               *Data;
+  UINTN               DataLength;
+  UINTN               DataSize;
+} PKCS7_VERIFY_STREAM;
+
+/**
+  Allocates and initializes a PKCS#7 streaming verification context.
+
+  If P7Data or TrustedCert is NULL, then return NULL.
+  If P7Length or CertLength overflow, then return NULL.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 streaming verification context, or NULL on failure.
+
+**/
+VOID *
+EFIAPI
+Pkcs7VerifyStreamNew (
+  IN CONST UINT8  *P7Data,
+  IN UINTN        P7Length,
+  IN CONST UINT8  *TrustedCert,
+  IN UINTN        CertLength
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+
+  if ((P7Data == NULL) || (TrustedCert == NULL) ||
+      (P7Length > INT_MAX) || (CertLength > INT_MAX))
+  {
+    return NULL;
   }
 
-  Ret = mbedtls_x509_crt_parse_der (&Crt, TrustedCert, CertLength);
-  if (Ret != 0) {
-    goto Cleanup;
+  Stream = AllocateZeroPool (sizeof (PKCS7_VERIFY_STREAM));
+  if (Stream == NULL) {
+    return NULL;
   }
 
-  Status = MbedTlsPkcs7SignedDataVerify (&Pkcs7, &Crt, InData, (INT32)DataLength);
+  mbedtls_x509_crt_init (&Stream->TrustedCrt);
+  if (mbedtls_x509_crt_parse_der (&Stream->TrustedCrt, TrustedCert, CertLength) != 0) {
+    goto _Error;
+  }
 
-Cleanup:
-  if (&Crt != NULL) {
-    mbedtls_x509_crt_free (&Crt);
+  Stream->P7Data   = AllocateCopyPool (P7Length, P7Data);
+  Stream->P7Length = P7Length;
+  Stream->Data     = AllocatePool (PKCS7_VERIFY_STREAM_INITIAL_SIZE);
+  Stream->DataSize = PKCS7_VERIFY_STREAM_INITIAL_SIZE;
+  if ((Stream->P7Data == NULL) || (Stream->Data == NULL)) {
+    goto _Error;
   }
 
-  if (Pkcs7.SignedData.Certificates.next != NULL) {
-    TempCrt = Pkcs7.SignedData.Certificates.next;
-    mbedtls_x509_crt_free (TempCrt);
+  return Stream;
+
+_Error:
+  Pkcs7VerifyStreamFree (Stream);
+  return NULL;
+}
+
+/**
+  Provides the next piece of the content to a PKCS#7 streaming verification
+  context.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If InData is NULL and DataLength is not 0, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+  @param[in]       InData             Pointer to the piece of content.
+  @param[in]       DataLength         Length of InData in bytes.
+
+  @retval  TRUE   The piece of content is processed.
+  @retval  FALSE  The piece of content can't be processed.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamUpdate (
+  IN OUT VOID         *Pkcs7VerifyStream,
+  IN     CONST UINT8  *InData,
+  IN     UINTN        DataLength
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+  UINTN                NewSize;
+  UINT8                *NewData;
+
+  if ((Pkcs7VerifyStream == NULL) || ((InData == NULL) && (DataLength != 0))) {
+    return FALSE;
   }
 
-  return Status;
+  Stream = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+  if (DataLength > INT_MAX - Stream->DataLength) {
+    return FALSE;
+  }
+
+  if (Stream->DataLength + DataLength > Stream->DataSize) {
+    NewSize = Stream->DataSize;
+    while (NewSize < Stream->DataLength + DataLength) {
+      NewSize *= 2;
+    }
+
+    NewData = ReallocatePool (Stream->DataSize, NewSize, Stream->Data);
+    if (NewData == NULL) {
+      return FALSE;
+    }
+
+    Stream->Data     = NewData;
+    Stream->DataSize = NewSize;
+  }
+
+  CopyMem (Stream->Data + Stream->DataLength, InData, DataLength);
+  Stream->DataLength += DataLength;
+
+  return TRUE;
+}
+
+/**
+  Verifies the validity of the PKCS#7 signed data of a PKCS#7 streaming
+  verification context over all the content provided so far.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7VerifyStreamFinal (
+  IN OUT VOID  *Pkcs7VerifyStream
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+
+  if (Pkcs7VerifyStream == NULL) {
+    return FALSE;
+  }
+
+  Stream = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+
+  return Pkcs7VerifyWithCrt (
+           Stream->P7Data,
+           Stream->P7Length,
+           &Stream->TrustedCrt,
+           Stream->Data,
+           Stream->DataLength
+           );
+}
+
+/**
+  Release the specified PKCS#7 streaming verification context.
+
+  @param[in]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context to be released.
+
+**/
+VOID
+EFIAPI
+Pkcs7VerifyStreamFree (
+  IN VOID  *Pkcs7VerifyStream
+  )
+{
+  PKCS7_VERIFY_STREAM  *Stream;
+
+  if (Pkcs7VerifyStream == NULL) {
+    return;
+  }
+
+  Stream = (PKCS7_VERIFY_STREAM *)Pkcs7VerifyStream;
+  mbedtls_x509_crt_free (&Stream->TrustedCrt);
+  if (Stream->P7Data != NULL) {
+    FreePool (Stream->P7Data);
+  }
+
+  if (Stream->Data != NULL) {
+    FreePool (Stream->Data);
+  }
+
+  FreePool (Stream);
 }
 
 /**
@@ -43,3 +43,36 @@ AuthenticodeVerify (
   ASSERT (FALSE);
   return FALSE;
 }
+
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format", using the trusted certificate
+  of a PKCS#7 verification context.
+
+  Return FALSE to indicate this interface is not supported.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                  PE/COFF image to be verified.
+  @param[in]  DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]  ImageHash           Pointer to the original image file hash value. The procedure
+                                  for calculating the image hash value is described in Authenticode
+                                  specification.
+  @param[in]  HashSize            Size of Image hash value in bytes.
+
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+AuthenticodeVerifyWithContext (
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
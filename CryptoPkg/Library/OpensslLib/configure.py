@@ -352,6 +352,7 @@ def main():
             inf = 'OpensslLibAccel.inf'
             hdr = 'configuration-noec.h'
         sources = {}
+        crypto_sources = {}
         defines = {}
         for asm in [ 'UEFI-IA32-MSFT', 'UEFI-IA32-GCC',
                      'UEFI-X64-MSFT', 'UEFI-X64-GCC',
@@ -366,10 +367,14 @@ def main():
                         os.path.join(opensslgendir, 'include', 'openssl', hdr))
             openssl_run_make(openssldir, 'distclean')
 
-            srclist = libcrypto_sources(cfg, archcc) + libssl_sources(cfg, archcc)
+            cryptolist = libcrypto_sources(cfg, archcc)
+            srclist = cryptolist + libssl_sources(cfg, archcc)
             sources[archcc] = list(map(lambda x: f'{x} | {cc}', filter(is_asm, srclist)))
             update_MSFT_asm_format(archcc, sources[archcc])
             sources[arch] = list(filter(lambda x: not is_asm(x), srclist))
+            crypto_sources[archcc] = list(map(lambda x: f'{x} | {cc}', filter(is_asm, cryptolist)))
+            update_MSFT_asm_format(archcc, crypto_sources[archcc])
+            crypto_sources[arch] = list(filter(lambda x: not is_asm(x), cryptolist))
             defines[arch] = cfg['unified_info']['defines']['libcrypto']
             defines[arch] = list(filter(asm_filter_fn, defines[arch]))
 
@@ -380,6 +385,16 @@ def main():
         aarch64accel = sources['AARCH64'] + sources['AARCH64-GCC']
         update_inf(inf, aarch64accel, 'AARCH64', defines['AARCH64'])
 
+        if not ec:
+            # libcrypto only, for modules (typically PEI) without TLS
+            inf = 'OpensslLibCryptoAccel.inf'
+            update_inf(inf, crypto_sources['IA32'] + crypto_sources['IA32-MSFT'] + crypto_sources['IA32-GCC'],
+                       'IA32', defines['IA32'])
+            update_inf(inf, crypto_sources['X64'] + crypto_sources['X64-MSFT'] + crypto_sources['X64-GCC'],
+                       'X64', defines['X64'])
+            update_inf(inf, crypto_sources['AARCH64'] + crypto_sources['AARCH64-GCC'],
+                       'AARCH64', defines['AARCH64'])
+
     # noaccel - ec enabled
     openssl_configure(openssldir, 'UEFI', ec = True);
     cfg = get_configdata(openssldir)
@@ -1589,3 +1589,149 @@ TlsGetExportKey (
            ) == 1 ?
          EFI_SUCCESS : EFI_PROTOCOL_ERROR;
 }
+
+/**
+  Gets the serialized session of the specified TLS connection.
+
+  This function returns the DER encoding of the current session, which can
+  later be handed to TlsSetResumeSession() on a new TLS object to resume the
+  session with the same peer. Only sessions that the TLS library considers
+  resumable are returned.
+
+  If DataSize is too small to hold the session, EFI_BUFFER_TOO_SMALL is
+  returned and DataSize is updated with the required size.
+
+  @param[in]      Tls         Pointer to the TLS object.
+  @param[out]     Data        Buffer to receive the session data. May be NULL
+                              if *DataSize is 0.
+  @param[in,out]  DataSize    The size of Data buffer in bytes.
+
+  @retval  EFI_SUCCESS             The session data was returned successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_NOT_FOUND           No resumable session is available.
+  @retval  EFI_BUFFER_TOO_SMALL    The Data is too small to hold the data.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetResumeSession (
+  IN     VOID   *Tls,
+  OUT    VOID   *Data  OPTIONAL,
+  IN OUT UINTN  *DataSize
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+  INTN            Length;
+  UINT8           *Buffer;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (DataSize == NULL) ||
+      ((Data == NULL) && (*DataSize != 0)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Session = SSL_get_session (TlsConn->Ssl);
+  if ((Session == NULL) || (SSL_SESSION_is_resumable (Session) != 1)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Length = i2d_SSL_SESSION (Session, NULL);
+  if (Length <= 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < (UINTN)Length) {
+    *DataSize = (UINTN)Length;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Buffer    = (UINT8 *)Data;
+  *DataSize = (UINTN)i2d_SSL_SESSION (Session, &Buffer);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Sets a serialized session to be resumed by the specified TLS connection.
+
+  This function imports session data previously returned by
+  TlsGetResumeSession() so that the next handshake on this TLS object offers
+  the session for resumption. It must be called before the handshake starts.
+  If the server declines the session, a full handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the session data.
+  @param[in]  DataSize        The size of session data in bytes.
+
+  @retval  EFI_SUCCESS             The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_ABORTED             The session data could not be decoded.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetResumeSession (
+  IN     VOID        *Tls,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+  CONST UINT8     *Buffer;
+  EFI_STATUS      Status;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Data == NULL) ||
+      (DataSize == 0) || (DataSize > INT_MAX))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Buffer  = (CONST UINT8 *)Data;
+  Session = d2i_SSL_SESSION (NULL, &Buffer, (long)DataSize);
+  if (Session == NULL) {
+    return EFI_ABORTED;
+  }
+
+  //
+  // SSL_set_session() takes its own reference on the session.
+  //
+  Status = EFI_SUCCESS;
+  if (SSL_set_session (TlsConn->Ssl, Session) != 1) {
+    Status = EFI_ABORTED;
+  }
+
+  SSL_SESSION_free (Session);
+  return Status;
+}
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE      The session was resumed (abbreviated handshake).
+  @retval  FALSE     A full handshake was done, or the TLS object is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsGetSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(SSL_session_reused (TlsConn->Ssl) == 1);
+}
@@ -736,3 +736,88 @@ TlsGetExportKey (
   ASSERT (FALSE);
   return EFI_UNSUPPORTED;
 }
+
+/**
+  Gets the serialized session of the specified TLS connection.
+
+  This function returns the DER encoding of the current session, which can
+  later be handed to TlsSetResumeSession() on a new TLS object to resume the
+  session with the same peer. Only sessions that the TLS library considers
+  resumable are returned.
+
+  If DataSize is too small to hold the session, EFI_BUFFER_TOO_SMALL is
+  returned and DataSize is updated with the required size.
+
+  @param[in]      Tls         Pointer to the TLS object.
+  @param[out]     Data        Buffer to receive the session data. May be NULL
+                              if *DataSize is 0.
+  @param[in,out]  DataSize    The size of Data buffer in bytes.
+
+  @retval  EFI_SUCCESS             The session data was returned successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_NOT_FOUND           No resumable session is available.
+  @retval  EFI_BUFFER_TOO_SMALL    The Data is too small to hold the data.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetResumeSession (
+  IN     VOID   *Tls,
+  OUT    VOID   *Data  OPTIONAL,
+  IN OUT UINTN  *DataSize
+  )
+{
+  ASSERT (FALSE);
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Sets a serialized session to be resumed by the specified TLS connection.
+
+  This function imports session data previously returned by
+  TlsGetResumeSession() so that the next handshake on this TLS object offers
+  the session for resumption. It must be called before the handshake starts.
+  If the server declines the session, a full handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the session data.
+  @param[in]  DataSize        The size of session data in bytes.
+
+  @retval  EFI_SUCCESS             The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_ABORTED             The session data could not be decoded.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetResumeSession (
+  IN     VOID        *Tls,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  ASSERT (FALSE);
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE      The session was resumed (abbreviated handshake).
+  @retval  FALSE     A full handshake was done, or the TLS object is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsGetSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
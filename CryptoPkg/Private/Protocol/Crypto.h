@@ -21,7 +21,7 @@
 /// the EDK II Crypto Protocol is extended, this version define must be
 /// increased.
 ///
-#define EDKII_CRYPTO_VERSION  17
+#define EDKII_CRYPTO_VERSION  20
 
 ///
 /// EDK II Crypto Protocol forward declaration
@@ -871,6 +871,175 @@ BOOLEAN
   IN  UINTN                          DataLength
   );
 
+/**
+  Allocates and initializes a PKCS#7 verification context for a trusted/root
+  certificate.
+
+  The context keeps the parsed trusted certificate, so that it is not parsed
+  again for each verification. An implementation may also keep the certificate
+  chains already verified up to it, so that PKCS#7 signed data carrying the
+  same signer and intermediate certificates skip the chain building.
+
+  If TrustedCert is NULL, then return NULL.
+  If CertLength overflow, then return NULL.
+  If this interface is not supported, then return NULL.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 verification context that has been initialized.
+           If the allocations fails, Pkcs7VerifyContextNew() returns NULL.
+  @retval  NULL  This interface is not supported.
+
+**/
+typedef
+VOID *
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_CONTEXT_NEW)(
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
+/**
+  Release the specified PKCS#7 verification context.
+
+  If this interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context to be released.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_CONTEXT_FREE)(
+  IN  VOID  *Pkcs7VerifyContext
+  );
+
+/**
+  Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
+  Cryptographic Message Syntax Standard", using the trusted certificate of a
+  PKCS#7 verification context. The input signed data could be wrapped in a
+  ContentInfo structure.
+
+  The result is the same as Pkcs7Verify() with the trusted certificate of the
+  context.
+
+  If Pkcs7VerifyContext, P7Data or InData is NULL, then return FALSE.
+  If P7Length or DataLength overflow, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length            Length of the PKCS#7 message in bytes.
+  @param[in]  InData              Pointer to the content to be verified.
+  @param[in]  DataLength          Length of InData in bytes.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_WITH_CONTEXT)(
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  );
+
+/**
+  Allocates and initializes a PKCS#7 streaming verification context.
+
+  The content signed by the detached PKCS#7 signed data is then provided in
+  pieces with Pkcs7VerifyStreamUpdate(), so that it doesn't need to be
+  contiguous in memory, and verified with Pkcs7VerifyStreamFinal(). The result
+  is the same as Pkcs7Verify() over the concatenation of the pieces.
+
+  If P7Data or TrustedCert is NULL, then return NULL.
+  If P7Length or CertLength overflow, then return NULL.
+  If this interface is not supported, then return NULL.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER, which
+                           is used for certificate chain verification.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the PKCS#7 streaming verification context that has been
+           initialized. If the PKCS#7 message is not a detached signed data, or
+           an allocation fails, Pkcs7VerifyStreamNew() returns NULL.
+  @retval  NULL  This interface is not supported.
+
+**/
+typedef
+VOID *
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_STREAM_NEW)(
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
+/**
+  Provides the next piece of the content to a PKCS#7 streaming verification
+  context.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If InData is NULL and DataLength is not 0, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+  @param[in]       InData             Pointer to the piece of content.
+  @param[in]       DataLength         Length of InData in bytes.
+
+  @retval  TRUE   The piece of content is processed.
+  @retval  FALSE  The piece of content can't be processed.
+  @retval  FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_STREAM_UPDATE)(
+  IN OUT  VOID         *Pkcs7VerifyStream,
+  IN      CONST UINT8  *InData,
+  IN      UINTN        DataLength
+  );
+
+/**
+  Verifies the validity of the PKCS#7 signed data of a PKCS#7 streaming
+  verification context over all the content provided so far.
+
+  If Pkcs7VerifyStream is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in, out]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context.
+
+  @retval  TRUE  The specified PKCS#7 signed data is valid.
+  @retval  FALSE Invalid PKCS#7 signed data.
+  @retval  FALSE This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_STREAM_FINAL)(
+  IN OUT  VOID  *Pkcs7VerifyStream
+  );
+
+/**
+  Release the specified PKCS#7 streaming verification context.
+
+  If this interface is not supported, then ASSERT().
+
+  @param[in]  Pkcs7VerifyStream  Pointer to the PKCS#7 streaming verification context to be released.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_CRYPTO_PKCS7_VERIFY_STREAM_FREE)(
+  IN  VOID  *Pkcs7VerifyStream
+  );
+
 /**
   VerifyEKUsInPkcs7Signature()
 
@@ -1110,6 +1279,40 @@ BOOLEAN
   IN  UINTN        HashSize
   );
 
+/**
+  Verifies the validity of a PE/COFF Authenticode Signature as described in "Windows
+  Authenticode Portable Executable Signature Format", using the trusted certificate
+  of a PKCS#7 verification context created by Pkcs7VerifyContextNew().
+
+  If Pkcs7VerifyContext is NULL, then return FALSE.
+  If AuthData is NULL, then return FALSE.
+  If ImageHash is NULL, then return FALSE.
+  If this interface is not supported, then return FALSE.
+
+  @param[in]  Pkcs7VerifyContext  Pointer to the PKCS#7 verification context.
+  @param[in]  AuthData            Pointer to the Authenticode Signature retrieved from signed
+                                  PE/COFF image to be verified.
+  @param[in]  DataSize            Size of the Authenticode Signature in bytes.
+  @param[in]  ImageHash           Pointer to the original image file hash value. The procedure
+                                  for calculating the image hash value is described in Authenticode
+                                  specification.
+  @param[in]  HashSize            Size of Image hash value in bytes.
+
+  @retval  TRUE   The specified Authenticode Signature is valid.
+  @retval  FALSE  Invalid Authenticode Signature.
+  @retval  FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_AUTHENTICODE_VERIFY_WITH_CONTEXT)(
+  IN  VOID         *Pkcs7VerifyContext,
+  IN  CONST UINT8  *AuthData,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *ImageHash,
+  IN  UINTN        HashSize
+  );
+
 /**
   Verifies the validity of a RFC3161 Timestamp CounterSignature embedded in PE/COFF Authenticode
   signature.
@@ -4281,6 +4484,79 @@ EFI_STATUS
   IN     UINTN                    KeyBufferLen
   );
 
+/**
+  Gets the serialized session of the specified TLS connection.
+
+  This function returns the DER encoding of the current session, which can
+  later be handed to TlsSetResumeSession() on a new TLS object to resume the
+  session with the same peer. Only sessions that the TLS library considers
+  resumable are returned.
+
+  If DataSize is too small to hold the session, EFI_BUFFER_TOO_SMALL is
+  returned and DataSize is updated with the required size.
+
+  @param[in]      Tls         Pointer to the TLS object.
+  @param[out]     Data        Buffer to receive the session data. May be NULL
+                              if *DataSize is 0.
+  @param[in,out]  DataSize    The size of Data buffer in bytes.
+
+  @retval  EFI_SUCCESS             The session data was returned successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_NOT_FOUND           No resumable session is available.
+  @retval  EFI_BUFFER_TOO_SMALL    The Data is too small to hold the data.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_GET_RESUME_SESSION)(
+  IN     VOID   *Tls,
+  OUT    VOID   *Data  OPTIONAL,
+  IN OUT UINTN  *DataSize
+  );
+
+/**
+  Sets a serialized session to be resumed by the specified TLS connection.
+
+  This function imports session data previously returned by
+  TlsGetResumeSession() so that the next handshake on this TLS object offers
+  the session for resumption. It must be called before the handshake starts.
+  If the server declines the session, a full handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the session data.
+  @param[in]  DataSize        The size of session data in bytes.
+
+  @retval  EFI_SUCCESS             The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER   The parameter is invalid.
+  @retval  EFI_ABORTED             The session data could not be decoded.
+  @retval  EFI_UNSUPPORTED         This function is not supported.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_SET_RESUME_SESSION)(
+  IN     VOID        *Tls,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  );
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  previous session.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE      The session was resumed (abbreviated handshake).
+  @retval  FALSE     A full handshake was done, or the TLS object is invalid.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_TLS_GET_SESSION_REUSED)(
+  IN     VOID  *Tls
+  );
+
 /**
   Gets the CA-supplied certificate revocation list data set in the specified
   TLS object.
@@ -5710,6 +5986,19 @@ struct _EDKII_CRYPTO_PROTOCOL {
   EDKII_CRYPTO_PKCS1V2_DECRYPT                        Pkcs1v2Decrypt;
   EDKII_CRYPTO_RSA_OAEP_ENCRYPT                       RsaOaepEncrypt;
   EDKII_CRYPTO_RSA_OAEP_DECRYPT                       RsaOaepDecrypt;
+  /// TLS Get/Set (continued)
+  EDKII_CRYPTO_TLS_GET_RESUME_SESSION                 TlsGetResumeSession;
+  EDKII_CRYPTO_TLS_SET_RESUME_SESSION                 TlsSetResumeSession;
+  EDKII_CRYPTO_TLS_GET_SESSION_REUSED                 TlsGetSessionReused;
+  /// PKCS (continued)
+  EDKII_CRYPTO_PKCS7_VERIFY_CONTEXT_NEW               Pkcs7VerifyContextNew;
+  EDKII_CRYPTO_PKCS7_VERIFY_CONTEXT_FREE              Pkcs7VerifyContextFree;
+  EDKII_CRYPTO_PKCS7_VERIFY_WITH_CONTEXT              Pkcs7VerifyWithContext;
+  EDKII_CRYPTO_AUTHENTICODE_VERIFY_WITH_CONTEXT       AuthenticodeVerifyWithContext;
+  EDKII_CRYPTO_PKCS7_VERIFY_STREAM_NEW                Pkcs7VerifyStreamNew;
+  EDKII_CRYPTO_PKCS7_VERIFY_STREAM_UPDATE             Pkcs7VerifyStreamUpdate;
+  EDKII_CRYPTO_PKCS7_VERIFY_STREAM_FINAL              Pkcs7VerifyStreamFinal;
+  EDKII_CRYPTO_PKCS7_VERIFY_STREAM_FREE               Pkcs7VerifyStreamFree;
 };
 
 extern GUID  gEdkiiCryptoProtocolGuid;
@@ -732,6 +732,8 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINT8  AuthenticodeWithSha256[] = {
   0x89, 0x0f, 0xdb, 0x47, 0x7a, 0x00, 0x00, 0x00, 0x0a
 };
 
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  AuthenticodeWithSha256Size = sizeof (AuthenticodeWithSha256);
+
 //
 // Sample root certificate for code signing.
 // A trusted certificate with self-signing, will be used to construct the certificate chains for
@@ -930,6 +932,8 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINT8  TestRootCert2[] = {
   0xe2, 0x0a
 };
 
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  TestRootCert2Size = sizeof (TestRootCert2);
+
 //
 // OID ASN.1 Value for Hash Algorithms
 //
@@ -0,0 +1,785 @@
+/** @file
+  Host-based performance benchmark of BaseCryptLib.
+
+  The benchmark is built once per crypto backend. Each operation is repeated
+  until it has run for at least BENCHMARK_MIN_TIME_NS, and one CSV record is
+  printed for each result:
+
+    backend,benchmark,size,status,iterations,ns_per_op,mb_per_s
+
+  The size is the number of bytes processed by one operation, or 0 for the
+  operations whose cost does not depend on the data size. The status is "ok",
+  "failed" if the operation returned FALSE, or "unsupported" if the backend
+  does not provide the operation.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "TestBaseCryptLib.h"
+
+#if defined (BENCHMARK_BACKEND_MBEDTLS)
+#define BENCHMARK_BACKEND  "BaseCryptLibMbedTls"
+#elif defined (BENCHMARK_BACKEND_OPENSSL_ACCEL)
+#define BENCHMARK_BACKEND  "OpensslLibAccel"
+#else
+#define BENCHMARK_BACKEND  "OpensslLib"
+#endif
+
+#define BENCHMARK_MIN_TIME_NS  200000000ULL
+
+//
+// Chunk size used by HashLibBaseCryptoRouter to hash all the PCR banks.
+//
+#define BENCHMARK_HASH_CHUNK_SIZE  SIZE_32KB
+
+VOID
+EFIAPI
+ProcessLibraryConstructorList (
+  VOID
+  );
+
+typedef
+BOOLEAN
+(*BENCHMARK_OPERATION)(
+  IN VOID  *Context
+  );
+
+typedef struct {
+  UINT8    *Data;
+  UINTN    DataSize;
+  UINT8    *Output;
+  VOID     *Sha256Context;
+  VOID     *Sha384Context;
+  VOID     *Sha512Context;
+} BENCHMARK_BUFFER;
+
+typedef struct {
+  VOID     *Key;
+  UINT8    Hash[SHA256_DIGEST_SIZE];
+  UINT8    *Signature;
+  UINTN    SignatureSize;
+} BENCHMARK_SIGNATURE;
+
+typedef struct {
+  UINT8          *P7Data;
+  UINTN          P7Length;
+  CONST UINT8    *TrustedCert;
+  UINTN          CertLength;
+  VOID           *VerifyContext;
+  UINT8          *Data;
+  UINTN          DataSize;
+} BENCHMARK_PKCS7;
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  mBenchmarkKey[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  mBenchmarkIv[12] = {
+  0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88,
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINTN  mBenchmarkDataSizes[] = {
+  64,
+  SIZE_1KB,
+  SIZE_16KB,
+  SIZE_1MB,
+};
+
+/**
+  Get the current time in nanoseconds.
+
+  @return  The current time in nanoseconds.
+
+**/
+STATIC
+UINT64
+BenchmarkGetTime (
+  VOID
+  )
+{
+  struct timespec  Time;
+
+  timespec_get (&Time, TIME_UTC);
+  return (UINT64)Time.tv_sec * 1000000000ULL + (UINT64)Time.tv_nsec;
+}
+
+/**
+  Print the CSV record of a benchmark that did not run.
+
+  @param[in]  Name    Name of the benchmark.
+  @param[in]  Size    Number of bytes processed by one operation.
+  @param[in]  Status  Why the benchmark did not run.
+
+**/
+STATIC
+VOID
+BenchmarkSkip (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Size,
+  IN CONST CHAR8  *Status
+  )
+{
+  printf ("%s,%s,%llu,%s,0,0,0\n", BENCHMARK_BACKEND, Name, (unsigned long long)Size, Status);
+}
+
+/**
+  Run an operation until it has run for at least BENCHMARK_MIN_TIME_NS, and
+  print its CSV record.
+
+  @param[in]  Name       Name of the benchmark.
+  @param[in]  Size       Number of bytes processed by one operation.
+  @param[in]  Operation  The operation to measure.
+  @param[in]  Context    Context passed to the operation.
+
+**/
+STATIC
+VOID
+BenchmarkRun (
+  IN CONST CHAR8          *Name,
+  IN UINTN                Size,
+  IN BENCHMARK_OPERATION  Operation,
+  IN VOID                 *Context
+  )
+{
+  UINT64  Iterations;
+  UINT64  Index;
+  UINT64  Start;
+  UINT64  Elapsed;
+  double  NsPerOp;
+  double  MbPerSec;
+
+  Iterations = 1;
+  while (TRUE) {
+    Start = BenchmarkGetTime ();
+    for (Index = 0; Index < Iterations; Index++) {
+      if (!Operation (Context)) {
+        BenchmarkSkip (Name, Size, "failed");
+        return;
+      }
+    }
+
+    Elapsed = BenchmarkGetTime () - Start;
+    if (Elapsed >= BENCHMARK_MIN_TIME_NS) {
+      break;
+    }
+
+    Iterations *= 2;
+  }
+
+  NsPerOp  = (double)Elapsed / (double)Iterations;
+  MbPerSec = (Size == 0) ? 0 : (double)Size * 1000.0 / NsPerOp;
+  printf (
+    "%s,%s,%llu,ok,%llu,%.1f,%.2f\n",
+    BENCHMARK_BACKEND,
+    Name,
+    (unsigned long long)Size,
+    (unsigned long long)Iterations,
+    NsPerOp,
+    MbPerSec
+    );
+}
+
+/**
+  Hash the buffer with SHA-256.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkSha256 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return Sha256HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output);
+}
+
+/**
+  Hash the buffer with SHA-384.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkSha384 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return Sha384HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output);
+}
+
+/**
+  Hash the buffer with SHA-512.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkSha512 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return Sha512HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output);
+}
+
+/**
+  Hash the buffer with SHA-256, SHA-384 and SHA-512, one whole pass per
+  algorithm, as done for three PCR banks before HashLibBaseCryptoRouter hashed
+  them per chunk.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkPcrBanksSequential (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return Sha256HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output) &&
+         Sha384HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output) &&
+         Sha512HashAll (Buffer->Data, Buffer->DataSize, Buffer->Output);
+}
+
+/**
+  Hash the buffer with SHA-256, SHA-384 and SHA-512, all the algorithms on
+  each chunk before the next one, as done by HashLibBaseCryptoRouter.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkPcrBanksChunked (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+  UINTN             Offset;
+  UINTN             Length;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  if (!Sha256Init (Buffer->Sha256Context) ||
+      !Sha384Init (Buffer->Sha384Context) ||
+      !Sha512Init (Buffer->Sha512Context))
+  {
+    return FALSE;
+  }
+
+  for (Offset = 0; Offset < Buffer->DataSize; Offset += Length) {
+    Length = MIN (Buffer->DataSize - Offset, BENCHMARK_HASH_CHUNK_SIZE);
+    if (!Sha256Update (Buffer->Sha256Context, Buffer->Data + Offset, Length) ||
+        !Sha384Update (Buffer->Sha384Context, Buffer->Data + Offset, Length) ||
+        !Sha512Update (Buffer->Sha512Context, Buffer->Data + Offset, Length))
+    {
+      return FALSE;
+    }
+  }
+
+  return Sha256Final (Buffer->Sha256Context, Buffer->Output) &&
+         Sha384Final (Buffer->Sha384Context, Buffer->Output) &&
+         Sha512Final (Buffer->Sha512Context, Buffer->Output);
+}
+
+/**
+  Compute the HMAC-SHA256 of the buffer.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkHmacSha256 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return HmacSha256All (Buffer->Data, Buffer->DataSize, mBenchmarkKey, sizeof (mBenchmarkKey), Buffer->Output);
+}
+
+/**
+  Compute the HMAC-SHA384 of the buffer.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkHmacSha384 (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+
+  Buffer = (BENCHMARK_BUFFER *)Context;
+  return HmacSha384All (Buffer->Data, Buffer->DataSize, mBenchmarkKey, sizeof (mBenchmarkKey), Buffer->Output);
+}
+
+/**
+  Encrypt the buffer with AES-256-GCM.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkAeadAesGcmEncrypt (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_BUFFER  *Buffer;
+  UINT8             Tag[16];
+  UINTN             OutSize;
+
+  Buffer  = (BENCHMARK_BUFFER *)Context;
+  OutSize = Buffer->DataSize;
+  return AeadAesGcmEncrypt (
+           mBenchmarkKey,
+           sizeof (mBenchmarkKey),
+           mBenchmarkIv,
+           sizeof (mBenchmarkIv),
+           NULL,
+           0,
+           Buffer->Data,
+           Buffer->DataSize,
+           Tag,
+           sizeof (Tag),
+           Buffer->Output,
+           &OutSize
+           );
+}
+
+/**
+  Verify an RSA PKCS#1 v1.5 signature of a SHA-256 hash.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkRsaPkcs1Verify (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_SIGNATURE  *Signature;
+
+  Signature = (BENCHMARK_SIGNATURE *)Context;
+  return RsaPkcs1Verify (Signature->Key, Signature->Hash, sizeof (Signature->Hash), Signature->Signature, Signature->SignatureSize);
+}
+
+#if !defined (BENCHMARK_BACKEND_MBEDTLS)
+/**
+  Verify an ECDSA P-256 signature of a SHA-256 hash.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkEcDsaVerify (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_SIGNATURE  *Signature;
+
+  Signature = (BENCHMARK_SIGNATURE *)Context;
+  return EcDsaVerify (Signature->Key, CRYPTO_NID_SHA256, Signature->Hash, sizeof (Signature->Hash), Signature->Signature, Signature->SignatureSize);
+}
+
+#endif
+
+/**
+  Verify the PKCS#7 signed data with Pkcs7Verify().
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkPkcs7Verify (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_PKCS7  *Pkcs7;
+
+  Pkcs7 = (BENCHMARK_PKCS7 *)Context;
+  return Pkcs7Verify (Pkcs7->P7Data, Pkcs7->P7Length, Pkcs7->TrustedCert, Pkcs7->CertLength, Pkcs7->Data, Pkcs7->DataSize);
+}
+
+/**
+  Verify the PKCS#7 signed data with a PKCS#7 verification context.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkPkcs7VerifyWithContext (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_PKCS7  *Pkcs7;
+
+  Pkcs7 = (BENCHMARK_PKCS7 *)Context;
+  return Pkcs7VerifyWithContext (Pkcs7->VerifyContext, Pkcs7->P7Data, Pkcs7->P7Length, Pkcs7->Data, Pkcs7->DataSize);
+}
+
+/**
+  Verify the PKCS#7 signed data over its content given in pieces of
+  BENCHMARK_HASH_CHUNK_SIZE bytes.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkPkcs7VerifyStream (
+  IN VOID  *Context
+  )
+{
+  BENCHMARK_PKCS7  *Pkcs7;
+  VOID             *Stream;
+  UINTN            Offset;
+  UINTN            Length;
+  BOOLEAN          Status;
+
+  Pkcs7  = (BENCHMARK_PKCS7 *)Context;
+  Stream = Pkcs7VerifyStreamNew (Pkcs7->P7Data, Pkcs7->P7Length, Pkcs7->TrustedCert, Pkcs7->CertLength);
+  if (Stream == NULL) {
+    return FALSE;
+  }
+
+  Status = TRUE;
+  for (Offset = 0; Status && (Offset < Pkcs7->DataSize); Offset += Length) {
+    Length = MIN (Pkcs7->DataSize - Offset, BENCHMARK_HASH_CHUNK_SIZE);
+    Status = Pkcs7VerifyStreamUpdate (Stream, Pkcs7->Data + Offset, Length);
+  }
+
+  Status = Status && Pkcs7VerifyStreamFinal (Stream);
+  Pkcs7VerifyStreamFree (Stream);
+  return Status;
+}
+
+/**
+  Verify the Authenticode signature of the SHA-256 test image.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkAuthenticodeVerify (
+  IN VOID  *Context
+  )
+{
+  return AuthenticodeVerify (
+           AuthenticodeWithSha256,
+           AuthenticodeWithSha256Size,
+           TestRootCert2,
+           TestRootCert2Size,
+           PeSha256Hash,
+           SHA256_DIGEST_SIZE
+           );
+}
+
+/**
+  Verify the Authenticode signature of the SHA-256 test image with a
+  PKCS#7 verification context.
+
+  @param[in]  Context  Context of the benchmark.
+
+  @retval TRUE   The operation succeeded.
+  @retval FALSE  The operation failed.
+
+**/
+STATIC
+BOOLEAN
+BenchmarkAuthenticodeVerifyWithContext (
+  IN VOID  *Context
+  )
+{
+  return AuthenticodeVerifyWithContext (
+           Context,
+           AuthenticodeWithSha256,
+           AuthenticodeWithSha256Size,
+           PeSha256Hash,
+           SHA256_DIGEST_SIZE
+           );
+}
+
+/**
+  Run the hash, HMAC and AES-GCM benchmarks for each data size.
+
+**/
+STATIC
+VOID
+BenchmarkBulk (
+  VOID
+  )
+{
+  BENCHMARK_BUFFER  Buffer;
+  UINTN             Index;
+  UINTN             Size;
+
+  Buffer.Data          = AllocatePool (SIZE_1MB);
+  Buffer.Output        = AllocatePool (SIZE_1MB);
+  Buffer.Sha256Context = AllocatePool (Sha256GetContextSize ());
+  Buffer.Sha384Context = AllocatePool (Sha384GetContextSize ());
+  Buffer.Sha512Context = AllocatePool (Sha512GetContextSize ());
+  if ((Buffer.Data == NULL) || (Buffer.Output == NULL) || (Buffer.Sha256Context == NULL) ||
+      (Buffer.Sha384Context == NULL) || (Buffer.Sha512Context == NULL))
+  {
+    BenchmarkSkip ("Bulk", 0, "failed");
+    return;
+  }
+
+  for (Index = 0; Index < SIZE_1MB; Index++) {
+    Buffer.Data[Index] = (UINT8)(Index * 7);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkDataSizes); Index++) {
+    Size            = mBenchmarkDataSizes[Index];
+    Buffer.DataSize = Size;
+    BenchmarkRun ("Sha256HashAll", Size, BenchmarkSha256, &Buffer);
+    BenchmarkRun ("Sha384HashAll", Size, BenchmarkSha384, &Buffer);
+    BenchmarkRun ("Sha512HashAll", Size, BenchmarkSha512, &Buffer);
+    BenchmarkRun ("PcrBanksSequential", Size, BenchmarkPcrBanksSequential, &Buffer);
+    BenchmarkRun ("PcrBanksChunked", Size, BenchmarkPcrBanksChunked, &Buffer);
+    //
+    // SHA-3 is only exposed through ParallelHash256HashAll(), which the host
+    // BaseCryptLib instances do not build.
+    //
+    BenchmarkSkip ("ParallelHash256HashAll", Size, "unsupported");
+    BenchmarkRun ("HmacSha256All", Size, BenchmarkHmacSha256, &Buffer);
+    BenchmarkRun ("HmacSha384All", Size, BenchmarkHmacSha384, &Buffer);
+    BenchmarkRun ("AeadAesGcmEncrypt", Size, BenchmarkAeadAesGcmEncrypt, &Buffer);
+  }
+
+  FreePool (Buffer.Data);
+  FreePool (Buffer.Output);
+  FreePool (Buffer.Sha256Context);
+  FreePool (Buffer.Sha384Context);
+  FreePool (Buffer.Sha512Context);
+}
+
+/**
+  Run the RSA and ECDSA signature verification benchmarks.
+
+**/
+STATIC
+VOID
+BenchmarkSignature (
+  VOID
+  )
+{
+  BENCHMARK_SIGNATURE  Signature;
+  VOID                 *RsaPrivKey;
+  UINT8                EcSignature[66 * 2];
+  UINT8                EcPublicKey[66 * 2];
+  UINTN                EcPublicKeySize;
+
+  Sha256HashAll (mBenchmarkKey, sizeof (mBenchmarkKey), Signature.Hash);
+
+  //
+  // RSA PKCS#1 v1.5 with the key of the PKCS#7 test certificate.
+  //
+  Signature.Key           = NULL;
+  Signature.Signature     = NULL;
+  Signature.SignatureSize = 0;
+  RsaPrivKey              = NULL;
+  if (RsaGetPrivateKeyFromPem (TestKeyPem, TestKeyPemSize, PemPass, &RsaPrivKey) &&
+      RsaGetPublicKeyFromX509 (TestCert, TestCertSize, &Signature.Key))
+  {
+    RsaPkcs1Sign (RsaPrivKey, Signature.Hash, sizeof (Signature.Hash), NULL, &Signature.SignatureSize);
+    Signature.Signature = AllocatePool (Signature.SignatureSize);
+  }
+
+  if ((Signature.Signature != NULL) &&
+      RsaPkcs1Sign (RsaPrivKey, Signature.Hash, sizeof (Signature.Hash), Signature.Signature, &Signature.SignatureSize))
+  {
+    BenchmarkRun ("RsaPkcs1Verify", 0, BenchmarkRsaPkcs1Verify, &Signature);
+  } else {
+    BenchmarkSkip ("RsaPkcs1Verify", 0, "failed");
+  }
+
+  RsaFree (RsaPrivKey);
+  RsaFree (Signature.Key);
+  if (Signature.Signature != NULL) {
+    FreePool (Signature.Signature);
+  }
+
+  //
+  // ECDSA P-256 with a key generated for the benchmark.
+  //
+ #if defined (BENCHMARK_BACKEND_MBEDTLS)
+  BenchmarkSkip ("EcDsaVerify", 0, "unsupported");
+ #else
+  Signature.Key           = EcNewByNid (CRYPTO_NID_SECP256R1);
+  Signature.Signature     = EcSignature;
+  Signature.SignatureSize = sizeof (EcSignature);
+  EcPublicKeySize         = sizeof (EcPublicKey);
+  if ((Signature.Key != NULL) &&
+      EcGenerateKey (Signature.Key, EcPublicKey, &EcPublicKeySize) &&
+      EcDsaSign (Signature.Key, CRYPTO_NID_SHA256, Signature.Hash, sizeof (Signature.Hash), EcSignature, &Signature.SignatureSize))
+  {
+    BenchmarkRun ("EcDsaVerify", 0, BenchmarkEcDsaVerify, &Signature);
+  } else {
+    BenchmarkSkip ("EcDsaVerify", 0, "failed");
+  }
+
+  EcFree (Signature.Key);
+ #endif
+}
+
+/**
+  Run the PKCS#7 and Authenticode verification benchmarks.
+
+**/
+STATIC
+VOID
+BenchmarkPkcs7 (
+  VOID
+  )
+{
+  BENCHMARK_PKCS7  Pkcs7;
+  UINT8            *SignCert;
+  UINTN            Index;
+  VOID             *AuthenticodeContext;
+
+  SignCert            = NULL;
+  Pkcs7.Data          = AllocatePool (SIZE_1MB);
+  Pkcs7.TrustedCert   = TestCACert;
+  Pkcs7.CertLength    = TestCACertSize;
+  Pkcs7.VerifyContext = Pkcs7VerifyContextNew (TestCACert, TestCACertSize);
+  if ((Pkcs7.Data == NULL) || (Pkcs7.VerifyContext == NULL) ||
+      !X509ConstructCertificate (TestCert, TestCertSize, &SignCert))
+  {
+    BenchmarkSkip ("Pkcs7Verify", 0, "failed");
+    goto Authenticode;
+  }
+
+  for (Index = 0; Index < SIZE_1MB; Index++) {
+    Pkcs7.Data[Index] = (UINT8)(Index * 13);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkDataSizes); Index++) {
+    Pkcs7.DataSize = mBenchmarkDataSizes[Index];
+    if (!Pkcs7Sign (
+           TestKeyPem,
+           TestKeyPemSize,
+           (CONST UINT8 *)PemPass,
+           Pkcs7.Data,
+           Pkcs7.DataSize,
+           SignCert,
+           NULL,
+           &Pkcs7.P7Data,
+           &Pkcs7.P7Length
+           ))
+    {
+      BenchmarkSkip ("Pkcs7Verify", Pkcs7.DataSize, "failed");
+      continue;
+    }
+
+    BenchmarkRun ("Pkcs7Verify", Pkcs7.DataSize, BenchmarkPkcs7Verify, &Pkcs7);
+    BenchmarkRun ("Pkcs7VerifyWithContext", Pkcs7.DataSize, BenchmarkPkcs7VerifyWithContext, &Pkcs7);
+    BenchmarkRun ("Pkcs7VerifyStream", Pkcs7.DataSize, BenchmarkPkcs7VerifyStream, &Pkcs7);
+    FreePool (Pkcs7.P7Data);
+  }
+
+Authenticode:
+  Pkcs7VerifyContextFree (Pkcs7.VerifyContext);
+  if (Pkcs7.Data != NULL) {
+    FreePool (Pkcs7.Data);
+  }
+
+  X509Free (SignCert);
+
+  BenchmarkRun ("AuthenticodeVerify", 0, BenchmarkAuthenticodeVerify, NULL);
+  AuthenticodeContext = Pkcs7VerifyContextNew (TestRootCert2, TestRootCert2Size);
+  if (AuthenticodeContext != NULL) {
+    BenchmarkRun ("AuthenticodeVerifyWithContext", 0, BenchmarkAuthenticodeVerifyWithContext, AuthenticodeContext);
+    Pkcs7VerifyContextFree (AuthenticodeContext);
+  } else {
+    BenchmarkSkip ("AuthenticodeVerifyWithContext", 0, "failed");
+  }
+}
+
+/**
+  Standard POSIX C entry point for host based benchmark execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  ProcessLibraryConstructorList ();
+  printf ("backend,benchmark,size,status,iterations,ns_per_op,mb_per_s\n");
+  BenchmarkBulk ();
+  BenchmarkSignature ();
+  BenchmarkPkcs7 ();
+  return 0;
+}
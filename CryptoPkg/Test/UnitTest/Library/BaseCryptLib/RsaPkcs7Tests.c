@@ -227,6 +227,10 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  TestCert[] = {
   0xd6
 };
 
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  TestKeyPemSize = sizeof (TestKeyPem);
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  TestCACertSize = sizeof (TestCACert);
+GLOBAL_REMOVE_IF_UNREFERENCED UINTN  TestCertSize   = sizeof (TestCert);
+
 //
 // Message Hash for Signing & Verification Validation.
 //
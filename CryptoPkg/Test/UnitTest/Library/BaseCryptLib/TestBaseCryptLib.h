@@ -44,6 +44,22 @@ typedef struct {
   TEST_DESC                   *TestDesc;
 } SUITE_DESC;
 
+//
+// Test vectors shared with the benchmark.
+//
+extern CONST UINT8  TestKeyPem[];
+extern UINTN        TestKeyPemSize;
+extern CONST CHAR8  *PemPass;
+extern CONST UINT8  TestCACert[];
+extern UINTN        TestCACertSize;
+extern CONST UINT8  TestCert[];
+extern UINTN        TestCertSize;
+extern UINT8        AuthenticodeWithSha256[];
+extern UINTN        AuthenticodeWithSha256Size;
+extern UINT8        TestRootCert2[];
+extern UINTN        TestRootCert2Size;
+extern UINT8        PeSha256Hash[];
+
 extern UINTN      mPkcs7EkuTestNum;
 extern TEST_DESC  mPkcs7EkuTest[];
 
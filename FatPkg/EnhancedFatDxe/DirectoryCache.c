@@ -37,12 +37,17 @@ FatFreeODir (
     FatFreeDirEnt (DirEnt);
   }
 
+  if (ODir->LongNameHashTable != NULL) {
+    FreePool (ODir->LongNameHashTable);
+  }
+
   FreePool (ODir);
 }
 
 /**
 
   Allocate the directory structure.
+  The hash tables are sized from the number of entries the directory can hold.
 
   @param  OFile                   - The corresponding OFile.
 
@@ -63,11 +68,82 @@ FatAllocateODir (
     ODir->Signature = FAT_ODIR_SIGNATURE;
     InitializeListHead (&ODir->ChildList);
     ODir->CurrentCursor = &ODir->ChildList;
+    if (EFI_ERROR (FatAllocateHashTable (ODir, OFile->FileSize / sizeof (FAT_DIRECTORY_ENTRY)))) {
+      FreePool (ODir);
+      ODir = NULL;
+    }
   }
 
   return ODir;
 }
 
+/**
+
+  Initialize the directory cache of the volume. The capacity of the cache is
+  decided by the amount of free system memory.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeODirCache (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  EFI_STATUS             Status;
+  EFI_MEMORY_DESCRIPTOR  *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR  *MemoryMapEntry;
+  UINTN                  MemoryMapSize;
+  UINTN                  MapKey;
+  UINTN                  DescriptorSize;
+  UINT32                 DescriptorVersion;
+  UINT64                 FreePages;
+  UINT64                 MaxCount;
+
+  Volume->DirCacheMaxCount = FAT_MIN_DIR_CACHE_COUNT;
+
+  MemoryMap     = NULL;
+  MemoryMapSize = 0;
+  Status        = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  while (Status == EFI_BUFFER_TOO_SMALL) {
+    //
+    // Reserve room for the descriptors added by the pool allocation itself
+    //
+    MemoryMapSize += 2 * DescriptorSize;
+    MemoryMap      = AllocatePool (MemoryMapSize);
+    if (MemoryMap == NULL) {
+      return;
+    }
+
+    Status = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+    if (EFI_ERROR (Status)) {
+      FreePool (MemoryMap);
+      MemoryMap = NULL;
+    }
+  }
+
+  if (MemoryMap == NULL) {
+    return;
+  }
+
+  FreePages = 0;
+  for (MemoryMapEntry = MemoryMap;
+       (UINTN)MemoryMapEntry < (UINTN)MemoryMap + MemoryMapSize;
+       MemoryMapEntry = NEXT_MEMORY_DESCRIPTOR (MemoryMapEntry, DescriptorSize)
+       )
+  {
+    if (MemoryMapEntry->Type == EfiConventionalMemory) {
+      FreePages += MemoryMapEntry->NumberOfPages;
+    }
+  }
+
+  FreePool (MemoryMap);
+
+  MaxCount                 = DivU64x32 (EFI_PAGES_TO_SIZE (FreePages), FAT_DIR_CACHE_MEMORY_UNIT);
+  Volume->DirCacheMaxCount = (UINTN)MIN (MAX (MaxCount, FAT_MIN_DIR_CACHE_COUNT), FAT_MAX_DIR_CACHE_COUNT);
+  DEBUG ((DEBUG_INFO, "FatInitializeODirCache: cache up to %d directories\n", (UINT32)Volume->DirCacheMaxCount));
+}
+
 /**
 
   Discard the directory structure when an OFile will be freed.
@@ -93,7 +169,7 @@ FatDiscardODir (
     //
     ODir->DirCacheTag = OFile->FileCluster;
     InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
+    if (Volume->DirCacheCount == Volume->DirCacheMaxCount) {
       //
       // Replace the least recent used directory
       //
@@ -149,6 +225,7 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
+      Volume->DirCacheHits++;
       ODir = CurrentODir;
       break;
     }
@@ -158,6 +235,7 @@ FatRequestODir (
     //
     // This directory is not cached, then allocate a new one
     //
+    Volume->DirCacheMisses++;
     ODir = FatAllocateODir (OFile);
   }
 
@@ -178,6 +256,17 @@ FatCleanupODirCache (
 {
   FAT_ODIR  *ODir;
 
+  if ((Volume->DirCacheHits + Volume->DirCacheMisses) != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "FatCleanupODirCache: %Lu hits, %Lu misses, %Lu entries loaded in %Lu ns\n",
+      Volume->DirCacheHits,
+      Volume->DirCacheMisses,
+      Volume->DirLoadCount,
+      GetTimeInNanoSecond (Volume->DirLoadTicks)
+      ));
+  }
+
   while (Volume->DirCacheCount > 0) {
     ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
     RemoveEntryList (&ODir->DirCacheLink);
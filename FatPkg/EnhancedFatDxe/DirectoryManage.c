@@ -351,6 +351,7 @@ FatLoadNextDirEnt (
   FAT_DIRENT           *DirEnt;
   FAT_ODIR             *ODir;
   FAT_DIRECTORY_ENTRY  Entry;
+  UINT64               Ticks;
 
   ODir = OFile->ODir;
   //
@@ -362,6 +363,7 @@ FatLoadNextDirEnt (
   //
   ASSERT (!ODir->EndOfDir);
   DirEnt = NULL;
+  Ticks  = GetPerformanceCounter ();
 
   for ( ; ;) {
     //
@@ -423,6 +425,15 @@ FatLoadNextDirEnt (
     ODir->EndOfDir = TRUE;
   }
 
+  //
+  // Account the time spent reading the directory. Reaching its end doesn't
+  // load an entry, so it is not counted as one.
+  //
+  OFile->Volume->DirLoadTicks += GetElapsedTicks (&Ticks);
+  if (DirEnt != NULL) {
+    OFile->Volume->DirLoadCount++;
+  }
+
   *PtrDirEnt = DirEnt;
   return EFI_SUCCESS;
 
@@ -29,6 +29,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 #include "FatFileSystem.h"
 
@@ -116,7 +118,14 @@ STATIC_ASSERT ((((1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT) / (1 << MIN_BLOCK_ALIGN
 #define LC_ISO_639_2_ENTRY_SIZE  3
 #define MAX_LANG_CODE_SIZE       100
 
-#define FAT_MAX_DIR_CACHE_COUNT  8
+//
+// The directory cache keeps at least FAT_MIN_DIR_CACHE_COUNT discarded
+// directories, and grows by one directory per FAT_DIR_CACHE_MEMORY_UNIT of
+// free system memory, up to FAT_MAX_DIR_CACHE_COUNT.
+//
+#define FAT_MIN_DIR_CACHE_COUNT    8
+#define FAT_MAX_DIR_CACHE_COUNT    128
+#define FAT_DIR_CACHE_MEMORY_UNIT  SIZE_16MB
 #define FAT_MAX_DIRENTRY_COUNT   0xFFFF
 typedef CHAR8 LC_ISO_639_2;
 
@@ -174,10 +183,12 @@ typedef struct {
 } DISK_CACHE;
 
 //
-// Hash table size
+// Hash table size. Each directory starts with a table sized from its on-disk
+// entry count and doubles when the load factor exceeds HASH_TABLE_MAX_LOAD.
 //
-#define HASH_TABLE_SIZE  0x400
-#define HASH_TABLE_MASK  (HASH_TABLE_SIZE - 1)
+#define HASH_TABLE_MIN_SIZE  0x40
+#define HASH_TABLE_MAX_SIZE  0x10000
+#define HASH_TABLE_MAX_LOAD  2
 
 //
 // The directory entry for opened directory
@@ -210,8 +221,10 @@ struct _FAT_ODIR {
   BOOLEAN       EndOfDir;                     // Indicate whether we have reached the end of the directory
   LIST_ENTRY    DirCacheLink;                 // Linked in Volume->DirCacheList when discarded
   UINTN         DirCacheTag;                  // The identification of the directory when in directory cache
-  FAT_DIRENT    *LongNameHashTable[HASH_TABLE_SIZE];
-  FAT_DIRENT    *ShortNameHashTable[HASH_TABLE_SIZE];
+  UINT32        HashTableSize;                // Number of buckets in each hash table, always a power of 2
+  UINTN         HashEntryCount;               // Number of directory entries in the hash tables
+  FAT_DIRENT    **LongNameHashTable;
+  FAT_DIRENT    **ShortNameHashTable;
 };
 
 typedef struct {
@@ -383,6 +396,15 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                         DirCacheList;
   UINTN                              DirCacheCount;
+  UINTN                              DirCacheMaxCount;
+
+  //
+  // Directory cache statistics
+  //
+  UINT64                             DirCacheHits;
+  UINT64                             DirCacheMisses;
+  UINT64                             DirLoadTicks;   // Performance counter ticks spent loading entries from disk
+  UINT64                             DirLoadCount;   // Number of directory entries loaded from disk
 
   //
   // Disk Cache for this volume
@@ -1815,6 +1837,23 @@ FatShortNameHashSearch (
   IN CHAR8     *ShortNameString
   );
 
+/**
+
+  Allocate the hash tables of a directory.
+
+  @param  ODir                  - The directory whose hash tables are allocated.
+  @param  EntryCount            - The expected number of directory entries.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Can not allocate memory for the hash tables.
+
+**/
+EFI_STATUS
+FatAllocateHashTable (
+  IN FAT_ODIR  *ODir,
+  IN UINTN     EntryCount
+  );
+
 /**
 
   Insert directory entry to hash table.
@@ -1982,6 +2021,19 @@ FatFileNameIsValid (
 // DirectoryCache.c
 //
 
+/**
+
+  Initialize the directory cache of the volume. The capacity of the cache is
+  decided by the amount of free system memory.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeODirCache (
+  IN FAT_VOLUME  *Volume
+  );
+
 /**
 
   Discard the directory structure when an OFile will be freed.
@@ -14,7 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
   @param  LongNameString        - The long name string to be hashed.
 
-  @return HashValue.
+  @return HashValue, not yet reduced to the hash table size.
 
 **/
 STATIC
@@ -34,7 +34,7 @@ FatHashLongName (
     );
   FatStrUpr (UpCasedLongFileName);
   gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
 }
 
 /**
@@ -43,7 +43,7 @@ FatHashLongName (
 
   @param  ShortNameString       - The short name string to be hashed.
 
-  @return HashValue
+  @return HashValue, not yet reduced to the hash table size.
 
 **/
 STATIC
@@ -55,7 +55,91 @@ FatHashShortName (
   UINT32  HashValue;
 
   gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
+}
+
+/**
+
+  Allocate the hash tables of a directory.
+
+  @param  ODir                  - The directory whose hash tables are allocated.
+  @param  EntryCount            - The expected number of directory entries.
+
+  @retval EFI_SUCCESS           - The hash tables are allocated.
+  @retval EFI_OUT_OF_RESOURCES  - Can not allocate memory for the hash tables.
+
+**/
+EFI_STATUS
+FatAllocateHashTable (
+  IN FAT_ODIR  *ODir,
+  IN UINTN     EntryCount
+  )
+{
+  UINT32      TableSize;
+  FAT_DIRENT  **HashTable;
+
+  TableSize = HASH_TABLE_MIN_SIZE;
+  while ((TableSize < HASH_TABLE_MAX_SIZE) && (TableSize * HASH_TABLE_MAX_LOAD < EntryCount)) {
+    TableSize <<= 1;
+  }
+
+  //
+  // Both the long name and the short name hash tables are carved from one pool
+  //
+  HashTable = AllocateZeroPool (2 * TableSize * sizeof (FAT_DIRENT *));
+  if (HashTable == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ODir->HashTableSize      = TableSize;
+  ODir->LongNameHashTable  = HashTable;
+  ODir->ShortNameHashTable = HashTable + TableSize;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Double the hash tables of a directory when they become too crowded.
+  If the memory can not be allocated, the current hash tables are kept.
+
+  @param  ODir                  - The directory whose hash tables are to be grown.
+
+**/
+STATIC
+VOID
+FatGrowHashTable (
+  IN FAT_ODIR  *ODir
+  )
+{
+  FAT_DIRENT  **OldHashTable;
+  FAT_DIRENT  *DirEnt;
+  LIST_ENTRY  *Link;
+  UINT32      OldTableSize;
+
+  if ((ODir->HashTableSize >= HASH_TABLE_MAX_SIZE) ||
+      (ODir->HashEntryCount <= ODir->HashTableSize * HASH_TABLE_MAX_LOAD))
+  {
+    return;
+  }
+
+  OldHashTable = ODir->LongNameHashTable;
+  OldTableSize = ODir->HashTableSize;
+  if (EFI_ERROR (FatAllocateHashTable (ODir, ODir->HashEntryCount))) {
+    return;
+  }
+
+  //
+  // Every directory entry in the hash tables is also on the child list,
+  // so re-hash them by walking the list
+  //
+  ODir->HashEntryCount = 0;
+  for (Link = ODir->ChildList.ForwardLink; Link != &ODir->ChildList; Link = Link->ForwardLink) {
+    DirEnt = DIRENT_FROM_LINK (Link);
+    FatInsertToHashTable (ODir, DirEnt);
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "FatGrowHashTable: %u -> %u buckets\n", OldTableSize, ODir->HashTableSize));
+  FreePool (OldHashTable);
 }
 
 /**
@@ -76,7 +160,7 @@ FatLongNameHashSearch (
 {
   FAT_DIRENT  **PreviousHashNode;
 
-  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString)];
+  for (PreviousHashNode   = &ODir->LongNameHashTable[FatHashLongName (LongNameString) & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->LongNameForwardLink
        )
@@ -107,7 +191,7 @@ FatShortNameHashSearch (
 {
   FAT_DIRENT  **PreviousHashNode;
 
-  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString)];
+  for (PreviousHashNode   = &ODir->ShortNameHashTable[FatHashShortName (ShortNameString) & (ODir->HashTableSize - 1)];
        *PreviousHashNode != NULL;
        PreviousHashNode   = &(*PreviousHashNode)->ShortNameForwardLink
        )
@@ -140,17 +224,20 @@ FatInsertToHashTable (
   //
   // Insert hash table index for short name
   //
-  HashTableIndex               = FatHashShortName (DirEnt->Entry.FileName);
+  HashTableIndex               = FatHashShortName (DirEnt->Entry.FileName) & (ODir->HashTableSize - 1);
   HashTable                    = ODir->ShortNameHashTable;
   DirEnt->ShortNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]    = DirEnt;
   //
   // Insert hash table index for long name
   //
-  HashTableIndex              = FatHashLongName (DirEnt->FileString);
+  HashTableIndex              = FatHashLongName (DirEnt->FileString) & (ODir->HashTableSize - 1);
   HashTable                   = ODir->LongNameHashTable;
   DirEnt->LongNameForwardLink = HashTable[HashTableIndex];
   HashTable[HashTableIndex]   = DirEnt;
+
+  ODir->HashEntryCount++;
+  FatGrowHashTable (ODir);
 }
 
 /**
@@ -169,4 +256,5 @@ FatDeleteFromHashTable (
 {
   *FatShortNameHashSearch (ODir, DirEnt->Entry.FileName) = DirEnt->ShortNameForwardLink;
   *FatLongNameHashSearch (ODir, DirEnt->FileString)      = DirEnt->LongNameForwardLink;
+  ODir->HashEntryCount--;
 }
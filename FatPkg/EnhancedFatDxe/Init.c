@@ -95,6 +95,11 @@ FatAllocateVolume (
     goto Done;
   }
 
+  //
+  // Size the directory cache
+  //
+  FatInitializeODirCache (Volume);
+
   //
   // Initialize cache
   //
@@ -127,6 +127,33 @@ AhciOrReg (
   AhciWriteReg (PciIo, Offset, Data);
 }
 
+/**
+  Stall for the current polling interval, then double the interval for the
+  next poll until it reaches EFI_AHCI_POLL_MAX_INTERVAL.
+
+  Fast devices complete most commands in a few tens of microseconds, so
+  starting with a short interval avoids rounding every command up to a
+  full 100us poll, while slow commands still settle into 100us polls.
+
+  @param[in, out]  Interval    The polling interval in microseconds.
+
+  @return The number of microseconds stalled.
+
+**/
+STATIC
+UINT32
+AhciPollStall (
+  IN OUT UINT32  *Interval
+  )
+{
+  UINT32  Stalled;
+
+  Stalled = *Interval;
+  MicroSecondDelay (Stalled);
+  *Interval = MIN (Stalled * 2, EFI_AHCI_POLL_MAX_INTERVAL);
+  return Stalled;
+}
+
 /**
   Wait for the value of the specified MMIO register set to the test value.
 
@@ -152,6 +179,7 @@ AhciWaitMmioSet (
 {
   UINT32   Value;
   UINT64   Delay;
+  UINT32   Interval;
   BOOLEAN  InfiniteWait;
 
   if (Timeout == 0) {
@@ -160,7 +188,8 @@ AhciWaitMmioSet (
     InfiniteWait = FALSE;
   }
 
-  Delay = DivU64x32 (Timeout, 1000) + 1;
+  Delay    = DivU64x32 (Timeout, 10) + EFI_AHCI_POLL_MAX_INTERVAL;
+  Interval = EFI_AHCI_POLL_MIN_INTERVAL;
 
   do {
     //
@@ -172,12 +201,7 @@ AhciWaitMmioSet (
       return EFI_SUCCESS;
     }
 
-    //
-    // Stall for 100 microseconds.
-    //
-    MicroSecondDelay (100);
-
-    Delay--;
+    Delay -= MIN (AhciPollStall (&Interval), Delay);
   } while (InfiniteWait || (Delay > 0));
 
   return EFI_TIMEOUT;
@@ -206,6 +230,7 @@ AhciWaitMemSet (
 {
   UINT32   Value;
   UINT64   Delay;
+  UINT32   Interval;
   BOOLEAN  InfiniteWait;
 
   if (Timeout == 0) {
@@ -214,7 +239,8 @@ AhciWaitMemSet (
     InfiniteWait = FALSE;
   }
 
-  Delay =  DivU64x32 (Timeout, 1000) + 1;
+  Delay    = DivU64x32 (Timeout, 10) + EFI_AHCI_POLL_MAX_INTERVAL;
+  Interval = EFI_AHCI_POLL_MIN_INTERVAL;
 
   do {
     //
@@ -232,12 +258,7 @@ AhciWaitMemSet (
       return EFI_SUCCESS;
     }
 
-    //
-    // Stall for 100 microseconds.
-    //
-    MicroSecondDelay (100);
-
-    Delay--;
+    Delay -= MIN (AhciPollStall (&Interval), Delay);
   } while (InfiniteWait || (Delay > 0));
 
   return EFI_TIMEOUT;
@@ -874,8 +895,10 @@ AhciWaitUntilFisReceived (
   EFI_STATUS  Status;
   BOOLEAN     InfiniteWait;
   UINT64      Delay;
+  UINT32      Interval;
 
-  Delay =  DivU64x32 (Timeout, 1000) + 1;
+  Delay    = DivU64x32 (Timeout, 10) + EFI_AHCI_POLL_MAX_INTERVAL;
+  Interval = EFI_AHCI_POLL_MIN_INTERVAL;
   if (Timeout == 0) {
     InfiniteWait = TRUE;
   } else {
@@ -888,11 +911,7 @@ AhciWaitUntilFisReceived (
       return Status;
     }
 
-    //
-    // Stall for 100 microseconds.
-    //
-    MicroSecondDelay (100);
-    Delay--;
+    Delay -= MIN (AhciPollStall (&Interval), Delay);
   } while (InfiniteWait || (Delay > 0));
 
   return EFI_TIMEOUT;
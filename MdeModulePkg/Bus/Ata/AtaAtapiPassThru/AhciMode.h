@@ -62,6 +62,13 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT  0x400000
 
+//
+// Polling interval range in microseconds used while waiting for the
+// controller or device.
+//
+#define EFI_AHCI_POLL_MIN_INTERVAL  1
+#define EFI_AHCI_POLL_MAX_INTERVAL  100
+
 #define EFI_AHCI_FIS_REGISTER_H2D           0x27         // Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH  20
 #define EFI_AHCI_FIS_REGISTER_D2H           0x34         // Register FIS - Device to Host
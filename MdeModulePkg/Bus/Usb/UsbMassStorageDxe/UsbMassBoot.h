@@ -60,8 +60,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 //
 // Other parameters, Max carried size is 64KB.
+// SuperSpeed devices carry up to 1MB per command so that a large read
+// does not pay a CBW/CSW round trip for every 64KB.
 //
-#define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
+#define USB_BOOT_MAX_CARRY_SIZE     SIZE_64KB
+#define USB_BOOT_MAX_CARRY_SIZE_SS  SIZE_1MB
+
+//
+// Max packet size of a SuperSpeed bulk endpoint
+//
+#define USB_BOOT_SS_BULK_MAX_PACKET  1024
 
 //
 // Retry mass command times, set by experience
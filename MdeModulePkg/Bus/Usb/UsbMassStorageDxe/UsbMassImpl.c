@@ -323,6 +323,53 @@ UsbMassFlushBlocks (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the max data length that one READ/WRITE command can carry.
+
+  Full speed and high speed devices keep the conservative 64KB limit that
+  older devices are known to handle. SuperSpeed devices, identified by
+  their 1024 byte bulk endpoints, carry up to 1MB per command.
+
+  @param  UsbIo                  The USB IO protocol of the device.
+
+  @return The max data length in bytes.
+
+**/
+UINT32
+UsbMassGetMaxCarrySize (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo
+  )
+{
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR   EndPoint;
+  EFI_STATUS                    Status;
+  UINT8                         Index;
+  BOOLEAN                       FoundBulk;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    return USB_BOOT_MAX_CARRY_SIZE;
+  }
+
+  FoundBulk = FALSE;
+  for (Index = 0; Index < Interface.NumEndpoints; Index++) {
+    Status = UsbIo->UsbGetEndpointDescriptor (UsbIo, Index, &EndPoint);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    if (USB_IS_BULK_ENDPOINT (EndPoint.Attributes)) {
+      if (EndPoint.MaxPacketSize < USB_BOOT_SS_BULK_MAX_PACKET) {
+        return USB_BOOT_MAX_CARRY_SIZE;
+      }
+
+      FoundBulk = TRUE;
+    }
+  }
+
+  return FoundBulk ? USB_BOOT_MAX_CARRY_SIZE_SS : USB_BOOT_MAX_CARRY_SIZE;
+}
+
 /**
   Initialize the media parameter data for EFI_BLOCK_IO_MEDIA of Block I/O Protocol.
 
@@ -353,6 +400,8 @@ UsbMassInitMedia (
   Media->IoAlign          = 0;
   Media->MediaId          = 1;
 
+  UsbMass->MaxCarrySize = UsbMassGetMaxCarrySize (UsbMass->UsbIo);
+
   Status = UsbBootGetParams (UsbMass);
   DEBUG ((DEBUG_INFO, "UsbMassInitMedia: UsbBootGetParams (%r)\n", Status));
   if (Status == EFI_MEDIA_CHANGED) {
@@ -186,6 +186,11 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  Status = DiskIoCacheCreate (Instance, PcdGet32 (PcdDiskIoCacheBlockNum));
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -217,6 +222,7 @@ ErrorExit:
     }
 
     if (Instance != NULL) {
+      DiskIoCacheDestroy (Instance);
       FreePool (Instance);
     }
 
@@ -330,6 +336,8 @@ DiskIoDriverBindingStop (
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
       );
 
+    DiskIoCacheDestroy (Instance);
+
     Status = gBS->CloseProtocol (
                     ControllerHandle,
                     &gEfiBlockIoProtocolGuid,
@@ -432,6 +440,17 @@ DiskIo2OnReadWriteComplete (
     CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
   }
 
+  if (Subtask->Write && (Instance->Cache != NULL)) {
+    //
+    // A read through the cache may have fetched the blocks while the write was in flight.
+    //
+    DiskIoCacheWriteComplete (
+      Instance,
+      MultU64x32 (Subtask->Lba, Instance->BlockIo->Media->BlockSize) + Subtask->Offset,
+      Subtask->Length
+      );
+  }
+
   DiskIoDestroySubtask (Instance, Subtask);
 
   if (EFI_ERROR (TransactionStatus) || IsListEmpty (&Task->Subtasks)) {
@@ -848,6 +867,7 @@ DiskIo2ReadWriteDisk (
   DISK_IO2_TASK           *Task;
   EFI_TPL                 SubtaskPerformTpl;
   EFI_TPL                 SubtaskLockTpl;
+  EFI_TPL                 CacheTpl;
   BOOLEAN                 Blocking;
   BOOLEAN                 SubtaskBlocking;
   LIST_ENTRY              *SubtasksPtr;
@@ -866,6 +886,20 @@ DiskIo2ReadWriteDisk (
     while (!DiskIo2RemoveCompletedTask (Instance)) {
     }
 
+    //
+    // Serve small blocking reads from the block cache, if there is one.
+    //
+    if (!Write && (Instance->Cache != NULL)) {
+      CacheTpl = gBS->RaiseTPL (TPL_CALLBACK);
+      Status   = DiskIoCacheRead (Instance, MediaId, Offset, BufferSize, Buffer);
+      gBS->RestoreTPL (CacheTpl);
+      if (Status != EFI_UNSUPPORTED) {
+        return Status;
+      }
+
+      Status = EFI_SUCCESS;
+    }
+
     SubtasksPtr = &Subtasks;
   } else {
     DiskIo2RemoveCompletedTask (Instance);
@@ -886,6 +920,15 @@ DiskIo2ReadWriteDisk (
     SubtasksPtr = &Task->Subtasks;
   }
 
+  //
+  // The block cache is write-through, drop the blocks about to be written.
+  //
+  if (Write && (Instance->Cache != NULL)) {
+    CacheTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    DiskIoCacheInvalidate (Instance, Offset, BufferSize);
+    gBS->RestoreTPL (CacheTpl);
+  }
+
   InitializeListHead (SubtasksPtr);
   if (!DiskIoCreateSubtaskList (Instance, Write, Offset, BufferSize, Buffer, Blocking, Instance->SharedWorkingBuffer, SubtasksPtr)) {
     if (Task != NULL) {
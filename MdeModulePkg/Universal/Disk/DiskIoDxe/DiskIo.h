@@ -24,6 +24,49 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// Max number of blocks a single read may span to be served from the block cache.
+// Larger reads are streamed straight from the device so that they do not evict
+// the small, frequently re-read metadata blocks the cache is meant for.
+//
+#define DISK_IO_CACHE_MAX_READ_BLOCKS  64
+
+#define DISK_IO_CACHE_ENTRY_SIGNATURE  SIGNATURE_32 ('d', 'i', 'c', 'e')
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    LruLink;                    /// < link in DISK_IO_CACHE.LruList, most recently used first
+  LIST_ENTRY    HashLink;                   /// < link in DISK_IO_CACHE.HashTable
+  BOOLEAN       Valid;
+  EFI_LBA       Lba;
+  UINT8         *Data;                      /// < one block of data
+} DISK_IO_CACHE_ENTRY;
+
+typedef struct {
+  UINT32                 BlockSize;
+  UINT32                 MediaId;           /// < media the cached blocks belong to
+  UINTN                  EntryCount;
+  DISK_IO_CACHE_ENTRY    *Entries;
+  UINT8                  *DataBuffer;       /// < backing storage of all entries
+  UINTN                  HashSize;          /// < number of buckets, a power of 2
+  LIST_ENTRY             *HashTable;
+  LIST_ENTRY             LruList;
+  UINT8                  *ReadBuffer;       /// < aligned staging buffer for coalesced miss reads
+  UINTN                  ReadBufferPages;
+  //
+  // Statistics
+  //
+  UINT64                 Hits;              /// < blocks served from the cache
+  UINT64                 Misses;            /// < blocks read from the device
+  UINT64                 DeviceReads;       /// < BlockIo reads issued for the misses
+  UINT64                 Invalidations;     /// < blocks dropped because they were written
+  //
+  // Set while a cache operation runs at TPL_CALLBACK, so that a write completing
+  // at TPL_NOTIFY defers its invalidation to a full flush at the end of it.
+  //
+  volatile BOOLEAN       Busy;
+  volatile BOOLEAN       FlushPending;
+} DISK_IO_CACHE;
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                    Signature;
@@ -37,6 +80,8 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  DISK_IO_CACHE             *Cache;         /// < NULL when block caching is disabled
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -464,4 +509,99 @@ DiskIoComponentNameGetControllerName (
   OUT CHAR16                       **ControllerName
   );
 
+//
+// Block cache
+//
+
+/**
+  Create the block cache for a DiskIo instance.
+
+  Caching is only enabled for non-removable, whole-disk media, so that a single
+  cache sits below every partition and file system and no media change can go
+  unnoticed. Writes issued directly through the Block I/O protocols of the disk
+  bypass the cache, which then keeps serving the old content of those blocks.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  BlockNum              Number of blocks to cache. 0 disables caching.
+
+  @retval EFI_SUCCESS           The cache is created, or caching is disabled.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to create the cache.
+
+**/
+EFI_STATUS
+DiskIoCacheCreate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                BlockNum
+  );
+
+/**
+  Destroy the block cache of a DiskIo instance.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Read data through the block cache.
+
+  Blocks found in the cache are copied directly. Runs of adjacent missing
+  blocks are coalesced into a single BlockIo read and then inserted into
+  the cache.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId               ID of the medium to be read.
+  @param  Offset                The starting byte offset to read from.
+  @param  BufferSize            The size in bytes of Buffer.
+  @param  Buffer                A pointer to the destination buffer for the data.
+
+  @retval EFI_UNSUPPORTED       The request cannot be served by the cache and
+                                must take the regular path.
+  @retval EFI_SUCCESS           The data was read correctly.
+  @return Others                The status returned by BlockIo ReadBlocks().
+
+**/
+EFI_STATUS
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  );
+
+/**
+  Drop the cached blocks overlapping a byte range that is about to be written.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset                The starting byte offset of the write.
+  @param  BufferSize            The size in bytes of the write.
+
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  );
+
+/**
+  Drop the cached blocks overlapping a byte range that has been written by a
+  non-blocking request.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset                The starting byte offset of the write.
+  @param  BufferSize            The size in bytes of the write.
+
+**/
+VOID
+DiskIoCacheWriteComplete (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  );
+
 #endif
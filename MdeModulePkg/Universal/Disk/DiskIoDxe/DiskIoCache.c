@@ -0,0 +1,556 @@
+/** @file
+  Block cache of the DiskIo driver.
+
+  Partition drivers, file systems and the boot manager repeatedly read the same
+  small set of blocks (MBR, GPT headers, superblocks, FAT and directory blocks).
+  When enabled by PcdDiskIoCacheBlockNum, the DiskIo instance of every
+  non-removable whole disk keeps a least recently used cache of single blocks
+  to serve those reads. The cache is write-through: every write drops the
+  cached copies of the blocks it touches before reaching the device, and again
+  once a non-blocking write completes. Writes issued directly through the
+  Block I/O protocols of the disk do not go through DiskIo and are not seen by
+  the cache.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Find a cached block without changing its position in the LRU list.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+  @param  Lba        The block to find.
+
+  @return The cache entry of the block, or NULL if the block is not cached.
+
+**/
+STATIC
+DISK_IO_CACHE_ENTRY *
+DiskIoCacheFind (
+  IN DISK_IO_CACHE  *Cache,
+  IN EFI_LBA        Lba
+  )
+{
+  LIST_ENTRY           *Bucket;
+  LIST_ENTRY           *Link;
+  DISK_IO_CACHE_ENTRY  *Entry;
+
+  Bucket = &Cache->HashTable[(UINTN)Lba & (Cache->HashSize - 1)];
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    Entry = CR (Link, DISK_IO_CACHE_ENTRY, HashLink, DISK_IO_CACHE_ENTRY_SIGNATURE);
+    if (Entry->Lba == Lba) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop a block from the cache. The entry becomes the first one to be reused.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+  @param  Entry      The cache entry to drop.
+
+**/
+STATIC
+VOID
+DiskIoCacheDropEntry (
+  IN DISK_IO_CACHE        *Cache,
+  IN DISK_IO_CACHE_ENTRY  *Entry
+  )
+{
+  ASSERT (Entry->Valid);
+  RemoveEntryList (&Entry->HashLink);
+  RemoveEntryList (&Entry->LruLink);
+  InsertTailList (&Cache->LruList, &Entry->LruLink);
+  Entry->Valid = FALSE;
+}
+
+/**
+  Drop all the blocks from the cache.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+
+**/
+STATIC
+VOID
+DiskIoCacheFlush (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Cache->EntryCount; Index++) {
+    if (Cache->Entries[Index].Valid) {
+      DiskIoCacheDropEntry (Cache, &Cache->Entries[Index]);
+    }
+  }
+}
+
+/**
+  Take the least recently used entry and assign it to a block.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+  @param  Lba        The block to cache.
+  @param  Data       One block of data read from the device.
+
+**/
+STATIC
+VOID
+DiskIoCacheInsert (
+  IN DISK_IO_CACHE  *Cache,
+  IN EFI_LBA        Lba,
+  IN UINT8          *Data
+  )
+{
+  DISK_IO_CACHE_ENTRY  *Entry;
+
+  Entry = CR (GetPreviousNode (&Cache->LruList, &Cache->LruList), DISK_IO_CACHE_ENTRY, LruLink, DISK_IO_CACHE_ENTRY_SIGNATURE);
+  if (Entry->Valid) {
+    RemoveEntryList (&Entry->HashLink);
+  }
+
+  Entry->Valid = TRUE;
+  Entry->Lba   = Lba;
+  CopyMem (Entry->Data, Data, Cache->BlockSize);
+  InsertHeadList (&Cache->HashTable[(UINTN)Lba & (Cache->HashSize - 1)], &Entry->HashLink);
+  RemoveEntryList (&Entry->LruLink);
+  InsertHeadList (&Cache->LruList, &Entry->LruLink);
+}
+
+/**
+  Create the block cache for a DiskIo instance.
+
+  Caching is only enabled for non-removable, whole-disk media, so that a single
+  cache sits below every partition and file system and no media change can go
+  unnoticed. Writes issued directly through the Block I/O protocols of the disk
+  bypass the cache, which then keeps serving the old content of those blocks.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  BlockNum              Number of blocks to cache. 0 disables caching.
+
+  @retval EFI_SUCCESS           The cache is created, or caching is disabled.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to create the cache.
+
+**/
+EFI_STATUS
+DiskIoCacheCreate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                BlockNum
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+  DISK_IO_CACHE       *Cache;
+  UINTN               Index;
+
+  Instance->Cache = NULL;
+  Media           = Instance->BlockIo->Media;
+  if ((BlockNum == 0) || Media->RemovableMedia || Media->LogicalPartition || (Media->BlockSize == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  Cache = AllocateZeroPool (sizeof (DISK_IO_CACHE));
+  if (Cache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cache->BlockSize  = Media->BlockSize;
+  Cache->MediaId    = Media->MediaId;
+  Cache->EntryCount = BlockNum;
+  Cache->HashSize   = 1;
+  while (Cache->HashSize < Cache->EntryCount) {
+    Cache->HashSize <<= 1;
+  }
+
+  Cache->Entries         = AllocateZeroPool (Cache->EntryCount * sizeof (DISK_IO_CACHE_ENTRY));
+  Cache->DataBuffer      = AllocatePool (Cache->EntryCount * Cache->BlockSize);
+  Cache->HashTable       = AllocatePool (Cache->HashSize * sizeof (LIST_ENTRY));
+  Cache->ReadBufferPages = EFI_SIZE_TO_PAGES (DISK_IO_CACHE_MAX_READ_BLOCKS * Cache->BlockSize);
+  Cache->ReadBuffer      = AllocateAlignedPages (Cache->ReadBufferPages, Media->IoAlign);
+  if ((Cache->Entries == NULL) || (Cache->DataBuffer == NULL) ||
+      (Cache->HashTable == NULL) || (Cache->ReadBuffer == NULL))
+  {
+    Instance->Cache = Cache;
+    DiskIoCacheDestroy (Instance);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < Cache->HashSize; Index++) {
+    InitializeListHead (&Cache->HashTable[Index]);
+  }
+
+  InitializeListHead (&Cache->LruList);
+  for (Index = 0; Index < Cache->EntryCount; Index++) {
+    Cache->Entries[Index].Signature = DISK_IO_CACHE_ENTRY_SIGNATURE;
+    Cache->Entries[Index].Data      = Cache->DataBuffer + Index * Cache->BlockSize;
+    InitializeListHead (&Cache->Entries[Index].HashLink);
+    InsertTailList (&Cache->LruList, &Cache->Entries[Index].LruLink);
+  }
+
+  Instance->Cache = Cache;
+  return EFI_SUCCESS;
+}
+
+/**
+  Destroy the block cache of a DiskIo instance.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE  *Cache;
+
+  Cache = Instance->Cache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "DiskIo: Cache hits %Lu, misses %Lu, device reads %Lu, invalidations %Lu\n",
+    Cache->Hits,
+    Cache->Misses,
+    Cache->DeviceReads,
+    Cache->Invalidations
+    ));
+
+  if (Cache->ReadBuffer != NULL) {
+    FreeAlignedPages (Cache->ReadBuffer, Cache->ReadBufferPages);
+  }
+
+  if (Cache->HashTable != NULL) {
+    FreePool (Cache->HashTable);
+  }
+
+  if (Cache->DataBuffer != NULL) {
+    FreePool (Cache->DataBuffer);
+  }
+
+  if (Cache->Entries != NULL) {
+    FreePool (Cache->Entries);
+  }
+
+  FreePool (Cache);
+  Instance->Cache = NULL;
+}
+
+/**
+  Mark the cache as being updated, and apply a flush requested meanwhile.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+
+**/
+STATIC
+VOID
+DiskIoCacheBeginUpdate (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  Cache->Busy = TRUE;
+  if (Cache->FlushPending) {
+    Cache->FlushPending = FALSE;
+    Cache->Invalidations += Cache->EntryCount;
+    DiskIoCacheFlush (Cache);
+  }
+}
+
+/**
+  Apply a flush requested while the cache was being updated, and mark the
+  update as done.
+
+  @param  Cache      Pointer to the DISK_IO_CACHE.
+
+**/
+STATIC
+VOID
+DiskIoCacheEndUpdate (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  if (Cache->FlushPending) {
+    Cache->FlushPending = FALSE;
+    Cache->Invalidations += Cache->EntryCount;
+    DiskIoCacheFlush (Cache);
+  }
+
+  Cache->Busy = FALSE;
+}
+
+/**
+  Read data through the block cache, while the cache is being updated.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId               ID of the medium to be read.
+  @param  Offset                The starting byte offset to read from.
+  @param  BufferSize            The size in bytes of Buffer.
+  @param  Buffer                A pointer to the destination buffer for the data.
+
+  @retval EFI_UNSUPPORTED       The request cannot be served by the cache and
+                                must take the regular path.
+  @retval EFI_SUCCESS           The data was read correctly.
+  @return Others                The status returned by BlockIo ReadBlocks().
+
+**/
+STATIC
+EFI_STATUS
+DiskIoCacheReadBlocks (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  )
+{
+  EFI_STATUS             Status;
+  DISK_IO_CACHE          *Cache;
+  DISK_IO_CACHE_ENTRY    *Entry;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_BLOCK_IO_MEDIA     *Media;
+  EFI_LBA                Lba;
+  EFI_LBA                EndLba;
+  UINT32                 BlockOffset;
+  UINTN                  RunLength;
+  UINTN                  Index;
+  UINTN                  Length;
+
+  Cache = Instance->Cache;
+  if ((Cache == NULL) || (BufferSize == 0) || (Buffer == NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  BlockIo = Instance->BlockIo;
+  Media   = BlockIo->Media;
+  if (Cache->MediaId != Media->MediaId) {
+    DiskIoCacheFlush (Cache);
+    Cache->MediaId = Media->MediaId;
+  }
+
+  //
+  // Leave anything unusual to the regular path so that it reports the error.
+  //
+  if (!Media->MediaPresent || (MediaId != Media->MediaId) ||
+      (Media->BlockSize != Cache->BlockSize) || (Offset + BufferSize < Offset))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Lba    = DivU64x32Remainder (Offset, Cache->BlockSize, &BlockOffset);
+  EndLba = DivU64x32 (Offset + BufferSize - 1, Cache->BlockSize);
+  if ((EndLba > Media->LastBlock) ||
+      (EndLba - Lba >= MIN (DISK_IO_CACHE_MAX_READ_BLOCKS, Cache->EntryCount)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  while (Lba <= EndLba) {
+    Entry = DiskIoCacheFind (Cache, Lba);
+    if (Entry != NULL) {
+      Cache->Hits++;
+      RemoveEntryList (&Entry->LruLink);
+      InsertHeadList (&Cache->LruList, &Entry->LruLink);
+
+      Length = MIN (BufferSize, Cache->BlockSize - BlockOffset);
+      CopyMem (Buffer, Entry->Data + BlockOffset, Length);
+      Buffer     += Length;
+      BufferSize -= Length;
+      BlockOffset = 0;
+      Lba++;
+      continue;
+    }
+
+    //
+    // Coalesce the adjacent missing blocks into one device read.
+    //
+    RunLength = 1;
+    while ((Lba + RunLength <= EndLba) && (DiskIoCacheFind (Cache, Lba + RunLength) == NULL)) {
+      RunLength++;
+    }
+
+    Status = BlockIo->ReadBlocks (BlockIo, MediaId, Lba, RunLength * Cache->BlockSize, Cache->ReadBuffer);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Cache->DeviceReads++;
+    Cache->Misses += RunLength;
+
+    for (Index = 0; Index < RunLength; Index++) {
+      DiskIoCacheInsert (Cache, Lba + Index, Cache->ReadBuffer + Index * Cache->BlockSize);
+
+      Length = MIN (BufferSize, Cache->BlockSize - BlockOffset);
+      CopyMem (Buffer, Cache->ReadBuffer + Index * Cache->BlockSize + BlockOffset, Length);
+      Buffer     += Length;
+      BufferSize -= Length;
+      BlockOffset = 0;
+    }
+
+    Lba += RunLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop the cached blocks overlapping a byte range, while the cache is being
+  updated.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset                The starting byte offset of the write.
+  @param  BufferSize            The size in bytes of the write.
+
+**/
+STATIC
+VOID
+DiskIoCacheDropRange (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  DISK_IO_CACHE        *Cache;
+  DISK_IO_CACHE_ENTRY  *Entry;
+  EFI_LBA              Lba;
+  EFI_LBA              EndLba;
+  UINTN                Index;
+
+  Cache = Instance->Cache;
+  if ((Cache == NULL) || (BufferSize == 0)) {
+    return;
+  }
+
+  if (Offset + BufferSize < Offset) {
+    Cache->Invalidations += Cache->EntryCount;
+    DiskIoCacheFlush (Cache);
+    return;
+  }
+
+  Lba    = DivU64x32 (Offset, Cache->BlockSize);
+  EndLba = DivU64x32 (Offset + BufferSize - 1, Cache->BlockSize);
+  if (EndLba - Lba >= Cache->EntryCount) {
+    //
+    // The write spans more blocks than the cache holds, scan the entries instead.
+    //
+    for (Index = 0; Index < Cache->EntryCount; Index++) {
+      Entry = &Cache->Entries[Index];
+      if (Entry->Valid && (Entry->Lba >= Lba) && (Entry->Lba <= EndLba)) {
+        Cache->Invalidations++;
+        DiskIoCacheDropEntry (Cache, Entry);
+      }
+    }
+
+    return;
+  }
+
+  for ( ; Lba <= EndLba; Lba++) {
+    Entry = DiskIoCacheFind (Cache, Lba);
+    if (Entry != NULL) {
+      Cache->Invalidations++;
+      DiskIoCacheDropEntry (Cache, Entry);
+    }
+  }
+}
+
+/**
+  Read data through the block cache.
+
+  Blocks found in the cache are copied directly. Runs of adjacent missing
+  blocks are coalesced into a single BlockIo read and then inserted into
+  the cache.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  MediaId               ID of the medium to be read.
+  @param  Offset                The starting byte offset to read from.
+  @param  BufferSize            The size in bytes of Buffer.
+  @param  Buffer                A pointer to the destination buffer for the data.
+
+  @retval EFI_UNSUPPORTED       The request cannot be served by the cache and
+                                must take the regular path.
+  @retval EFI_SUCCESS           The data was read correctly.
+  @return Others                The status returned by BlockIo ReadBlocks().
+
+**/
+EFI_STATUS
+DiskIoCacheRead (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT UINT8                 *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Instance->Cache == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  DiskIoCacheBeginUpdate (Instance->Cache);
+  Status = DiskIoCacheReadBlocks (Instance, MediaId, Offset, BufferSize, Buffer);
+  DiskIoCacheEndUpdate (Instance->Cache);
+
+  return Status;
+}
+
+/**
+  Drop the cached blocks overlapping a byte range that is about to be written.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset                The starting byte offset of the write.
+  @param  BufferSize            The size in bytes of the write.
+
+**/
+VOID
+DiskIoCacheInvalidate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  if (Instance->Cache == NULL) {
+    return;
+  }
+
+  DiskIoCacheBeginUpdate (Instance->Cache);
+  DiskIoCacheDropRange (Instance, Offset, BufferSize);
+  DiskIoCacheEndUpdate (Instance->Cache);
+}
+
+/**
+  Drop the cached blocks overlapping a byte range that has been written by a
+  non-blocking request.
+
+  This is called from the completion of the request at TPL_NOTIFY, which may
+  interrupt a read through the cache that took the old content of the blocks
+  from the device. In that case the cache is flushed once the interrupted
+  update is done.
+
+  @param  Instance              Pointer to the DISK_IO_PRIVATE_DATA.
+  @param  Offset                The starting byte offset of the write.
+  @param  BufferSize            The size in bytes of the write.
+
+**/
+VOID
+DiskIoCacheWriteComplete (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Offset,
+  IN UINTN                 BufferSize
+  )
+{
+  if (Instance->Cache == NULL) {
+    return;
+  }
+
+  if (Instance->Cache->Busy) {
+    Instance->Cache->FlushPending = TRUE;
+    return;
+  }
+
+  DiskIoCacheInvalidate (Instance, Offset, BufferSize);
+}
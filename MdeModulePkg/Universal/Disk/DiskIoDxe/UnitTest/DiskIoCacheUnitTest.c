@@ -0,0 +1,455 @@
+/** @file
+  Unit tests of the DiskIo block cache.
+
+  The cache is exercised on top of a RAM disk Block I/O instance that counts
+  the device reads it serves.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../DiskIo.h"
+
+#define UNIT_TEST_APP_NAME     "DiskIo Block Cache Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define RAM_DISK_BLOCK_SIZE   512
+#define RAM_DISK_BLOCK_COUNT  256
+#define CACHE_BLOCK_COUNT     16
+
+UINT8                 mRamDisk[RAM_DISK_BLOCK_SIZE * RAM_DISK_BLOCK_COUNT];
+UINTN                 mDeviceReads;
+EFI_BLOCK_IO_MEDIA    mRamDiskMedia;
+BOOLEAN               mCompleteWriteOnRead;
+DISK_IO_PRIVATE_DATA  mInstance;
+
+/**
+  Read blocks from the RAM disk.
+
+  @param  This       Indicates a pointer to the calling context.
+  @param  MediaId    Id of the media, changes every time the media is replaced.
+  @param  Lba        The starting Logical Block Address to read from.
+  @param  BufferSize Size of Buffer, must be a multiple of device block size.
+  @param  Buffer     A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS           The data was read correctly from the device.
+  @retval EFI_MEDIA_CHANGED     The MediaId does not match the current device.
+  @retval EFI_INVALID_PARAMETER The read request is not valid for the device.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskReadBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This,
+  IN UINT32                 MediaId,
+  IN EFI_LBA                Lba,
+  IN UINTN                  BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  if (MediaId != This->Media->MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if (((BufferSize % RAM_DISK_BLOCK_SIZE) != 0) ||
+      (Lba + BufferSize / RAM_DISK_BLOCK_SIZE > RAM_DISK_BLOCK_COUNT))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mDeviceReads++;
+  CopyMem (Buffer, &mRamDisk[Lba * RAM_DISK_BLOCK_SIZE], BufferSize);
+
+  if (mCompleteWriteOnRead) {
+    //
+    // Emulate a non-blocking write to the same blocks completing at TPL_NOTIFY
+    // after the device returned the old data.
+    //
+    mCompleteWriteOnRead = FALSE;
+    SetMem (&mRamDisk[Lba * RAM_DISK_BLOCK_SIZE], BufferSize, 0x5A);
+    DiskIoCacheWriteComplete (&mInstance, MultU64x32 (Lba, RAM_DISK_BLOCK_SIZE), BufferSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_BLOCK_IO_PROTOCOL  mRamDiskBlockIo = {
+  EFI_BLOCK_IO_PROTOCOL_REVISION,
+  &mRamDiskMedia,
+  NULL,
+  RamDiskReadBlocks,
+  NULL,
+  NULL
+};
+
+/**
+  Fill the RAM disk with a known pattern and create an empty cache.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                 The cache was created.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The cache could not be created.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CacheSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < sizeof (mRamDisk); Index++) {
+    mRamDisk[Index] = (UINT8)(Index ^ (Index / RAM_DISK_BLOCK_SIZE));
+  }
+
+  ZeroMem (&mRamDiskMedia, sizeof (mRamDiskMedia));
+  mRamDiskMedia.MediaId      = 1;
+  mRamDiskMedia.MediaPresent = TRUE;
+  mRamDiskMedia.BlockSize    = RAM_DISK_BLOCK_SIZE;
+  mRamDiskMedia.LastBlock    = RAM_DISK_BLOCK_COUNT - 1;
+
+  ZeroMem (&mInstance, sizeof (mInstance));
+  mInstance.Signature = DISK_IO_PRIVATE_DATA_SIGNATURE;
+  mInstance.BlockIo   = &mRamDiskBlockIo;
+  mDeviceReads         = 0;
+  mCompleteWriteOnRead = FALSE;
+
+  if (EFI_ERROR (DiskIoCacheCreate (&mInstance, CACHE_BLOCK_COUNT)) || (mInstance.Cache == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Destroy the cache created by CacheSetup.
+
+  @param[in]  Context    Unused.
+**/
+VOID
+EFIAPI
+CacheCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  DiskIoCacheDestroy (&mInstance);
+}
+
+/**
+  A repeated unaligned read is served from the cache without touching the device.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RepeatedReadShouldHit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[3 * RAM_DISK_BLOCK_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 100, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, &mRamDisk[100], sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 1);
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 100, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, &mRamDisk[100], sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 1);
+  UT_ASSERT_EQUAL (mInstance.Cache->Hits, 4);
+  UT_ASSERT_EQUAL (mInstance.Cache->Misses, 4);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Adjacent missing blocks around a cached block are read with one device
+  read per run of misses.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AdjacentMissesShouldCoalesce (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[8 * RAM_DISK_BLOCK_SIZE];
+
+  //
+  // Cache block 13, then read blocks 10..17: two runs of misses.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 13 * RAM_DISK_BLOCK_SIZE, 1, Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 10 * RAM_DISK_BLOCK_SIZE, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, &mRamDisk[10 * RAM_DISK_BLOCK_SIZE], sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 3);
+  UT_ASSERT_EQUAL (mInstance.Cache->DeviceReads, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A write drops the cached copies so the next read sees the new data.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WriteShouldInvalidate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[2 * RAM_DISK_BLOCK_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+
+  DiskIoCacheInvalidate (&mInstance, RAM_DISK_BLOCK_SIZE + 7, 1);
+  SetMem (&mRamDisk[RAM_DISK_BLOCK_SIZE], RAM_DISK_BLOCK_SIZE, 0xA5);
+  UT_ASSERT_EQUAL (mInstance.Cache->Invalidations, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, mRamDisk, sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 2);
+  UT_ASSERT_EQUAL (mInstance.Cache->Hits, 1);
+
+  //
+  // A write larger than the cache drops everything it overlaps.
+  //
+  DiskIoCacheInvalidate (&mInstance, 0, (CACHE_BLOCK_COUNT + 1) * RAM_DISK_BLOCK_SIZE);
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A non-blocking write completing in the middle of a cache read does not leave
+  the old data in the cache.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WriteCompletionShouldInvalidate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[RAM_DISK_BLOCK_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+
+  //
+  // Outside of a cache operation the completion drops the written blocks.
+  //
+  SetMem (mRamDisk, RAM_DISK_BLOCK_SIZE, 0xA5);
+  DiskIoCacheWriteComplete (&mInstance, 0, RAM_DISK_BLOCK_SIZE);
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, mRamDisk, sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 2);
+
+  //
+  // During a cache read the completion is deferred to a flush at its end.
+  //
+  mCompleteWriteOnRead = TRUE;
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, RAM_DISK_BLOCK_SIZE, sizeof (Buffer), Buffer));
+  UT_ASSERT_FALSE (mInstance.Cache->Busy);
+  UT_ASSERT_FALSE (mInstance.Cache->FlushPending);
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, RAM_DISK_BLOCK_SIZE, sizeof (Buffer), Buffer));
+  UT_ASSERT_MEM_EQUAL (Buffer, &mRamDisk[RAM_DISK_BLOCK_SIZE], sizeof (Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 4);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The least recently used block is evicted first.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LeastRecentlyUsedShouldBeEvicted (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[RAM_DISK_BLOCK_SIZE];
+  UINTN  Index;
+
+  for (Index = 0; Index < CACHE_BLOCK_COUNT; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, Index * RAM_DISK_BLOCK_SIZE, 1, Buffer));
+  }
+
+  //
+  // Touch block 0 so that block 1 becomes the least recently used one.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, 1, Buffer));
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 200 * RAM_DISK_BLOCK_SIZE, 1, Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, CACHE_BLOCK_COUNT + 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, 1, Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, CACHE_BLOCK_COUNT + 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, RAM_DISK_BLOCK_SIZE, 1, Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, CACHE_BLOCK_COUNT + 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Requests the cache should not serve are handed back to the regular path.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UncacheableReadShouldBeRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[(CACHE_BLOCK_COUNT + 1) * RAM_DISK_BLOCK_SIZE];
+
+  UT_ASSERT_STATUS_EQUAL (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (DiskIoCacheRead (&mInstance, 2, 0, 1, Buffer), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (DiskIoCacheRead (&mInstance, 1, RAM_DISK_BLOCK_COUNT * RAM_DISK_BLOCK_SIZE, 1, Buffer), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (mDeviceReads, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A new media drops every cached block.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The test case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MediaChangeShouldFlush (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[RAM_DISK_BLOCK_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 1, 0, sizeof (Buffer), Buffer));
+  mRamDiskMedia.MediaId = 2;
+  UT_ASSERT_NOT_EFI_ERROR (DiskIoCacheRead (&mInstance, 2, 0, sizeof (Buffer), Buffer));
+  UT_ASSERT_EQUAL (mDeviceReads, 2);
+  UT_ASSERT_EQUAL (mInstance.Cache->Hits, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  DiskIo block cache and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "DiskIo Block Cache Tests", "DiskIo.Cache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DiskIo Block Cache Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (CacheTests, "Repeated read is served from the cache", "Hit", RepeatedReadShouldHit, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Adjacent misses are coalesced", "Coalesce", AdjacentMissesShouldCoalesce, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Write invalidates cached blocks", "Invalidate", WriteShouldInvalidate, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Write completion invalidates cached blocks", "WriteComplete", WriteCompletionShouldInvalidate, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Least recently used block is evicted", "Lru", LeastRecentlyUsedShouldBeEvicted, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Uncacheable read is rejected", "Reject", UncacheableReadShouldBeRejected, CacheSetup, CacheCleanup, NULL);
+  AddTestCase (CacheTests, "Media change flushes the cache", "MediaChange", MediaChangeShouldFlush, CacheSetup, CacheCleanup, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DiskIoCacheUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DiskIoCacheUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
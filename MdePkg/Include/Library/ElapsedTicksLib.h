@@ -0,0 +1,35 @@
+/** @file
+  Provides a service to measure elapsed time with the performance counter.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef ELAPSED_TICKS_LIB_H_
+#define ELAPSED_TICKS_LIB_H_
+
+/**
+  Computes the number of performance counter ticks elapsed since PreviousTick,
+  and updates PreviousTick to the current performance counter value.
+
+  The performance counter may count up or down, as reported by
+  GetPerformanceCounterProperties(), and it may wrap around once between
+  PreviousTick and the current value. The caller must sample the counter often
+  enough that it cannot wrap around more than once in between.
+
+  The ticks can be converted to nanoseconds with GetTimeInNanoSecond().
+
+  @param[in, out]  PreviousTick  On input, a value previously returned by
+                                 GetPerformanceCounter(). On output, the
+                                 current value of the performance counter.
+
+  @return  The number of ticks elapsed since PreviousTick.
+
+**/
+UINT64
+EFIAPI
+GetElapsedTicks (
+  IN OUT UINT64  *PreviousTick
+  );
+
+#endif
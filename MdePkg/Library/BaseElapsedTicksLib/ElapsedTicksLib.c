@@ -0,0 +1,60 @@
+/** @file
+  Measure elapsed time with the performance counter of TimerLib.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/ElapsedTicksLib.h>
+#include <Library/TimerLib.h>
+
+/**
+  Computes the number of performance counter ticks elapsed since PreviousTick,
+  and updates PreviousTick to the current performance counter value.
+
+  The performance counter may count up or down, as reported by
+  GetPerformanceCounterProperties(), and it may wrap around once between
+  PreviousTick and the current value. The caller must sample the counter often
+  enough that it cannot wrap around more than once in between.
+
+  The ticks can be converted to nanoseconds with GetTimeInNanoSecond().
+
+  @param[in, out]  PreviousTick  On input, a value previously returned by
+                                 GetPerformanceCounter(). On output, the
+                                 current value of the performance counter.
+
+  @return  The number of ticks elapsed since PreviousTick.
+
+**/
+UINT64
+EFIAPI
+GetElapsedTicks (
+  IN OUT UINT64  *PreviousTick
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  CurrentTick;
+  UINT64  Delta;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  CurrentTick = GetPerformanceCounter ();
+
+  if (StartValue < EndValue) {
+    if (*PreviousTick > CurrentTick) {
+      Delta = (CurrentTick - StartValue) + (EndValue - *PreviousTick);
+    } else {
+      Delta = CurrentTick - *PreviousTick;
+    }
+  } else {
+    if (*PreviousTick < CurrentTick) {
+      Delta = (StartValue - CurrentTick) + (*PreviousTick - EndValue);
+    } else {
+      Delta = *PreviousTick - CurrentTick;
+    }
+  }
+
+  *PreviousTick = CurrentTick;
+  return Delta;
+}
@@ -402,6 +402,12 @@ DnsUnload (
       FreePool (ItemServerIp6);
     }
 
+    while (!IsListEmpty (&mDriverData->NegativeCacheList)) {
+      DnsRemoveNegativeCache (
+        NET_LIST_USER_STRUCT (mDriverData->NegativeCacheList.ForwardLink, DNS_NEGATIVE_CACHE, AllCacheLink)
+        );
+    }
+
     FreePool (mDriverData);
   }
 
@@ -492,6 +498,7 @@ DnsDriverEntryPoint (
   InitializeListHead (&mDriverData->Dns4ServerList);
   InitializeListHead (&mDriverData->Dns6CacheList);
   InitializeListHead (&mDriverData->Dns6ServerList);
+  InitializeListHead (&mDriverData->NegativeCacheList);
 
   return Status;
 
@@ -39,6 +39,12 @@ struct _DNS_DRIVER_DATA {
 
   LIST_ENTRY    Dns6CacheList;
   LIST_ENTRY    Dns6ServerList;
+
+  LIST_ENTRY    NegativeCacheList;     /// Failed lookups of all DNSv4 and DNSv6 instances.
+
+  UINT32        CacheHits;
+  UINT32        NegativeCacheHits;
+  UINT32        CacheMisses;
 };
 
 struct _DNS_SERVICE {
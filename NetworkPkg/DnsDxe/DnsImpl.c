@@ -942,6 +942,207 @@ UpdateDns6Cache (
   return EFI_SUCCESS;
 }
 
+/**
+  Skip a domain name in a DNS message.
+
+  @param  RxString           The DNS message.
+  @param  Length             The length of the DNS message.
+  @param  Offset             Offset of the domain name in the message.
+
+  @return Offset of the first byte after the domain name, or 0 if the name
+          is malformed or runs past the end of the message.
+
+**/
+UINT32
+DnsSkipName (
+  IN UINT8   *RxString,
+  IN UINT32  Length,
+  IN UINT32  Offset
+  )
+{
+  UINT8  LabelLength;
+
+  while (Offset < Length) {
+    LabelLength = RxString[Offset];
+    if (LabelLength == 0) {
+      return Offset + 1;
+    }
+
+    if ((LabelLength & 0xC0) == 0xC0) {
+      //
+      // A compression pointer ends the name.
+      //
+      return (Offset + 2 <= Length) ? Offset + 2 : 0;
+    }
+
+    Offset += LabelLength + 1;
+  }
+
+  return 0;
+}
+
+/**
+  Get the negative caching time of a failed DNS response.
+
+  As described in RFC 2308, the negative caching time is the minimum of the
+  TTL of the SOA record in the authority section and its MINIMUM field. A
+  response without an SOA record must not be cached.
+
+  @param  RxString           The DNS message, with the header in host byte order.
+  @param  Length             The length of the DNS message.
+  @param  Offset             Offset of the first answer record in the message.
+
+  @return The negative caching time in seconds, capped to DNS_NEGATIVE_CACHE_MAX_TTL,
+          or 0 if the response must not be cached.
+
+**/
+UINT32
+DnsGetNegativeTtl (
+  IN UINT8   *RxString,
+  IN UINT32  Length,
+  IN UINT32  Offset
+  )
+{
+  DNS_HEADER  *DnsHeader;
+  UINT32      RecordNum;
+  UINT32      Index;
+  UINT16      Type;
+  UINT32      Ttl;
+  UINT16      DataLength;
+  UINT32      DataOffset;
+  UINT32      Minimum;
+
+  DnsHeader = (DNS_HEADER *)RxString;
+  RecordNum = DnsHeader->AnswersNum + DnsHeader->AuthorityNum;
+
+  for (Index = 0; Index < RecordNum; Index++) {
+    Offset = DnsSkipName (RxString, Length, Offset);
+    if ((Offset == 0) || (Offset + sizeof (DNS_ANSWER_SECTION) > Length)) {
+      return 0;
+    }
+
+    Type       = NTOHS (ReadUnaligned16 ((UINT16 *)(RxString + Offset)));
+    Ttl        = NTOHL (ReadUnaligned32 ((UINT32 *)(RxString + Offset + 4)));
+    DataLength = NTOHS (ReadUnaligned16 ((UINT16 *)(RxString + Offset + 8)));
+    DataOffset = Offset + sizeof (DNS_ANSWER_SECTION);
+    Offset     = DataOffset + DataLength;
+    if (Offset > Length) {
+      return 0;
+    }
+
+    if ((Index < DnsHeader->AnswersNum) || (Type != DNS_TYPE_SOA)) {
+      continue;
+    }
+
+    //
+    // SOA RDATA: MNAME, RNAME, SERIAL, REFRESH, RETRY, EXPIRE, MINIMUM.
+    //
+    DataOffset = DnsSkipName (RxString, Offset, DataOffset);
+    if (DataOffset != 0) {
+      DataOffset = DnsSkipName (RxString, Offset, DataOffset);
+    }
+
+    if ((DataOffset == 0) || (DataOffset + 5 * sizeof (UINT32) > Offset)) {
+      return 0;
+    }
+
+    Minimum = NTOHL (ReadUnaligned32 ((UINT32 *)(RxString + DataOffset + 4 * sizeof (UINT32))));
+    return MIN (MIN (Ttl, Minimum), DNS_NEGATIVE_CACHE_MAX_TTL);
+  }
+
+  return 0;
+}
+
+/**
+  Find a failed lookup in the negative cache shared by all DNS instances.
+
+  @param  HostName           Host name of the lookup.
+  @param  QueryType          DNS_TYPE_A or DNS_TYPE_AAAA.
+
+  @return The negative cache entry, or NULL if the lookup is not cached.
+
+**/
+DNS_NEGATIVE_CACHE *
+DnsFindNegativeCache (
+  IN CHAR16  *HostName,
+  IN UINT16  QueryType
+  )
+{
+  LIST_ENTRY          *Entry;
+  DNS_NEGATIVE_CACHE  *Item;
+
+  NET_LIST_FOR_EACH (Entry, &mDriverData->NegativeCacheList) {
+    Item = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    if (((Item->QueryType == QueryType) || (Item->QueryType == DNS_TYPE_ANY)) &&
+        (StrCmp (HostName, Item->HostName) == 0))
+    {
+      return Item;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add a failed lookup to the negative cache shared by all DNS instances.
+
+  @param  HostName           Host name of the lookup.
+  @param  QueryType          DNS_TYPE_A or DNS_TYPE_AAAA, or DNS_TYPE_ANY if the
+                             name does not exist at all.
+  @param  Status             The status the lookup completed with.
+  @param  Timeout            Negative caching time in seconds.
+
+**/
+VOID
+DnsAddNegativeCache (
+  IN CHAR16      *HostName,
+  IN UINT16      QueryType,
+  IN EFI_STATUS  Status,
+  IN UINT32      Timeout
+  )
+{
+  DNS_NEGATIVE_CACHE  *Item;
+
+  Item = DnsFindNegativeCache (HostName, QueryType);
+  if ((Item != NULL) && (Item->QueryType == QueryType)) {
+    Item->Status  = Status;
+    Item->Timeout = Timeout;
+    return;
+  }
+
+  Item = AllocateZeroPool (sizeof (DNS_NEGATIVE_CACHE));
+  if (Item == NULL) {
+    return;
+  }
+
+  Item->HostName = AllocateCopyPool (StrSize (HostName), HostName);
+  if (Item->HostName == NULL) {
+    FreePool (Item);
+    return;
+  }
+
+  Item->QueryType = QueryType;
+  Item->Status    = Status;
+  Item->Timeout   = Timeout;
+  InsertTailList (&mDriverData->NegativeCacheList, &Item->AllCacheLink);
+}
+
+/**
+  Remove an entry from the negative cache and free it.
+
+  @param  Item               The negative cache entry.
+
+**/
+VOID
+DnsRemoveNegativeCache (
+  IN DNS_NEGATIVE_CACHE  *Item
+  )
+{
+  RemoveEntryList (&Item->AllCacheLink);
+  FreePool (Item->HostName);
+  FreePool (Item);
+}
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
@@ -1158,10 +1359,13 @@ ParseDnsResponse (
 
   EFI_STATUS  Status;
   UINT32      RemainingLength;
+  UINT32      NegativeTtl;
+  CHAR16      *NegativeHostName;
 
   EFI_TPL  OldTpl;
 
-  Item           = NULL;
+  NegativeHostName = NULL;
+  Item             = NULL;
   Dns4TokenEntry = NULL;
   Dns6TokenEntry = NULL;
 
@@ -1292,6 +1496,31 @@ ParseDnsResponse (
       Status = EFI_DEVICE_ERROR;
     }
 
+    //
+    // Remember a name which does not exist (NXDOMAIN), or which has no address
+    // of the queried type (NODATA), so that later lookups fail without a query.
+    //
+    if ((DnsHeader->Flags.Bits.QR == DNS_FLAGS_QR_RESPONSE) &&
+        ((DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) ||
+         (DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NO_ERROR)))
+    {
+      NegativeTtl = DnsGetNegativeTtl (RxString, Length, (UINT32)((UINT8 *)(QuerySection + 1) - RxString));
+      if ((Dns4TokenEntry != NULL) && !Dns4TokenEntry->GeneralLookUp) {
+        NegativeHostName = Dns4TokenEntry->QueryHostName;
+      } else if ((Dns6TokenEntry != NULL) && !Dns6TokenEntry->GeneralLookUp) {
+        NegativeHostName = Dns6TokenEntry->QueryHostName;
+      }
+
+      if ((NegativeTtl != 0) && (NegativeHostName != NULL)) {
+        DnsAddNegativeCache (
+          NegativeHostName,
+          (DnsHeader->Flags.Bits.RCode == DNS_FLAGS_RCODE_NAME_ERROR) ? DNS_TYPE_ANY : QuerySection->Type,
+          Status,
+          NegativeTtl
+          );
+      }
+    }
+
     goto ON_COMPLETE;
   }
 
@@ -1538,7 +1767,13 @@ ParseDnsResponse (
             Dns4CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
           }
 
-          UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+          //
+          // A zero timeout marks a permanent cache entry, so an answer with a
+          // zero TTL must not be cached at all.
+          //
+          if (Dns4CacheEntry->Timeout != 0) {
+            UpdateDns4Cache (&mDriverData->Dns4CacheList, FALSE, TRUE, *Dns4CacheEntry);
+          }
 
           //
           // Free allocated CacheEntry pool.
@@ -1600,7 +1835,13 @@ ParseDnsResponse (
             Dns6CacheEntry->Timeout = MAX (CNameTtl, AnswerSection->Ttl);
           }
 
-          UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+          //
+          // A zero timeout marks a permanent cache entry, so an answer with a
+          // zero TTL must not be cached at all.
+          //
+          if (Dns6CacheEntry->Timeout != 0) {
+            UpdateDns6Cache (&mDriverData->Dns6CacheList, FALSE, TRUE, *Dns6CacheEntry);
+          }
 
           //
           // Free allocated CacheEntry pool.
@@ -2221,10 +2462,11 @@ DnsOnTimerUpdate (
   IN VOID       *Context
   )
 {
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
-  DNS4_CACHE  *Item4;
-  DNS6_CACHE  *Item6;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
+  DNS4_CACHE          *Item4;
+  DNS6_CACHE          *Item6;
+  DNS_NEGATIVE_CACHE  *ItemNegative;
 
   Item4 = NULL;
   Item6 = NULL;
@@ -2234,20 +2476,19 @@ DnsOnTimerUpdate (
   //
   NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns4CacheList) {
     Item4 = NET_LIST_USER_STRUCT (Entry, DNS4_CACHE, AllCacheLink);
-    Item4->DnsCache.Timeout--;
-  }
+    if (Item4->DnsCache.Timeout == 0) {
+      //
+      // Permanent entry.
+      //
+      continue;
+    }
 
-  Entry = mDriverData->Dns4CacheList.ForwardLink;
-  while (Entry != &mDriverData->Dns4CacheList) {
-    Item4 = NET_LIST_USER_STRUCT (Entry, DNS4_CACHE, AllCacheLink);
+    Item4->DnsCache.Timeout--;
     if (Item4->DnsCache.Timeout == 0) {
       RemoveEntryList (&Item4->AllCacheLink);
       FreePool (Item4->DnsCache.HostName);
       FreePool (Item4->DnsCache.IpAddress);
       FreePool (Item4);
-      Entry = mDriverData->Dns4CacheList.ForwardLink;
-    } else {
-      Entry = Entry->ForwardLink;
     }
   }
 
@@ -2256,20 +2497,30 @@ DnsOnTimerUpdate (
   //
   NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->Dns6CacheList) {
     Item6 = NET_LIST_USER_STRUCT (Entry, DNS6_CACHE, AllCacheLink);
-    Item6->DnsCache.Timeout--;
-  }
+    if (Item6->DnsCache.Timeout == 0) {
+      //
+      // Permanent entry.
+      //
+      continue;
+    }
 
-  Entry = mDriverData->Dns6CacheList.ForwardLink;
-  while (Entry != &mDriverData->Dns6CacheList) {
-    Item6 = NET_LIST_USER_STRUCT (Entry, DNS6_CACHE, AllCacheLink);
+    Item6->DnsCache.Timeout--;
     if (Item6->DnsCache.Timeout == 0) {
       RemoveEntryList (&Item6->AllCacheLink);
       FreePool (Item6->DnsCache.HostName);
       FreePool (Item6->DnsCache.IpAddress);
       FreePool (Item6);
-      Entry = mDriverData->Dns6CacheList.ForwardLink;
-    } else {
-      Entry = Entry->ForwardLink;
+    }
+  }
+
+  //
+  // Iterate through the negative cache list.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &mDriverData->NegativeCacheList) {
+    ItemNegative = NET_LIST_USER_STRUCT (Entry, DNS_NEGATIVE_CACHE, AllCacheLink);
+    ItemNegative->Timeout--;
+    if (ItemNegative->Timeout == 0) {
+      DnsRemoveNegativeCache (ItemNegative);
     }
   }
 }
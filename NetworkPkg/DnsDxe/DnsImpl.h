@@ -83,6 +83,11 @@ extern EFI_DNS6_PROTOCOL             mDns6Protocol;
 
 #define DNS_TIME_TO_GETMAP  5
 
+//
+// Upper bound of the time in seconds a failed lookup is cached (RFC 2308).
+//
+#define DNS_NEGATIVE_CACHE_MAX_TTL  300
+
 #pragma pack(1)
 
 typedef union _DNS_FLAGS DNS_FLAGS;
@@ -97,6 +102,14 @@ typedef struct {
   EFI_DNS6_CACHE_ENTRY    DnsCache;
 } DNS6_CACHE;
 
+typedef struct {
+  LIST_ENTRY    AllCacheLink;
+  CHAR16        *HostName;
+  UINT16        QueryType;
+  EFI_STATUS    Status;
+  UINT32        Timeout;
+} DNS_NEGATIVE_CACHE;
+
 typedef struct {
   LIST_ENTRY          AllServerLink;
   EFI_IPv4_ADDRESS    Dns4ServerIp;
@@ -515,6 +528,90 @@ UpdateDns6Cache (
   IN EFI_DNS6_CACHE_ENTRY  DnsCacheEntry
   );
 
+/**
+  Skip a domain name in a DNS message.
+
+  @param  RxString           The DNS message.
+  @param  Length             The length of the DNS message.
+  @param  Offset             Offset of the domain name in the message.
+
+  @return Offset of the first byte after the domain name, or 0 if the name
+          is malformed or runs past the end of the message.
+
+**/
+UINT32
+DnsSkipName (
+  IN UINT8   *RxString,
+  IN UINT32  Length,
+  IN UINT32  Offset
+  );
+
+/**
+  Get the negative caching time of a failed DNS response.
+
+  As described in RFC 2308, the negative caching time is the minimum of the
+  TTL of the SOA record in the authority section and its MINIMUM field. A
+  response without an SOA record must not be cached.
+
+  @param  RxString           The DNS message, with the header in host byte order.
+  @param  Length             The length of the DNS message.
+  @param  Offset             Offset of the first answer record in the message.
+
+  @return The negative caching time in seconds, capped to DNS_NEGATIVE_CACHE_MAX_TTL,
+          or 0 if the response must not be cached.
+
+**/
+UINT32
+DnsGetNegativeTtl (
+  IN UINT8   *RxString,
+  IN UINT32  Length,
+  IN UINT32  Offset
+  );
+
+/**
+  Find a failed lookup in the negative cache shared by all DNS instances.
+
+  @param  HostName           Host name of the lookup.
+  @param  QueryType          DNS_TYPE_A or DNS_TYPE_AAAA.
+
+  @return The negative cache entry, or NULL if the lookup is not cached.
+
+**/
+DNS_NEGATIVE_CACHE *
+DnsFindNegativeCache (
+  IN CHAR16  *HostName,
+  IN UINT16  QueryType
+  );
+
+/**
+  Add a failed lookup to the negative cache shared by all DNS instances.
+
+  @param  HostName           Host name of the lookup.
+  @param  QueryType          DNS_TYPE_A or DNS_TYPE_AAAA, or DNS_TYPE_ANY if the
+                             name does not exist at all.
+  @param  Status             The status the lookup completed with.
+  @param  Timeout            Negative caching time in seconds.
+
+**/
+VOID
+DnsAddNegativeCache (
+  IN CHAR16      *HostName,
+  IN UINT16      QueryType,
+  IN EFI_STATUS  Status,
+  IN UINT32      Timeout
+  );
+
+/**
+  Remove an entry from the negative cache and free it.
+
+  @param  Item               The negative cache entry.
+
+**/
+VOID
+DnsRemoveNegativeCache (
+  IN DNS_NEGATIVE_CACHE  *Item
+  );
+
 /**
   Add Dns4 ServerIp to common list of addresses of all configured DNSv4 server.
 
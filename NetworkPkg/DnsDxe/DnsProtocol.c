@@ -342,10 +342,11 @@ Dns4HostNameToIp (
 
   EFI_DNS4_CONFIG_DATA  *ConfigData;
 
-  UINTN       Index;
-  DNS4_CACHE  *Item;
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
+  UINTN               Index;
+  DNS4_CACHE          *Item;
+  DNS_NEGATIVE_CACHE  *NegativeItem;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
 
   CHAR8  *QueryName;
 
@@ -440,6 +441,7 @@ Dns4HostNameToIp (
         }
       }
 
+      mDriverData->CacheHits++;
       Token->Status = EFI_SUCCESS;
 
       if (Token->Event != NULL) {
@@ -450,6 +452,35 @@ Dns4HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // Complete the token with the cached failure if the lookup failed recently.
+    // As for a cache hit, the call itself succeeds and the result of the lookup
+    // is only reported in Token->Status.
+    //
+    NegativeItem = DnsFindNegativeCache (HostName, DNS_TYPE_A);
+    if (NegativeItem != NULL) {
+      mDriverData->NegativeCacheHits++;
+      Token->Status = NegativeItem->Status;
+      Status        = EFI_SUCCESS;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      goto ON_EXIT;
+    }
+
+    mDriverData->CacheMisses++;
+    DEBUG ((
+      DEBUG_INFO,
+      "Dns4HostNameToIp: Query %s, cache hits %d, negative hits %d, misses %d\n",
+      HostName,
+      mDriverData->CacheHits,
+      mDriverData->NegativeCacheHits,
+      mDriverData->CacheMisses
+      ));
   }
 
   //
@@ -1188,10 +1219,11 @@ Dns6HostNameToIp (
 
   EFI_DNS6_CONFIG_DATA  *ConfigData;
 
-  UINTN       Index;
-  DNS6_CACHE  *Item;
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Next;
+  UINTN               Index;
+  DNS6_CACHE          *Item;
+  DNS_NEGATIVE_CACHE  *NegativeItem;
+  LIST_ENTRY          *Entry;
+  LIST_ENTRY          *Next;
 
   CHAR8  *QueryName;
 
@@ -1286,6 +1318,7 @@ Dns6HostNameToIp (
         }
       }
 
+      mDriverData->CacheHits++;
       Token->Status = EFI_SUCCESS;
 
       if (Token->Event != NULL) {
@@ -1296,6 +1329,35 @@ Dns6HostNameToIp (
       Status = Token->Status;
       goto ON_EXIT;
     }
+
+    //
+    // Complete the token with the cached failure if the lookup failed recently.
+    // As for a cache hit, the call itself succeeds and the result of the lookup
+    // is only reported in Token->Status.
+    //
+    NegativeItem = DnsFindNegativeCache (HostName, DNS_TYPE_AAAA);
+    if (NegativeItem != NULL) {
+      mDriverData->NegativeCacheHits++;
+      Token->Status = NegativeItem->Status;
+      Status        = EFI_SUCCESS;
+
+      if (Token->Event != NULL) {
+        gBS->SignalEvent (Token->Event);
+        DispatchDpc ();
+      }
+
+      goto ON_EXIT;
+    }
+
+    mDriverData->CacheMisses++;
+    DEBUG ((
+      DEBUG_INFO,
+      "Dns6HostNameToIp: Query %s, cache hits %d, negative hits %d, misses %d\n",
+      HostName,
+      mDriverData->CacheHits,
+      mDriverData->NegativeCacheHits,
+      mDriverData->CacheMisses
+      ));
   }
 
   //
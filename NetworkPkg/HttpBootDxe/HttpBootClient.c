@@ -597,26 +597,28 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HTTP child for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback invoked on HTTP request and response, may be NULL.
+  @param[out]   HttpIo         The HTTP_IO to initialize.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
+STATIC
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback  OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
-  ASSERT (Private != NULL);
-
   //
   // Get HTTP timeout value
   //
@@ -636,13 +638,38 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (
+             Private,
              HttpBootHttpIoCallback,
-             (VOID *)Private,
              &Private->HttpIo
              );
   if (EFI_ERROR (Status)) {
@@ -1617,3 +1644,603 @@ ERROR_1:
 
   return Status;
 }
+
+/**
+  Build the HTTP request headers for a ranged GET of the boot file.
+
+  @param[in]   Private         The pointer to the driver's private data.
+  @param[in]   RangeStart      Offset of the first byte of the range.
+  @param[in]   RangeEnd        Offset of the last byte of the range, inclusive.
+  @param[out]  HttpIoHeader    The created header list. The caller frees it with
+                               HttpIoFreeHeader().
+
+  @retval EFI_SUCCESS          The headers were built.
+  @retval EFI_OUT_OF_RESOURCES Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED      The server requested an unsupported authentication scheme.
+  @retval Others               Failed to set one of the headers.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootBuildRangeRequestHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   RangeStart,
+  IN     UINTN                   RangeEnd,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+  CHAR8           RangeValue[64];
+  UINTN           HeadersCount;
+
+  if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Host, Accept, User-Agent, Range, [Authorization], [If-Match]|[If-Unmodified-Since]
+  //
+  HeadersCount = 4;
+  if (Private->AuthData != NULL) {
+    HeadersCount++;
+  }
+
+  if (Private->LastModifiedOrEtag != NULL) {
+    HeadersCount++;
+  }
+
+  Header = HttpIoCreateHeader (HeadersCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Private->AuthData != NULL) {
+    AsciiSPrint (BaseAuthValue, sizeof (BaseAuthValue), "%a %a", "Basic", Private->AuthData);
+    Status = HttpIoSetHeader (Header, HTTP_HEADER_AUTHORIZATION, BaseAuthValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  AsciiSPrint (RangeValue, sizeof (RangeValue), "bytes=%lu-%lu", (UINT64)RangeStart, (UINT64)RangeEnd);
+  Status = HttpIoSetHeader (Header, "Range", RangeValue);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Make sure every range comes from the same version of the file.
+  //
+  if (Private->LastModifiedOrEtag != NULL) {
+    if (Private->LastModifiedOrEtag[0] == '"') {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_MATCH, Private->LastModifiedOrEtag);
+    } else {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_UNMODIFIED_SINCE, Private->LastModifiedOrEtag);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Check that the response of a ranged GET carries exactly the requested range.
+
+  @param[in]  Private          The pointer to the driver's private data.
+  @param[in]  Connection       The connection that received the response.
+  @param[in]  ResponseData     The received response header.
+
+  @retval EFI_SUCCESS          The server returned the requested range.
+  @retval EFI_UNSUPPORTED      The server ignored the range or returned a different one.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootCheckRangeResponse (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN     HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     HTTP_IO_RESPONSE_DATA       *ResponseData
+  )
+{
+  EFI_HTTP_HEADER  *HttpHeader;
+  CHAR8            *Value;
+  UINTN            ContentLength;
+
+  if (ResponseData->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The body is received raw into the caller's buffer, so it has to be in
+  // identity transfer-coding with the exact length of the range.
+  //
+  if (EFI_ERROR (HttpIoGetContentLength (ResponseData->HeaderCount, ResponseData->Headers, &ContentLength)) ||
+      (ContentLength != Connection->RangeLength))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Content-Range: bytes <range-start>-<range-end>/<size>
+  //
+  HttpHeader = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((HttpHeader == NULL) || (AsciiStrnCmp (HttpHeader->FieldValue, "bytes ", 6) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = HttpHeader->FieldValue + 6;
+  if (AsciiStrDecimalToUintn (Value) != Connection->RangeStart) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = AsciiStrStr (Value, "/");
+  if ((Value == NULL) || (AsciiStrDecimalToUintn (Value + 1) != Private->BootFileSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue an asynchronous receive for the rest of a connection's range. The data
+  lands directly at its final position in the caller's buffer.
+
+  @param[in]  Connection       The connection to receive on.
+  @param[in]  Buffer           The boot file buffer.
+
+  @retval EFI_SUCCESS          The response token is queued.
+  @retval Others               Failed to queue the response token.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootQueueRangeReceive (
+  IN     HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+
+  HttpIo = &Connection->HttpIo;
+
+  HttpIo->RspToken.Status                 = EFI_NOT_READY;
+  HttpIo->RspToken.Message->Data.Response = NULL;
+  HttpIo->RspToken.Message->HeaderCount   = 0;
+  HttpIo->RspToken.Message->Headers       = NULL;
+  HttpIo->RspToken.Message->BodyLength    = Connection->RangeLength - Connection->ReceivedSize;
+  HttpIo->RspToken.Message->Body          = Buffer + Connection->RangeStart + Connection->ReceivedSize;
+  HttpIo->IsRxDone                        = FALSE;
+
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    return Status;
+  }
+
+  Connection->RxPending = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Add the time elapsed since the last update to every range that is still
+  being received. This is done often enough that the performance counter
+  cannot wrap around more than once in between.
+
+  @param[in, out]  Connections     The range connections.
+  @param[in]       ConnectionCount The number of range connections.
+
+**/
+STATIC
+VOID
+HttpBootUpdateRangeTimes (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connections,
+  IN     UINTN                       ConnectionCount
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    if (Connections[Index].ReceivedSize < Connections[Index].RangeLength) {
+      Connections[Index].ElapsedTicks += GetElapsedTicks (&Connections[Index].LastTick);
+    }
+  }
+}
+
+/**
+  Report the contiguous data received since the last call through the
+  HttpBootHttpEntityBody callback, so that the callback sees the file in
+  order whatever order the ranges complete in.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Connections     The range connections, in file order.
+  @param[in]       ConnectionCount The number of range connections.
+  @param[in]       Buffer          The boot file buffer.
+  @param[in, out]  DeliverIndex    The connection holding the first byte not reported yet.
+  @param[in, out]  DeliveredSize   The number of bytes reported so far.
+
+  @retval EFI_SUCCESS              The data is reported, or there is no callback.
+  @retval Others                   The status returned by the callback.
+
+**/
+STATIC
+EFI_STATUS
+HttpBootDeliverRangeData (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN     HTTP_BOOT_RANGE_CONNECTION  *Connections,
+  IN     UINTN                       ConnectionCount,
+  IN     UINT8                       *Buffer,
+  IN OUT UINTN                       *DeliverIndex,
+  IN OUT UINTN                       *DeliveredSize
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  UINTN                       Length;
+
+  if (Private->HttpBootCallback == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  while (*DeliverIndex < ConnectionCount) {
+    Connection = &Connections[*DeliverIndex];
+    Length     = Connection->RangeStart + Connection->ReceivedSize - *DeliveredSize;
+    while (Length > 0) {
+      Status = Private->HttpBootCallback->Callback (
+                                            Private->HttpBootCallback,
+                                            HttpBootHttpEntityBody,
+                                            TRUE,
+                                            (UINT32)MIN (Length, MAX_UINT32),
+                                            Buffer + *DeliveredSize
+                                            );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      *DeliveredSize += MIN (Length, MAX_UINT32);
+      Length         -= MIN (Length, MAX_UINT32);
+    }
+
+    if (Connection->ReceivedSize < Connection->RangeLength) {
+      break;
+    }
+
+    (*DeliverIndex)++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file over several HTTP connections in parallel.
+
+  The file is split into PcdHttpBootParallelConnections byte ranges, each range is
+  requested on its own HTTP child and received directly into its slice of Buffer
+  as the data arrives. The file size must already be known from a previous HEAD
+  request, and the server must answer every ranged GET with 206 Partial Content.
+  The HttpBootHttpEntityBody callbacks are still delivered in file order.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+  @param[out]      Aborted         Set to TRUE if the HttpBootHttpEntityBody callback aborted
+                                   the download. The returned status is then the one of the
+                                   callback, and the download must not be retried.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled or not applicable to this
+                                   file, or the server does not honor range requests. The
+                                   caller should use HttpBootGetBootFile() instead.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_TIMEOUT              One of the connections timed out.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileParallel (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType,
+  OUT BOOLEAN                    *Aborted
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CONNECTION  *Connections;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  HTTP_IO                     *HttpIo;
+  HTTP_IO_RESPONSE_DATA       ResponseData;
+  EFI_HTTP_REQUEST_DATA       RequestData;
+  UINTN                       ConnectionCount;
+  UINTN                       ActiveCount;
+  UINTN                       Index;
+  UINTN                       RangeSize;
+  UINTN                       UrlSize;
+  CHAR16                      *Url;
+  UINT64                      ElapsedUs;
+  UINTN                       DeliverIndex;
+  UINTN                       DeliveredSize;
+
+  ASSERT (Private != NULL);
+  ASSERT (Private->HttpCreated);
+
+  if ((BufferSize == NULL) || (Buffer == NULL) || (ImageType == NULL) || (Aborted == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *Aborted = FALSE;
+
+  ConnectionCount = MIN (PcdGet32 (PcdHttpBootParallelConnections), HTTP_BOOT_MAX_PARALLEL_CONNECTIONS);
+
+  //
+  // Only a file whose size is known from the HEAD request can be split. A file
+  // that was already fetched by GET (e.g. chunked transfer-coding) sits in the
+  // cache list, and an interrupted download is resumed on the single connection.
+  //
+  if ((Private->BootFileSize == 0) ||
+      (*BufferSize < Private->BootFileSize) ||
+      (Private->PartialTransferredSize != 0) ||
+      !IsListEmpty (&Private->CacheList))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  ConnectionCount = MIN (ConnectionCount, Private->BootFileSize / HTTP_BOOT_PARALLEL_MIN_RANGE_SIZE);
+  if (ConnectionCount < 2) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Connections = AllocateZeroPool (ConnectionCount * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  if (Connections == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    FreePool (Connections);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  //
+  // 1. Split the file into ranges and send a ranged GET on a new HTTP child for each.
+  //    All requests go out before any response is read so the server works on them
+  //    concurrently.
+  //
+  RangeSize = Private->BootFileSize / ConnectionCount;
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection              = &Connections[Index];
+    Connection->RangeStart  = Index * RangeSize;
+    Connection->RangeLength = (Index == ConnectionCount - 1) ?
+                              Private->BootFileSize - Connection->RangeStart :
+                              RangeSize;
+
+    //
+    // The ranged responses must not be reported through HttpBootHttpIoCallback(),
+    // their Content-Length would reset the progress of the whole file.
+    //
+    Status = HttpBootCreateHttpIoInstance (Private, NULL, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Connection->HttpCreated = TRUE;
+
+    Status = HttpBootBuildRangeRequestHeader (
+               Private,
+               Connection->RangeStart,
+               Connection->RangeStart + Connection->RangeLength - 1,
+               &Connection->HttpIoHeader
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Connection->LastTick = GetPerformanceCounter ();
+    Status               = HttpIoSendRequest (
+                              &Connection->HttpIo,
+                              &RequestData,
+                              Connection->HttpIoHeader->HeaderCount,
+                              Connection->HttpIoHeader->Headers,
+                              0,
+                              NULL
+                              );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // 2. Receive the response headers and make sure each server reply carries
+  //    exactly the requested range.
+  //
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    ZeroMem (&ResponseData, sizeof (ResponseData));
+    Status = HttpIoRecvResponse (&Connection->HttpIo, TRUE, &ResponseData);
+    HttpBootUpdateRangeTimes (Connections, ConnectionCount);
+    if (!EFI_ERROR (Status) && EFI_ERROR (ResponseData.Status)) {
+      Status = ResponseData.Status;
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Status = HttpBootCheckRangeResponse (Private, Connection, &ResponseData);
+    }
+
+    if (ResponseData.Headers != NULL) {
+      HttpFreeHeaderFields (ResponseData.Headers, ResponseData.HeaderCount);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // 3. Keep one response token queued on every connection and poll them in turn,
+  //    so that the ranges are received concurrently in whatever order the data
+  //    arrives. The callback is given the data in file order as soon as it is
+  //    contiguous.
+  //
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Status = HttpBootQueueRangeReceive (&Connections[Index], Buffer);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  DeliverIndex  = 0;
+  DeliveredSize = 0;
+  ActiveCount   = ConnectionCount;
+  while (ActiveCount > 0) {
+    HttpBootUpdateRangeTimes (Connections, ConnectionCount);
+    for (Index = 0; Index < ConnectionCount; Index++) {
+      Connection = &Connections[Index];
+      if (!Connection->RxPending) {
+        continue;
+      }
+
+      HttpIo = &Connection->HttpIo;
+      HttpIo->Http->Poll (HttpIo->Http);
+
+      if (!HttpIo->IsRxDone) {
+        if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+          Status = EFI_TIMEOUT;
+          goto ON_EXIT;
+        }
+
+        continue;
+      }
+
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+      Connection->RxPending = FALSE;
+      HttpIo->IsRxDone      = FALSE;
+
+      Status = HttpIo->RspToken.Status;
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      Connection->ElapsedTicks += GetElapsedTicks (&Connection->LastTick);
+      Connection->ReceivedSize += HttpIo->RspToken.Message->BodyLength;
+
+      Status = HttpBootDeliverRangeData (Private, Connections, ConnectionCount, Buffer, &DeliverIndex, &DeliveredSize);
+      if (EFI_ERROR (Status)) {
+        //
+        // The callback asked to stop, end the download with its status.
+        //
+        *Aborted = TRUE;
+        goto ON_EXIT;
+      }
+
+      if (Connection->ReceivedSize < Connection->RangeLength) {
+        Status = HttpBootQueueRangeReceive (Connection, Buffer);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+      } else {
+        ActiveCount--;
+      }
+    }
+  }
+
+  //
+  // 4. Report the throughput of every connection.
+  //
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    ElapsedUs  = DivU64x32 (GetTimeInNanoSecond (Connection->ElapsedTicks), 1000);
+    DEBUG ((
+      DEBUG_INFO,
+      "HttpBootGetBootFileParallel: Connection %u range %lu-%lu: %lu bytes in %lu ms, %lu KB/s\n",
+      (UINT32)Index,
+      (UINT64)Connection->RangeStart,
+      (UINT64)(Connection->RangeStart + Connection->RangeLength - 1),
+      (UINT64)Connection->ReceivedSize,
+      DivU64x32 (ElapsedUs, 1000),
+      (ElapsedUs == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Connection->ReceivedSize, 1000), ElapsedUs, NULL)
+      ));
+  }
+
+  *BufferSize = Private->BootFileSize;
+  *ImageType  = Private->ImageType;
+  Status      = EFI_SUCCESS;
+
+ON_EXIT:
+  for (Index = 0; Index < ConnectionCount; Index++) {
+    Connection = &Connections[Index];
+    if (Connection->RxPending) {
+      gBS->SetTimer (Connection->HttpIo.TimeoutEvent, TimerCancel, 0);
+      Connection->HttpIo.Http->Cancel (Connection->HttpIo.Http, &Connection->HttpIo.RspToken);
+    }
+
+    if (Connection->HttpIoHeader != NULL) {
+      HttpIoFreeHeader (Connection->HttpIoHeader);
+    }
+
+    if (Connection->HttpCreated) {
+      HttpIoDestroyIo (&Connection->HttpIo);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    //
+    // The single connection download restarts from the beginning, so restart
+    // the progress report too.
+    //
+    Private->ReceivedSize = 0;
+    Private->Percentage   = 0;
+  }
+
+  FreePool (Connections);
+  FreePool (Url);
+  return Status;
+}
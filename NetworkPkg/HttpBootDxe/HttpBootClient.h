@@ -14,6 +14,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT          "UefiHttpBoot/1.0"
 #define HTTP_BOOT_AUTHENTICATION_INFO_MAX_LEN  255
 
+//
+// Upper bound of concurrent HTTP children used by a ranged download, and the
+// smallest slice of the boot file worth opening an extra connection for.
+//
+#define HTTP_BOOT_MAX_PARALLEL_CONNECTIONS  8
+#define HTTP_BOOT_PARALLEL_MIN_RANGE_SIZE   SIZE_1MB
+
 //
 // Record the data length and start address of a data block.
 //
@@ -58,6 +65,21 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// One HTTP child downloading a byte range of the boot file.
+//
+typedef struct {
+  HTTP_IO           HttpIo;
+  BOOLEAN           HttpCreated;
+  HTTP_IO_HEADER    *HttpIoHeader;
+  UINTN             RangeStart;
+  UINTN             RangeLength;
+  UINTN             ReceivedSize;
+  BOOLEAN           RxPending;                // A response token is queued to HttpIo.
+  UINT64            LastTick;                 // Performance counter when ElapsedTicks was last updated.
+  UINT64            ElapsedTicks;             // Performance counter ticks since the request was sent.
+} HTTP_BOOT_RANGE_CONNECTION;
+
 /**
   Discover all the boot information for boot file.
 
@@ -121,6 +143,42 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  Download the boot file over several HTTP connections in parallel.
+
+  The file is split into PcdHttpBootParallelConnections byte ranges, each range is
+  requested on its own HTTP child and received directly into its slice of Buffer
+  as the data arrives. The file size must already be known from a previous HEAD
+  request, and the server must answer every ranged GET with 206 Partial Content.
+  The HttpBootHttpEntityBody callbacks are still delivered in file order.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to Buffer.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+  @param[out]      Aborted         Set to TRUE if the HttpBootHttpEntityBody callback aborted
+                                   the download. The returned status is then the one of the
+                                   callback, and the download must not be retried.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled or not applicable to this
+                                   file, or the server does not honor range requests. The
+                                   caller should use HttpBootGetBootFile() instead.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_TIMEOUT              One of the connections timed out.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileParallel (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType,
+  OUT BOOLEAN                    *Aborted
+  );
+
 /**
   Clean up all cached data.
 
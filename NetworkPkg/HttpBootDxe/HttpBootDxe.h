@@ -32,6 +32,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HiiLib.h>
 #include <Library/PrintLib.h>
 #include <Library/DpcLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 //
 // UEFI Driver Model Protocols
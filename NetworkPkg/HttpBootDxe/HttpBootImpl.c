@@ -313,6 +313,7 @@ HttpBootGetBootFileCaller (
   HTTP_GET_BOOT_FILE_STATE  State;
   EFI_STATUS                Status;
   UINT32                    Retries;
+  BOOLEAN                   Aborted;
 
   if (Private->BootFileSize == 0) {
     State = GetBootFileHead;
@@ -376,6 +377,20 @@ HttpBootGetBootFileCaller (
           return Status;
         }
 
+        //
+        // Try to load the boot file over several connections in parallel first,
+        // any failure falls back to the single connection download below, unless
+        // the download was aborted by the HTTP boot callback.
+        //
+        Status = HttpBootGetBootFileParallel (Private, BufferSize, Buffer, ImageType, &Aborted);
+        if (!EFI_ERROR (Status) || Aborted) {
+          return Status;
+        }
+
+        if (Status != EFI_UNSUPPORTED) {
+          DEBUG ((DEBUG_WARN, "HttpBootGetBootFileCaller: Parallel download failed - %r, retry with one connection.\n", Status));
+        }
+
         //
         // Load the boot file into Buffer
         //
@@ -0,0 +1,474 @@
+/** @file
+  Tests for the HTTPS receive path of HttpImpl.c.
+
+  The TLS layer is replaced by a queue of decrypted records, so that a test
+  controls exactly which bytes each HttpsReceive() call returns.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <GoogleTest/Library/MockUefiBootServicesTableLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../HttpDriver.h"
+
+  EFI_STATUS
+  EFIAPI
+  HttpBodyParserCallback (
+    IN HTTP_BODY_PARSE_EVENT  EventType,
+    IN CHAR8                  *Data,
+    IN UINTN                  Length,
+    IN VOID                   *Context
+    );
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_MAX_RECORDS  4
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+//
+// Decrypted TLS records returned by HttpsReceive(), in order.
+//
+static CONST CHAR8  *mRecords[TEST_MAX_RECORDS];
+static UINTN        mRecordLengths[TEST_MAX_RECORDS];
+static UINTN        mRecordCount;
+static UINTN        mRecordIndex;
+
+extern "C" {
+  EFI_HTTP_UTILITIES_PROTOCOL  *mHttpUtilities;
+
+  EFI_STATUS
+  EFIAPI
+  HttpsReceive (
+    IN     HTTP_PROTOCOL  *HttpInstance,
+    IN OUT NET_FRAGMENT   *Fragment,
+    OUT    UINT8          **Buffer,
+    IN     EFI_EVENT      Timeout
+    )
+  {
+    *Buffer = NULL;
+    if (mRecordIndex >= mRecordCount) {
+      return EFI_TIMEOUT;
+    }
+
+    //
+    // Like the real HttpsReceive(), return the payload behind the record
+    // header of the buffer it was received in.
+    //
+    *Buffer = (UINT8 *)AllocateZeroPool (TLS_RECORD_HEADER_LENGTH + mRecordLengths[mRecordIndex]);
+    if (*Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Fragment->Len  = (UINT32)mRecordLengths[mRecordIndex];
+    Fragment->Bulk = *Buffer + TLS_RECORD_HEADER_LENGTH;
+    CopyMem (Fragment->Bulk, mRecords[mRecordIndex], Fragment->Len);
+    mRecordIndex++;
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  HttpTcpReceiveHeader (
+    IN  HTTP_PROTOCOL  *HttpInstance,
+    IN  OUT UINTN      *SizeofHeaders,
+    IN  OUT UINTN      *BufferSize,
+    IN  EFI_EVENT      Timeout
+    )
+  {
+    //
+    // The tests only cover headers that are already complete in the cache,
+    // so only the tail of the real routine is needed here.
+    //
+    if (*HttpInstance->EndofHeader == NULL) {
+      return EFI_TIMEOUT;
+    }
+
+    *HttpInstance->EndofHeader = *HttpInstance->EndofHeader + AsciiStrLen (HTTP_END_OF_HDR_STR);
+    *SizeofHeaders             = *HttpInstance->EndofHeader - *HttpInstance->HttpHeaders;
+    return EFI_SUCCESS;
+  }
+
+  VOID
+  HttpCloseTcpRxEvent (
+    IN  HTTP_TOKEN_WRAP  *Wrap
+    )
+  {
+  }
+
+  VOID
+  HttpTcpTokenCleanup (
+    IN  HTTP_TOKEN_WRAP  *Wrap
+    )
+  {
+    FreePool (Wrap);
+  }
+
+  EFI_STATUS
+  HttpTcpReceiveBody (
+    IN  HTTP_TOKEN_WRAP   *Wrap,
+    IN  EFI_HTTP_MESSAGE  *HttpMsg
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  VOID
+  HttpCleanProtocol (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+  }
+
+  EFI_STATUS
+  HttpCloseConnection (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  VOID
+  HttpCloseTcpConnCloseEvent (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+  }
+
+  EFI_STATUS
+  HttpCreateTcpRxEvent (
+    IN  HTTP_TOKEN_WRAP  *Wrap
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  HttpCreateTcpTxEvent (
+    IN  HTTP_TOKEN_WRAP  *Wrap
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  HttpDns4 (
+    IN     HTTP_PROTOCOL  *HttpInstance,
+    IN     CHAR16         *HostName,
+    OUT EFI_IPv4_ADDRESS  *IpAddress
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  HttpDns6 (
+    IN     HTTP_PROTOCOL  *HttpInstance,
+    IN     CHAR16         *HostName,
+    OUT EFI_IPv6_ADDRESS  *IpAddress
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  HttpInitProtocol (
+    IN OUT HTTP_PROTOCOL  *HttpInstance,
+    IN     BOOLEAN        IpVersion
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  HttpInitSession (
+    IN  HTTP_PROTOCOL    *HttpInstance,
+    IN  HTTP_TOKEN_WRAP  *Wrap,
+    IN  BOOLEAN          Configure,
+    IN  BOOLEAN          TlsConfigure
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  VOID
+  HttpNotify (
+    IN  EDKII_HTTP_CALLBACK_EVENT  Event,
+    IN  EFI_STATUS                 EventStatus
+    )
+  {
+  }
+
+  EFI_STATUS
+  EFIAPI
+  HttpTcpNotReady (
+    IN NET_MAP       *Map,
+    IN NET_MAP_ITEM  *Item,
+    IN VOID          *Context
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  HttpTokenExist (
+    IN NET_MAP       *Map,
+    IN NET_MAP_ITEM  *Item,
+    IN VOID          *Context
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  HttpTransmitTcp (
+    IN  HTTP_PROTOCOL    *HttpInstance,
+    IN  HTTP_TOKEN_WRAP  *Wrap,
+    IN  UINT8            *TxString,
+    IN  UINTN            TxStringLen
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  BOOLEAN
+  IsHttpsUrl (
+    IN CHAR8  *Url
+    )
+  {
+    return TRUE;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  TlsCloseSession (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  VOID
+  EFIAPI
+  TlsCloseTxRxEvent (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+  }
+
+  EFI_STATUS
+  EFIAPI
+  TlsCreateChild (
+    IN  HTTP_PROTOCOL  *HttpInstance
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  DispatchDpc (
+    VOID
+    )
+  {
+    return EFI_SUCCESS;
+  }
+}
+
+static
+EFI_STATUS
+EFIAPI
+FakeSetTimer (
+  IN EFI_EVENT        Event,
+  IN EFI_TIMER_DELAY  Type,
+  IN UINT64           TriggerTime
+  )
+{
+  return EFI_SUCCESS;
+}
+
+static
+EFI_STATUS
+EFIAPI
+FakeSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  return EFI_SUCCESS;
+}
+
+//
+// The tests only check the status line, so the header fields are dropped.
+//
+static
+EFI_STATUS
+EFIAPI
+FakeParse (
+  IN  EFI_HTTP_UTILITIES_PROTOCOL  *This,
+  IN  CHAR8                        *HttpMessage,
+  IN  UINTN                        HttpMessageSize,
+  OUT EFI_HTTP_HEADER              **HeaderFields,
+  OUT UINTN                        *FieldCount
+  )
+{
+  *HeaderFields = NULL;
+  *FieldCount   = 0;
+  return EFI_SUCCESS;
+}
+
+static EFI_HTTP_UTILITIES_PROTOCOL  mFakeHttpUtilities = {
+  NULL,
+  FakeParse
+};
+
+////////////////////////////////////////////////////////////////////////
+// HttpResponseWorker Tests
+////////////////////////////////////////////////////////////////////////
+
+class HttpsResponseTest : public ::testing::Test {
+protected:
+  HTTP_PROTOCOL           HttpInstance;
+  EFI_HTTP_TOKEN          Token;
+  EFI_HTTP_MESSAGE        Message;
+  EFI_HTTP_RESPONSE_DATA  ResponseData;
+  EFI_HTTP_HEADER         ContentLength;
+
+  void
+  SetUp (
+    ) override
+  {
+    gBS->SetTimer    = FakeSetTimer;
+    gBS->SignalEvent = FakeSignalEvent;
+    mHttpUtilities   = &mFakeHttpUtilities;
+
+    ZeroMem (&HttpInstance, sizeof (HttpInstance));
+    HttpInstance.Signature    = HTTP_PROTOCOL_SIGNATURE;
+    HttpInstance.UseHttps     = TRUE;
+    HttpInstance.Method       = HttpMethodGet;
+    HttpInstance.TimeoutEvent = (EFI_EVENT)&HttpInstance;
+    NetMapInit (&HttpInstance.TxTokens);
+    NetMapInit (&HttpInstance.RxTokens);
+
+    ZeroMem (&Token, sizeof (Token));
+    ZeroMem (&Message, sizeof (Message));
+    ZeroMem (&ResponseData, sizeof (ResponseData));
+    Token.Message = &Message;
+
+    mRecordCount = 0;
+    mRecordIndex = 0;
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    if (HttpInstance.MsgParser != NULL) {
+      HttpFreeMsgParser (HttpInstance.MsgParser);
+    }
+
+    if (HttpInstance.CacheBody != NULL) {
+      FreePool (HttpInstance.CacheBody);
+    }
+
+    if (Message.Headers != NULL) {
+      FreePool (Message.Headers);
+    }
+  }
+
+  void
+  QueueRecord (
+    CONST CHAR8  *Record
+    )
+  {
+    ASSERT_LT (mRecordCount, (UINTN)TEST_MAX_RECORDS);
+    mRecords[mRecordCount]       = Record;
+    mRecordLengths[mRecordCount] = AsciiStrLen (Record);
+    mRecordCount++;
+  }
+
+  //
+  // Pretend the headers of a response with a body of BodyLength bytes have
+  // been received, as the previous Response() call would have left it.
+  //
+  void
+  ExpectBody (
+    CONST CHAR8  *BodyLength
+    )
+  {
+    ContentLength.FieldName  = (CHAR8 *)HTTP_HEADER_CONTENT_LENGTH;
+    ContentLength.FieldValue = (CHAR8 *)BodyLength;
+    ASSERT_EQ (
+      HttpInitMsgParser (
+        HttpMethodGet,
+        HTTP_STATUS_200_OK,
+        1,
+        &ContentLength,
+        HttpBodyParserCallback,
+        &HttpInstance.CallbackData,
+        &HttpInstance.MsgParser
+        ),
+      EFI_SUCCESS
+      );
+  }
+
+  EFI_STATUS
+  Response (
+    VOID
+    )
+  {
+    HTTP_TOKEN_WRAP  *Wrap;
+
+    Wrap = (HTTP_TOKEN_WRAP *)AllocateZeroPool (sizeof (HTTP_TOKEN_WRAP));
+    if (Wrap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Wrap->HttpInstance = &HttpInstance;
+    Wrap->HttpToken    = &Token;
+    return HttpResponseWorker (Wrap);
+  }
+};
+
+//
+// One TLS record carries the tail of a body and the complete header of the
+// next response, followed by a few more bytes. The next Response() call must
+// take the header from the cache, and cache only the bytes that follow it.
+//
+TEST_F (HttpsResponseTest, RecordWithBodyTailAndNextHeader) {
+  CHAR8  Body[32];
+
+  ExpectBody ("5");
+  QueueRecord ("tail!HTTP/1.1 204 No Content\r\nServer: test\r\n\r\nXYZ");
+
+  Message.Body       = Body;
+  Message.BodyLength = sizeof (Body);
+  ASSERT_EQ (Response (), EFI_SUCCESS);
+  EXPECT_EQ (Message.BodyLength, (UINTN)5);
+  EXPECT_EQ (CompareMem (Body, "tail!", 5), 0);
+  EXPECT_EQ (HttpInstance.MsgParser, (VOID *)NULL);
+  ASSERT_NE (HttpInstance.CacheBody, (CHAR8 *)NULL);
+  EXPECT_EQ (HttpInstance.CacheOffset, (UINTN)(TLS_RECORD_HEADER_LENGTH + 5));
+  EXPECT_EQ (HttpInstance.NextMsg, HttpInstance.CacheBody + HttpInstance.CacheOffset);
+
+  Message.Data.Response = &ResponseData;
+  Message.Body          = NULL;
+  Message.BodyLength    = 0;
+  ASSERT_EQ (Response (), EFI_SUCCESS);
+  EXPECT_EQ (ResponseData.StatusCode, HTTP_STATUS_204_NO_CONTENT);
+  EXPECT_EQ (mRecordIndex, (UINTN)1);
+  ASSERT_NE (HttpInstance.CacheBody, (CHAR8 *)NULL);
+  EXPECT_EQ (HttpInstance.CacheLen, (UINTN)3);
+  EXPECT_EQ (CompareMem (HttpInstance.CacheBody, "XYZ", 3), 0);
+}
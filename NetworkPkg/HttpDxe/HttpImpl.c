@@ -967,25 +967,28 @@ HttpResponseWorker (
   IN  HTTP_TOKEN_WRAP  *Wrap
   )
 {
-  EFI_STATUS        Status;
-  EFI_HTTP_MESSAGE  *HttpMsg;
-  CHAR8             *EndofHeader;
-  CHAR8             *HttpHeaders;
-  UINTN             SizeofHeaders;
-  UINTN             BufferSize;
-  UINTN             StatusCode;
-  CHAR8             *Tmp;
-  CHAR8             *HeaderTmp;
-  CHAR8             *StatusCodeStr;
-  UINTN             BodyLen;
-  HTTP_PROTOCOL     *HttpInstance;
-  EFI_HTTP_TOKEN    *Token;
-  NET_MAP_ITEM      *Item;
-  HTTP_TOKEN_WRAP   *ValueInItem;
-  UINTN             HdrLen;
-  NET_FRAGMENT      Fragment;
-  UINT32            TimeoutValue;
-  UINTN             Index;
+  EFI_STATUS           Status;
+  EFI_HTTP_MESSAGE     *HttpMsg;
+  CHAR8                *EndofHeader;
+  CHAR8                *HttpHeaders;
+  UINTN                SizeofHeaders;
+  UINTN                BufferSize;
+  UINTN                StatusCode;
+  CHAR8                *Tmp;
+  CHAR8                *HeaderTmp;
+  CHAR8                *StatusCodeStr;
+  UINTN                BodyLen;
+  HTTP_PROTOCOL        *HttpInstance;
+  EFI_HTTP_TOKEN       *Token;
+  NET_MAP_ITEM         *Item;
+  HTTP_TOKEN_WRAP      *ValueInItem;
+  UINTN                HdrLen;
+  NET_FRAGMENT         Fragment;
+  UINT8                *FragmentBuffer;
+  UINT32               TimeoutValue;
+  UINTN                Index;
+  HTTP_HEADER_SCANNER  HeaderScanner;
+  UINTN                HeaderLength;
 
   if ((Wrap == NULL) || (Wrap->HttpInstance == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1005,6 +1008,7 @@ HttpResponseWorker (
   ValueInItem               = NULL;
   Fragment.Len              = 0;
   Fragment.Bulk             = NULL;
+  FragmentBuffer            = NULL;
 
   if (HttpMsg->Data.Response != NULL) {
     //
@@ -1015,7 +1019,7 @@ HttpResponseWorker (
       // The data is stored at [NextMsg, CacheBody + CacheLen].
       //
       HdrLen      = HttpInstance->CacheBody + HttpInstance->CacheLen - HttpInstance->NextMsg;
-      HttpHeaders = AllocateZeroPool (HdrLen);
+      HttpHeaders = AllocateZeroPool (HdrLen + 1);
       if (HttpHeaders == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
         goto Error;
@@ -1027,12 +1031,15 @@ HttpResponseWorker (
       HttpInstance->NextMsg     = NULL;
       HttpInstance->CacheOffset = 0;
       SizeofHeaders             = HdrLen;
-      BufferSize                = HttpInstance->CacheLen;
+      BufferSize                = HdrLen;
 
       //
       // Check whether we cached the whole HTTP headers.
       //
-      EndofHeader = AsciiStrStr (HttpHeaders, HTTP_END_OF_HDR_STR);
+      HttpInitHeaderScanner (&HeaderScanner);
+      if (HttpScanHeader (&HeaderScanner, HttpHeaders, HdrLen, &HeaderLength)) {
+        EndofHeader = HttpHeaders + HeaderLength - AsciiStrLen (HTTP_END_OF_HDR_STR);
+      }
     }
 
     HttpInstance->EndofHeader = &EndofHeader;
@@ -1093,7 +1100,8 @@ HttpResponseWorker (
       }
 
       CopyMem (HttpInstance->CacheBody, EndofHeader, BodyLen);
-      HttpInstance->CacheLen = BodyLen;
+      HttpInstance->CacheLen     = BodyLen;
+      HttpInstance->RxCopyBytes += BodyLen;
     }
 
     //
@@ -1289,13 +1297,17 @@ HttpResponseWorker (
       if (HttpMsg->BodyLength < BodyLen) {
         CopyMem (HttpMsg->Body, HttpInstance->CacheBody + HttpInstance->CacheOffset, HttpMsg->BodyLength);
         HttpInstance->CacheOffset = HttpInstance->CacheOffset + HttpMsg->BodyLength;
+        HttpInstance->RxCopyBytes += HttpMsg->BodyLength;
+        HttpInstance->RxBodyBytes += HttpMsg->BodyLength;
       } else {
         //
         // Copy all cached data out.
         //
         CopyMem (HttpMsg->Body, HttpInstance->CacheBody + HttpInstance->CacheOffset, BodyLen);
-        HttpInstance->CacheOffset = BodyLen + HttpInstance->CacheOffset;
-        HttpMsg->BodyLength       = BodyLen;
+        HttpInstance->CacheOffset  = BodyLen + HttpInstance->CacheOffset;
+        HttpMsg->BodyLength        = BodyLen;
+        HttpInstance->RxCopyBytes += BodyLen;
+        HttpInstance->RxBodyBytes += BodyLen;
 
         if (HttpInstance->NextMsg == NULL) {
           //
@@ -1366,7 +1378,7 @@ HttpResponseWorker (
       goto Error2;
     }
 
-    Status = HttpsReceive (HttpInstance, &Fragment, HttpInstance->TimeoutEvent);
+    Status = HttpsReceive (HttpInstance, &Fragment, &FragmentBuffer, HttpInstance->TimeoutEvent);
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
 
@@ -1380,6 +1392,7 @@ HttpResponseWorker (
     HttpMsg->BodyLength = MIN ((UINTN)Fragment.Len, HttpMsg->BodyLength);
 
     CopyMem (HttpMsg->Body, Fragment.Bulk, HttpMsg->BodyLength);
+    HttpInstance->RxCopyBytes += HttpMsg->BodyLength;
 
     //
     // Record the CallbackData data.
@@ -1415,28 +1428,32 @@ HttpResponseWorker (
       HttpMsg->BodyLength = HttpInstance->NextMsg - (CHAR8 *)HttpMsg->Body;
     }
 
-    HttpInstance->CacheLen = Fragment.Len - HttpMsg->BodyLength;
-    if (HttpInstance->CacheLen != 0) {
+    HttpInstance->RxBodyBytes += HttpMsg->BodyLength;
+
+    //
+    // Keep the rest of the decrypted record in place as the cache, the data
+    // at [CacheBody + CacheOffset, CacheBody + CacheLen) is returned by the
+    // next Response() call without being copied again. Fragment.Bulk points
+    // into FragmentBuffer, past the TLS record header.
+    //
+    if (Fragment.Len > HttpMsg->BodyLength) {
       if (HttpInstance->CacheBody != NULL) {
         FreePool (HttpInstance->CacheBody);
       }
 
-      HttpInstance->CacheBody = AllocateZeroPool (HttpInstance->CacheLen);
-      if (HttpInstance->CacheBody == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Error2;
-      }
-
-      CopyMem (HttpInstance->CacheBody, Fragment.Bulk + HttpMsg->BodyLength, HttpInstance->CacheLen);
-      HttpInstance->CacheOffset = 0;
+      HttpInstance->CacheBody   = (CHAR8 *)FragmentBuffer;
+      HttpInstance->CacheLen    = (UINTN)(Fragment.Bulk - FragmentBuffer) + Fragment.Len;
+      HttpInstance->CacheOffset = (UINTN)(Fragment.Bulk - FragmentBuffer) + HttpMsg->BodyLength;
       if (HttpInstance->NextMsg != NULL) {
-        HttpInstance->NextMsg = HttpInstance->CacheBody;
+        HttpInstance->NextMsg = HttpInstance->CacheBody + HttpInstance->CacheOffset;
       }
+
+      FragmentBuffer = NULL;
     }
 
-    if (Fragment.Bulk != NULL) {
-      FreePool (Fragment.Bulk);
-      Fragment.Bulk = NULL;
+    if (FragmentBuffer != NULL) {
+      FreePool (FragmentBuffer);
+      FragmentBuffer = NULL;
     }
 
     goto Exit;
@@ -1483,9 +1500,9 @@ Error:
     HttpHeaders = NULL;
   }
 
-  if (Fragment.Bulk != NULL) {
-    FreePool (Fragment.Bulk);
-    Fragment.Bulk = NULL;
+  if (FragmentBuffer != NULL) {
+    FreePool (FragmentBuffer);
+    FragmentBuffer = NULL;
   }
 
   if (HttpMsg->Headers != NULL) {
@@ -233,9 +233,17 @@ HttpTcpReceiveNotifyDpc (
       CopyMem (HttpInstance->CacheBody, HttpInstance->NextMsg, HttpInstance->CacheLen);
       HttpInstance->NextMsg     = HttpInstance->CacheBody;
       HttpInstance->CacheOffset = 0;
+
+      HttpInstance->RxCopyBytes += HttpInstance->CacheLen;
     }
   }
 
+  //
+  // TCP copied the data straight from its receive queue into the caller's buffer.
+  //
+  HttpInstance->RxCopyBytes += Length;
+  HttpInstance->RxBodyBytes += Wrap->HttpToken->Message->BodyLength;
+
   Item = NetMapFindKey (&Wrap->HttpInstance->RxTokens, Wrap->HttpToken);
   if (Item != NULL) {
     NetMapRemoveItem (&Wrap->HttpInstance->RxTokens, Item, NULL);
@@ -825,6 +833,17 @@ HttpCleanProtocol (
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
 
+  if (HttpInstance->RxBodyBytes != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "HttpCleanProtocol: %Lu message-body bytes received, %Lu bytes copied\n",
+      HttpInstance->RxBodyBytes,
+      HttpInstance->RxCopyBytes
+      ));
+    HttpInstance->RxBodyBytes = 0;
+    HttpInstance->RxCopyBytes = 0;
+  }
+
   if (HttpInstance->TimeoutEvent != NULL) {
     gBS->CloseEvent (HttpInstance->TimeoutEvent);
     HttpInstance->TimeoutEvent = NULL;
@@ -1088,6 +1107,8 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle         = TRUE;
   Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableTimeStamp     = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
   Tcp4CfgData->ControlOption      = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
@@ -1172,6 +1193,8 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle         = TRUE;
   Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableTimeStamp     = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -1806,6 +1829,66 @@ HttpTcpReceive (
   return HttpResponseWorker ((HTTP_TOKEN_WRAP *)Item->Value);
 }
 
+/**
+  Append received data to the HTTP header buffer and check whether it completes
+  the HTTP headers.
+
+  The buffer grows geometrically and only the new data is scanned for the end of
+  the headers, so receiving the headers in many pieces takes linear time.
+
+  @param[in, out]  Scanner          The scanner state for the end of the headers.
+  @param[in, out]  HttpHeaders      The Null-terminated buffer of received data.
+  @param[in, out]  SizeofHeaders    The length of received data in HttpHeaders.
+  @param[in, out]  Capacity         The allocated size of HttpHeaders.
+  @param[in]       Fragment         The newly received data.
+  @param[out]      EndofHeader      Set to the empty line which ends the headers
+                                    when it is received.
+
+  @retval EFI_SUCCESS               The data is appended.
+  @retval EFI_OUT_OF_RESOURCES      Failed to grow the buffer.
+
+**/
+EFI_STATUS
+HttpAppendHeaderData (
+  IN OUT HTTP_HEADER_SCANNER  *Scanner,
+  IN OUT CHAR8                **HttpHeaders,
+  IN OUT UINTN                *SizeofHeaders,
+  IN OUT UINTN                *Capacity,
+  IN     NET_FRAGMENT         *Fragment,
+  OUT    CHAR8                **EndofHeader
+  )
+{
+  CHAR8  *Buffer;
+  UINTN  NewCapacity;
+  UINTN  HeaderLength;
+
+  if (*SizeofHeaders + Fragment->Len + 1 > *Capacity) {
+    NewCapacity = MAX (*Capacity * 2, *SizeofHeaders + Fragment->Len + 1);
+    Buffer      = AllocatePool (NewCapacity);
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    if (*HttpHeaders != NULL) {
+      CopyMem (Buffer, *HttpHeaders, *SizeofHeaders);
+      FreePool (*HttpHeaders);
+    }
+
+    *HttpHeaders = Buffer;
+    *Capacity    = NewCapacity;
+  }
+
+  CopyMem (*HttpHeaders + *SizeofHeaders, Fragment->Bulk, Fragment->Len);
+  *SizeofHeaders                 += Fragment->Len;
+  (*HttpHeaders)[*SizeofHeaders]  = '\0';
+
+  if (HttpScanHeader (Scanner, (CHAR8 *)Fragment->Bulk, Fragment->Len, &HeaderLength)) {
+    *EndofHeader = *HttpHeaders + HeaderLength - AsciiStrLen (HTTP_END_OF_HDR_STR);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Receive the HTTP header by processing the associated HTTP token.
 
@@ -1826,27 +1909,40 @@ HttpTcpReceiveHeader (
   IN  EFI_EVENT      Timeout
   )
 {
-  EFI_STATUS         Status;
-  EFI_TCP4_IO_TOKEN  *Rx4Token;
-  EFI_TCP4_PROTOCOL  *Tcp4;
-  EFI_TCP6_IO_TOKEN  *Rx6Token;
-  EFI_TCP6_PROTOCOL  *Tcp6;
-  CHAR8              **EndofHeader;
-  CHAR8              **HttpHeaders;
-  CHAR8              *Buffer;
-  NET_FRAGMENT       Fragment;
+  EFI_STATUS           Status;
+  EFI_TCP4_IO_TOKEN    *Rx4Token;
+  EFI_TCP4_PROTOCOL    *Tcp4;
+  EFI_TCP6_IO_TOKEN    *Rx6Token;
+  EFI_TCP6_PROTOCOL    *Tcp6;
+  CHAR8                **EndofHeader;
+  CHAR8                **HttpHeaders;
+  NET_FRAGMENT         Fragment;
+  UINT8                *FragmentBuffer;
+  HTTP_HEADER_SCANNER  Scanner;
+  UINTN                Capacity;
+  UINTN                HeaderLength;
 
   ASSERT (HttpInstance != NULL);
 
-  EndofHeader   = HttpInstance->EndofHeader;
-  HttpHeaders   = HttpInstance->HttpHeaders;
-  Tcp4          = HttpInstance->Tcp4;
-  Tcp6          = HttpInstance->Tcp6;
-  Buffer        = NULL;
-  Rx4Token      = NULL;
-  Rx6Token      = NULL;
-  Fragment.Len  = 0;
-  Fragment.Bulk = NULL;
+  EndofHeader    = HttpInstance->EndofHeader;
+  HttpHeaders    = HttpInstance->HttpHeaders;
+  Tcp4           = HttpInstance->Tcp4;
+  Tcp6           = HttpInstance->Tcp6;
+  Rx4Token       = NULL;
+  Rx6Token       = NULL;
+  Fragment.Len   = 0;
+  Fragment.Bulk  = NULL;
+  FragmentBuffer = NULL;
+
+  //
+  // Part of the headers may be cached by the previous response. Scan it too,
+  // in case it ends in the middle of the empty line after the headers.
+  //
+  HttpInitHeaderScanner (&Scanner);
+  Capacity = *SizeofHeaders;
+  if ((*HttpHeaders != NULL) && (*EndofHeader == NULL)) {
+    HttpScanHeader (&Scanner, *HttpHeaders, *SizeofHeaders, &HeaderLength);
+  }
 
   if (HttpInstance->LocalAddressIsIPv6) {
     ASSERT (Tcp6 != NULL);
@@ -1906,12 +2002,12 @@ HttpTcpReceiveHeader (
         Fragment.Len  = Rx4Token->Packet.RxData->FragmentTable[0].FragmentLength;
         Fragment.Bulk = (UINT8 *)Rx4Token->Packet.RxData->FragmentTable[0].FragmentBuffer;
       } else {
-        if (Fragment.Bulk != NULL) {
-          FreePool (Fragment.Bulk);
-          Fragment.Bulk = NULL;
+        if (FragmentBuffer != NULL) {
+          FreePool (FragmentBuffer);
+          FragmentBuffer = NULL;
         }
 
-        Status = HttpsReceive (HttpInstance, &Fragment, Timeout);
+        Status = HttpsReceive (HttpInstance, &Fragment, &FragmentBuffer, Timeout);
         if (EFI_ERROR (Status)) {
           DEBUG ((DEBUG_ERROR, "Tcp4 receive failed: %r\n", Status));
           return Status;
@@ -1919,33 +2015,15 @@ HttpTcpReceiveHeader (
       }
 
       //
-      // Append the response string along with a Null-terminator.
+      // Append the response string along with a Null-terminator, and check
+      // whether we received end of HTTP headers.
       //
-      *BufferSize = *SizeofHeaders + Fragment.Len;
-      Buffer      = AllocatePool (*BufferSize + 1);
-      if (Buffer == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
+      Status = HttpAppendHeaderData (&Scanner, HttpHeaders, SizeofHeaders, &Capacity, &Fragment, EndofHeader);
+      if (EFI_ERROR (Status)) {
         return Status;
       }
 
-      if (*HttpHeaders != NULL) {
-        CopyMem (Buffer, *HttpHeaders, *SizeofHeaders);
-        FreePool (*HttpHeaders);
-      }
-
-      CopyMem (
-        Buffer + *SizeofHeaders,
-        Fragment.Bulk,
-        Fragment.Len
-        );
-      *(Buffer + *BufferSize) = '\0';
-      *HttpHeaders            = Buffer;
-      *SizeofHeaders          = *BufferSize;
-
-      //
-      // Check whether we received end of HTTP headers.
-      //
-      *EndofHeader = AsciiStrStr (*HttpHeaders, HTTP_END_OF_HDR_STR);
+      *BufferSize = *SizeofHeaders;
     }
 
     //
@@ -1957,9 +2035,9 @@ HttpTcpReceiveHeader (
       Fragment.Bulk                                            = NULL;
     }
 
-    if (Fragment.Bulk != NULL) {
-      FreePool (Fragment.Bulk);
-      Fragment.Bulk = NULL;
+    if (FragmentBuffer != NULL) {
+      FreePool (FragmentBuffer);
+      FragmentBuffer = NULL;
     }
   } else {
     if (!HttpInstance->UseHttps) {
@@ -2006,12 +2084,12 @@ HttpTcpReceiveHeader (
         Fragment.Len  = Rx6Token->Packet.RxData->FragmentTable[0].FragmentLength;
         Fragment.Bulk = (UINT8 *)Rx6Token->Packet.RxData->FragmentTable[0].FragmentBuffer;
       } else {
-        if (Fragment.Bulk != NULL) {
-          FreePool (Fragment.Bulk);
-          Fragment.Bulk = NULL;
+        if (FragmentBuffer != NULL) {
+          FreePool (FragmentBuffer);
+          FragmentBuffer = NULL;
         }
 
-        Status = HttpsReceive (HttpInstance, &Fragment, Timeout);
+        Status = HttpsReceive (HttpInstance, &Fragment, &FragmentBuffer, Timeout);
         if (EFI_ERROR (Status)) {
           DEBUG ((DEBUG_ERROR, "Tcp6 receive failed: %r\n", Status));
           return Status;
@@ -2019,33 +2097,15 @@ HttpTcpReceiveHeader (
       }
 
       //
-      // Append the response string along with a Null-terminator.
+      // Append the response string along with a Null-terminator, and check
+      // whether we received end of HTTP headers.
       //
-      *BufferSize = *SizeofHeaders + Fragment.Len;
-      Buffer      = AllocatePool (*BufferSize + 1);
-      if (Buffer == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
+      Status = HttpAppendHeaderData (&Scanner, HttpHeaders, SizeofHeaders, &Capacity, &Fragment, EndofHeader);
+      if (EFI_ERROR (Status)) {
         return Status;
       }
 
-      if (*HttpHeaders != NULL) {
-        CopyMem (Buffer, *HttpHeaders, *SizeofHeaders);
-        FreePool (*HttpHeaders);
-      }
-
-      CopyMem (
-        Buffer + *SizeofHeaders,
-        Fragment.Bulk,
-        Fragment.Len
-        );
-      *(Buffer + *BufferSize) = '\0';
-      *HttpHeaders            = Buffer;
-      *SizeofHeaders          = *BufferSize;
-
-      //
-      // Check whether we received end of HTTP headers.
-      //
-      *EndofHeader = AsciiStrStr (*HttpHeaders, HTTP_END_OF_HDR_STR);
+      *BufferSize = *SizeofHeaders;
     }
 
     //
@@ -2057,9 +2117,9 @@ HttpTcpReceiveHeader (
       Fragment.Bulk                                            = NULL;
     }
 
-    if (Fragment.Bulk != NULL) {
-      FreePool (Fragment.Bulk);
-      Fragment.Bulk = NULL;
+    if (FragmentBuffer != NULL) {
+      FreePool (FragmentBuffer);
+      FragmentBuffer = NULL;
     }
   }
 
@@ -148,6 +148,15 @@ typedef struct _HTTP_PROTOCOL {
   UINTN                             CacheLen;
   UINTN                             CacheOffset;
 
+  //
+  // Receive path statistics. RxCopyBytes counts the bytes this driver, or TCP
+  // on its behalf, copies on the receive path, so that RxCopyBytes / RxBodyBytes
+  // approximates the number of copies per delivered message-body byte. Copies
+  // inside the TLS driver are not counted.
+  //
+  UINT64                            RxBodyBytes;
+  UINT64                            RxCopyBytes;
+
   //
   // HTTP message-body parser.
   //
@@ -548,6 +557,35 @@ HttpTcpReceive (
   IN VOID          *Context
   );
 
+/**
+  Append received data to the HTTP header buffer and check whether it completes
+  the HTTP headers.
+
+  The buffer grows geometrically and only the new data is scanned for the end of
+  the headers, so receiving the headers in many pieces takes linear time.
+
+  @param[in, out]  Scanner          The scanner state for the end of the headers.
+  @param[in, out]  HttpHeaders      The Null-terminated buffer of received data.
+  @param[in, out]  SizeofHeaders    The length of received data in HttpHeaders.
+  @param[in, out]  Capacity         The allocated size of HttpHeaders.
+  @param[in]       Fragment         The newly received data.
+  @param[out]      EndofHeader      Set to the empty line which ends the headers
+                                    when it is received.
+
+  @retval EFI_SUCCESS               The data is appended.
+  @retval EFI_OUT_OF_RESOURCES      Failed to grow the buffer.
+
+**/
+EFI_STATUS
+HttpAppendHeaderData (
+  IN OUT HTTP_HEADER_SCANNER  *Scanner,
+  IN OUT CHAR8                **HttpHeaders,
+  IN OUT UINTN                *SizeofHeaders,
+  IN OUT UINTN                *Capacity,
+  IN     NET_FRAGMENT         *Fragment,
+  OUT    CHAR8                **EndofHeader
+  );
+
 /**
   Receive the HTTP header by processing the associated HTTP token.
 
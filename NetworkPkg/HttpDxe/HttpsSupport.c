@@ -88,24 +88,6 @@ AsciiStrCaseStr (
   return NULL;
 }
 
-/**
-  The callback function to free the net buffer list.
-
-  @param[in]  Arg The opaque parameter.
-
-**/
-VOID
-EFIAPI
-FreeNbufList (
-  IN VOID  *Arg
-  )
-{
-  ASSERT (Arg != NULL);
-
-  NetbufFreeList ((LIST_ENTRY *)Arg);
-  FreePool (Arg);
-}
-
 /**
   Check whether the Url is from Https.
 
@@ -1021,8 +1003,9 @@ ON_EXIT:
 
 /**
   Receive one TLS PDU. An TLS PDU contains an TLS record header and its
-  corresponding record data. These two parts will be put into two blocks of buffers in the
-  net buffer.
+  corresponding record data. Both parts are put into one contiguous block of
+  the net buffer, so that the record can be handed to the TLS protocol without
+  being flattened first.
 
   @param[in, out]      HttpInstance    Pointer to HTTP_PROTOCOL structure.
   @param[out]          Pdu             The received TLS PDU.
@@ -1044,8 +1027,6 @@ TlsReceiveOnePdu (
 {
   EFI_STATUS  Status;
 
-  LIST_ENTRY  *NbufList;
-
   UINT32  Len;
 
   NET_BUF            *PduHdr;
@@ -1054,17 +1035,9 @@ TlsReceiveOnePdu (
 
   NET_BUF  *DataSeg;
 
-  NbufList = NULL;
-  PduHdr   = NULL;
-  Header   = NULL;
-  DataSeg  = NULL;
-
-  NbufList = AllocatePool (sizeof (LIST_ENTRY));
-  if (NbufList == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  InitializeListHead (NbufList);
+  PduHdr  = NULL;
+  Header  = NULL;
+  DataSeg = NULL;
 
   //
   // Allocate buffer to receive one TLS header.
@@ -1072,8 +1045,7 @@ TlsReceiveOnePdu (
   Len    = TLS_RECORD_HEADER_LENGTH;
   PduHdr = NetbufAlloc (Len);
   if (PduHdr == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+    return EFI_OUT_OF_RESOURCES;
   }
 
   Header = NetbufAllocSpace (PduHdr, Len, NET_BUF_TAIL);
@@ -1091,69 +1063,61 @@ TlsReceiveOnePdu (
   }
 
   RecordHeader = *(TLS_RECORD_HEADER *)Header;
-  if (((RecordHeader.ContentType == TlsContentTypeHandshake) ||
-       (RecordHeader.ContentType == TlsContentTypeAlert) ||
-       (RecordHeader.ContentType == TlsContentTypeChangeCipherSpec) ||
-       (RecordHeader.ContentType == TlsContentTypeApplicationData)) &&
-      (RecordHeader.Version.Major == 0x03) && /// Major versions are same.
-      ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
-       (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
-       (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR))
-      )
+  if (!(((RecordHeader.ContentType == TlsContentTypeHandshake) ||
+         (RecordHeader.ContentType == TlsContentTypeAlert) ||
+         (RecordHeader.ContentType == TlsContentTypeChangeCipherSpec) ||
+         (RecordHeader.ContentType == TlsContentTypeApplicationData)) &&
+        (RecordHeader.Version.Major == 0x03) && /// Major versions are same.
+        ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
+         (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
+         (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR))
+        ))
   {
-    InsertTailList (NbufList, &PduHdr->List);
-  } else {
     Status = EFI_PROTOCOL_ERROR;
     goto ON_EXIT;
   }
 
-  Len = SwapBytes16 (RecordHeader.Length);
-  if (Len == 0) {
-    //
-    // No TLS payload.
-    //
-    goto FORM_PDU;
-  }
-
   //
-  // Allocate buffer to receive one TLS payload.
+  // Allocate one buffer for the whole record, leaving room in front of the
+  // payload for the record header.
   //
-  DataSeg = NetbufAlloc (Len);
+  Len     = SwapBytes16 (RecordHeader.Length);
+  DataSeg = NetbufAlloc (TLS_RECORD_HEADER_LENGTH + Len);
   if (DataSeg == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ON_EXIT;
   }
 
-  NetbufAllocSpace (DataSeg, Len, NET_BUF_TAIL);
+  NetbufReserve (DataSeg, TLS_RECORD_HEADER_LENGTH);
 
-  //
-  // Second step, receive one TLS payload.
-  //
-  Status = TlsCommonReceive (HttpInstance, DataSeg, Timeout);
-  if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+  if (Len != 0) {
+    NetbufAllocSpace (DataSeg, Len, NET_BUF_TAIL);
+
+    //
+    // Second step, receive one TLS payload.
+    //
+    Status = TlsCommonReceive (HttpInstance, DataSeg, Timeout);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
   }
 
-  InsertTailList (NbufList, &DataSeg->List);
+  CopyMem (
+    NetbufAllocSpace (DataSeg, TLS_RECORD_HEADER_LENGTH, NET_BUF_HEAD),
+    Header,
+    TLS_RECORD_HEADER_LENGTH
+    );
 
-FORM_PDU:
-  //
-  // Form the PDU from a list of PDU.
-  //
-  *Pdu = NetbufFromBufList (NbufList, 0, 0, FreeNbufList, NbufList);
-  if (*Pdu == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-  }
+  *Pdu    = DataSeg;
+  DataSeg = NULL;
 
 ON_EXIT:
-
-  if (EFI_ERROR (Status)) {
-    //
-    // Free the Nbufs in this NbufList and the NbufList itself.
-    //
-    FreeNbufList (NbufList);
+  if (DataSeg != NULL) {
+    NetbufFree (DataSeg);
   }
 
+  NetbufFree (PduHdr);
+
   return Status;
 }
 
@@ -1589,6 +1553,18 @@ TlsProcessMessage (
     goto ON_EXIT;
   }
 
+  //
+  // A single processed fragment is handed to the caller as it is.
+  //
+  if ((FragmentCount == 1) &&
+      (FragmentTable != OriginalFragmentTable) &&
+      (FragmentTable[0].FragmentBuffer != Message))
+  {
+    Fragment->Len  = FragmentTable[0].FragmentLength;
+    Fragment->Bulk = FragmentTable[0].FragmentBuffer;
+    goto ON_EXIT;
+  }
+
   //
   // Calculate the size according to FragmentTable.
   //
@@ -1625,6 +1601,10 @@ TlsProcessMessage (
   Fragment->Len  = BufferSize;
   Fragment->Bulk = Buffer;
 
+  if (ProcessMode == EfiTlsDecrypt) {
+    HttpInstance->RxCopyBytes += BufferSize;
+  }
+
 ON_EXIT:
 
   if (OriginalFragmentTable != NULL) {
@@ -1652,6 +1632,9 @@ ON_EXIT:
 
   @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
   @param[in, out]      Fragment        The received Fragment.
+  @param[out]          Buffer          The buffer holding the received Fragment,
+                                       which the caller must free, or NULL if no
+                                       data is received.
   @param[in]           Timeout         The time to wait for connection done.
 
   @retval EFI_SUCCESS          One fragment is received.
@@ -1665,6 +1648,7 @@ EFIAPI
 HttpsReceive (
   IN     HTTP_PROTOCOL  *HttpInstance,
   IN OUT NET_FRAGMENT   *Fragment,
+  OUT    UINT8          **Buffer,
   IN     EFI_EVENT      Timeout
   )
 {
@@ -1691,6 +1675,7 @@ HttpsReceive (
   DataOut                  = NULL;
   GetSessionDataBuffer     = NULL;
   GetSessionDataBufferSize = 0;
+  *Buffer                  = NULL;
 
   //
   // Receive only one TLS record
@@ -1700,22 +1685,27 @@ HttpsReceive (
     return Status;
   }
 
+  //
+  // The PDU is a single contiguous block. Application data is decrypted
+  // straight out of it, the other records are rare and small and are
+  // handled on a flat copy.
+  //
+  ASSERT (Pdu->BlockOpNum == 1);
   BufferInSize = Pdu->TotalSize;
-  BufferIn     = AllocateZeroPool (BufferInSize);
-  if (BufferIn == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
+  BufferIn     = NetbufGetByte (Pdu, 0, NULL);
+  RecordHeader = *(TLS_RECORD_HEADER *)BufferIn;
+  if (RecordHeader.ContentType != TlsContentTypeApplicationData) {
+    BufferIn = AllocateCopyPool (BufferInSize, BufferIn);
     NetbufFree (Pdu);
-    return Status;
+    Pdu = NULL;
+    if (BufferIn == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
   }
 
-  NetbufCopy (Pdu, 0, (UINT32)BufferInSize, BufferIn);
-
-  NetbufFree (Pdu);
-
   //
   // Handle Receive data.
   //
-  RecordHeader = *(TLS_RECORD_HEADER *)BufferIn;
 
   if ((RecordHeader.ContentType == TlsContentTypeApplicationData) &&
       (RecordHeader.Version.Major == 0x03) &&
@@ -1735,7 +1725,7 @@ HttpsReceive (
                &TempFragment
                );
 
-    FreePool (BufferIn);
+    NetbufFree (Pdu);
 
     if (EFI_ERROR (Status)) {
       if (Status == EFI_ABORTED) {
@@ -1811,19 +1801,13 @@ HttpsReceive (
     //
     ASSERT (((TLS_RECORD_HEADER *)(TempFragment.Bulk))->ContentType == TlsContentTypeApplicationData);
 
-    BufferInSize = ((TLS_RECORD_HEADER *)(TempFragment.Bulk))->Length;
-    BufferIn     = AllocateZeroPool (BufferInSize);
-    if (BufferIn == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      return Status;
-    }
-
-    CopyMem (BufferIn, TempFragment.Bulk + TLS_RECORD_HEADER_LENGTH, BufferInSize);
-
     //
-    // Free the buffer in TempFragment.
+    // The payload is returned where it was decrypted, after the record header.
+    // The caller frees the whole decrypted buffer.
     //
-    FreePool (TempFragment.Bulk);
+    *Buffer      = TempFragment.Bulk;
+    BufferInSize = ((TLS_RECORD_HEADER *)(TempFragment.Bulk))->Length;
+    BufferIn     = TempFragment.Bulk + TLS_RECORD_HEADER_LENGTH;
   } else if ((RecordHeader.ContentType == TlsContentTypeAlert) &&
              (RecordHeader.Version.Major == 0x03) &&
              ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
@@ -243,6 +243,9 @@ TlsProcessMessage (
 
   @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
   @param[in, out]      Fragment        The received Fragment.
+  @param[out]          Buffer          The buffer holding the received Fragment,
+                                       which the caller must free, or NULL if no
+                                       data is received.
   @param[in]           Timeout         The time to wait for connection done.
 
   @retval EFI_SUCCESS          One fragment is received.
@@ -256,6 +259,7 @@ EFIAPI
 HttpsReceive (
   IN     HTTP_PROTOCOL  *HttpInstance,
   IN OUT NET_FRAGMENT   *Fragment,
+  OUT    UINT8          **Buffer,
   IN     EFI_EVENT      Timeout
   );
 
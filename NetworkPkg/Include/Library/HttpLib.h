@@ -338,6 +338,60 @@ HttpFreeMsgParser (
   IN  VOID  *MsgParser
   );
 
+//
+// HTTP header scanner interface.
+//
+
+///
+/// State of an incremental search for the end of an HTTP header block, the
+/// empty line "\r\n\r\n". Initialize it with HttpInitHeaderScanner() before
+/// feeding the first received data to HttpScanHeader().
+///
+typedef struct {
+  UINTN    ScannedLength;      ///< Bytes of the header block examined so far.
+  UINTN    MatchedLength;      ///< Bytes of "\r\n\r\n" matched at the end of them.
+} HTTP_HEADER_SCANNER;
+
+/**
+  Initialize an HTTP header scanner.
+
+  @param[out]   Scanner            Pointer to the scanner to initialize.
+
+**/
+VOID
+EFIAPI
+HttpInitHeaderScanner (
+  OUT HTTP_HEADER_SCANNER  *Scanner
+  );
+
+/**
+  Look for the end of an HTTP header block in the next piece of received data.
+
+  The header block may arrive in any number of pieces, and its terminating empty
+  line may be split between them. Every byte is examined only once, so the data
+  received before does not need to be scanned again.
+
+  @param[in, out]   Scanner            Pointer to the scanner state.
+  @param[in]        Data               Pointer to the next piece of received data.
+  @param[in]        DataLength         Length in bytes of the Data.
+  @param[out]       HeaderLength       On return of TRUE, the length in bytes of the
+                                       header block including its terminating empty
+                                       line, counted from the first byte fed to the
+                                       scanner.
+
+  @retval TRUE                         The end of the header block is found.
+  @retval FALSE                        More data is needed, or a parameter is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+HttpScanHeader (
+  IN OUT HTTP_HEADER_SCANNER  *Scanner,
+  IN     CONST CHAR8          *Data,
+  IN     UINTN                DataLength,
+  OUT    UINTN                *HeaderLength
+  );
+
 /**
   Find a specified header field according to the field name.
 
@@ -1556,6 +1556,7 @@ NetLibIp6ToStr (
 #define  NET_BUF_HEAD          1    // Trim or allocate space from head
 #define  NET_BUF_TAIL          0    // Trim or allocate space from tail
 #define  NET_VECTOR_OWN_FIRST  0x01 // We allocated the 1st block in the vector
+#define  NET_VECTOR_POOL_BULK  0x02 // The block comes from the net buffer pool
 
 #define NET_CHECK_SIGNATURE(PData, SIGNATURE) \
   ASSERT (((PData) != NULL) && ((PData)->Signature == (SIGNATURE)))
@@ -1689,6 +1690,30 @@ typedef struct {
 #define NET_BUF_SIZE(BlockOpNum)  \
   (sizeof (NET_BUF) + ((BlockOpNum) - 1) * sizeof (NET_BLOCK_OP))
 
+//
+// The net buffer pool recycles the NET_BUF and NET_VECTOR of single block
+// net buffers, and the data blocks of NetbufAlloc() rounded up to one of
+// the NET_BUF_POOL_BULK_* sizes. Each class keeps up to NET_BUF_POOL_DEPTH
+// free objects.
+//
+#define NET_BUF_POOL_BULK_SMALL   128
+#define NET_BUF_POOL_BULK_MEDIUM  512
+#define NET_BUF_POOL_BULK_LARGE   2048
+#define NET_BUF_POOL_CLASS_NUM    5
+#define NET_BUF_POOL_DEPTH        32
+
+//
+// Statistics of one size class of the net buffer pool
+//
+typedef struct {
+  UINT32    Size;                   // The object size of the class
+  UINT32    Cached;                 // Free objects kept in the class
+  UINT32    InUse;                  // Objects allocated and not freed yet
+  UINT32    MaxInUse;               // High-water mark of InUse
+  UINT64    Allocs;                 // Number of allocations
+  UINT64    Hits;                   // Allocations served from the free list
+} NET_BUF_POOL_STATS;
+
 #define NET_HEADSPACE(BlockOp)  \
   ((UINTN)((BlockOp)->Head) - (UINTN)((BlockOp)->BlockHead))
 
@@ -1711,6 +1736,38 @@ NetbufAlloc (
   IN UINT32  Len
   );
 
+/**
+  Get the statistics of one size class of the net buffer pool.
+
+  The pool is private to each module that links this library, the
+  statistics are those of the calling module.
+
+  @param[in]   Index             The index of the size class, from 0 to
+                                 NET_BUF_POOL_CLASS_NUM - 1.
+  @param[out]  Stats             The statistics of the size class.
+
+  @retval EFI_SUCCESS            The statistics are returned.
+  @retval EFI_INVALID_PARAMETER  Stats is NULL.
+  @retval EFI_NOT_FOUND          There is no size class Index.
+
+**/
+EFI_STATUS
+EFIAPI
+NetbufPoolGetStats (
+  IN  UINTN               Index,
+  OUT NET_BUF_POOL_STATS  *Stats
+  );
+
+/**
+  Release all the free objects kept by the net buffer pool.
+
+**/
+VOID
+EFIAPI
+NetbufPoolFlush (
+  VOID
+  );
+
 /**
   Free the net buffer and its associated NET_VECTOR.
 
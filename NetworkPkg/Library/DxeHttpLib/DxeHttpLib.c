@@ -1179,8 +1179,9 @@ HttpParseMessageBody (
 
   //
   // The message body might be truncated in anywhere, so we need to parse is byte-by-byte.
+  // Stop at the end of the message, any byte after it belongs to the next message.
   //
-  for (Char = Body; Char < Body + BodyLength; ) {
+  for (Char = Body; (Char < Body + BodyLength) && (Parser->State != BodyParserComplete); ) {
     switch (Parser->State) {
       case BodyParserStateMax:
         return EFI_ABORTED;
@@ -1190,14 +1191,14 @@ HttpParseMessageBody (
         // Identity transfer-coding, just notify user to save the body data.
         //
         PortionLength = MIN (
-                          BodyLength,
+                          BodyLength - (Char - Body),
                           Parser->ContentLength - Parser->ParsedBodyLength
                           );
         if (PortionLength == 0) {
           //
           // Got BodyLength, but no ContentLength. Use BodyLength.
           //
-          PortionLength         = BodyLength;
+          PortionLength         = BodyLength - (Char - Body);
           Parser->ContentLength = PortionLength;
         }
 
@@ -1478,6 +1479,91 @@ HttpFreeMsgParser (
   FreePool (MsgParser);
 }
 
+/**
+  Initialize an HTTP header scanner.
+
+  @param[out]   Scanner            Pointer to the scanner to initialize.
+
+**/
+VOID
+EFIAPI
+HttpInitHeaderScanner (
+  OUT HTTP_HEADER_SCANNER  *Scanner
+  )
+{
+  if (Scanner != NULL) {
+    Scanner->ScannedLength = 0;
+    Scanner->MatchedLength = 0;
+  }
+}
+
+/**
+  Look for the end of an HTTP header block in the next piece of received data.
+
+  The header block may arrive in any number of pieces, and its terminating empty
+  line may be split between them. Every byte is examined only once, so the data
+  received before does not need to be scanned again.
+
+  @param[in, out]   Scanner            Pointer to the scanner state.
+  @param[in]        Data               Pointer to the next piece of received data.
+  @param[in]        DataLength         Length in bytes of the Data.
+  @param[out]       HeaderLength       On return of TRUE, the length in bytes of the
+                                       header block including its terminating empty
+                                       line, counted from the first byte fed to the
+                                       scanner.
+
+  @retval TRUE                         The end of the header block is found.
+  @retval FALSE                        More data is needed, or a parameter is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+HttpScanHeader (
+  IN OUT HTTP_HEADER_SCANNER  *Scanner,
+  IN     CONST CHAR8          *Data,
+  IN     UINTN                DataLength,
+  OUT    UINTN                *HeaderLength
+  )
+{
+  UINTN  Index;
+  UINTN  Matched;
+
+  if ((Scanner == NULL) || (Data == NULL) || (HeaderLength == NULL)) {
+    return FALSE;
+  }
+
+  Matched = Scanner->MatchedLength;
+
+  for (Index = 0; Index < DataLength; Index++) {
+    //
+    // Most of the bytes are not part of a line break, skip them quickly.
+    //
+    if ((Matched == 0) && (Data[Index] != '\r')) {
+      continue;
+    }
+
+    //
+    // The terminator alternates '\r' and '\n'. A '\r' which breaks the
+    // sequence starts a new one.
+    //
+    if (Data[Index] == (((Matched & 1) == 0) ? '\r' : '\n')) {
+      Matched++;
+      if (Matched == HTTP_HEADER_TERMINATOR_LENGTH) {
+        *HeaderLength          = Scanner->ScannedLength + Index + 1;
+        Scanner->ScannedLength = *HeaderLength;
+        Scanner->MatchedLength = 0;
+        return TRUE;
+      }
+    } else {
+      Matched = (Data[Index] == '\r') ? 1 : 0;
+    }
+  }
+
+  Scanner->ScannedLength += DataLength;
+  Scanner->MatchedLength  = Matched;
+  return FALSE;
+}
+
 /**
   Get the next string, which is distinguished by specified separator.
 
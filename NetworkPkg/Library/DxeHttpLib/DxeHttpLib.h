@@ -26,6 +26,11 @@ Header file for HttpLib.
 #define HTTP_VERSION_CRLF_STR  " HTTP/1.1\r\n"
 #define EMPTY_SPACE            " "
 
+//
+// Length of "\r\n\r\n", the empty line which ends an HTTP header block.
+//
+#define HTTP_HEADER_TERMINATOR_LENGTH  4
+
 #define NET_IS_HEX_CHAR(Ch)   \
   ((('0' <= (Ch)) && ((Ch) <= '9')) ||  \
    (('A' <= (Ch)) && ((Ch) <= 'F')) ||  \
@@ -0,0 +1,371 @@
+/** @file
+  Tests for the incremental HTTP header scanner and the message body parser
+  in DxeHttpLib.c.
+
+  The header scanner is fed the same data in every possible fragmentation and
+  compared to a plain search of the whole buffer. The body parser is fed chunked
+  messages split at random points. The benchmark only reports the timings, it
+  doesn't fail on them. It is disabled so that the unit test run stays quiet,
+  run it with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/HttpLib.h>
+  #include <IndustryStandard/Http11.h>
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_FUZZ_ITERATIONS   2000
+#define TEST_BENCH_HEADER_LEN  (16 * 1024)
+#define TEST_BENCH_FRAGMENT    536
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+static const std::string  mResponseHeader =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: application/octet-stream\r\n"
+  "Transfer-Encoding: chunked\r\n"
+  "\r\n";
+
+//
+// Feed Data to a fresh scanner in pieces of at most Step bytes. Returns the
+// header length, or 0 if no end of header is found.
+//
+static UINTN
+ScanInSteps (
+  const std::string  &Data,
+  UINTN              Step
+  )
+{
+  HTTP_HEADER_SCANNER  Scanner;
+  UINTN                Offset;
+  UINTN                Length;
+  UINTN                HeaderLength;
+
+  HttpInitHeaderScanner (&Scanner);
+  for (Offset = 0; Offset < Data.size (); Offset += Length) {
+    Length = MIN (Step, Data.size () - Offset);
+    if (HttpScanHeader (&Scanner, Data.data () + Offset, Length, &HeaderLength)) {
+      return HeaderLength;
+    }
+  }
+
+  return 0;
+}
+
+//
+// The reference: a search of the whole buffer.
+//
+static UINTN
+ScanWhole (
+  const std::string  &Data
+  )
+{
+  size_t  Pos;
+
+  Pos = Data.find ("\r\n\r\n");
+  return (Pos == std::string::npos) ? 0 : (UINTN)(Pos + 4);
+}
+
+typedef struct {
+  std::string    Body;
+  UINTN          Calls;
+} BODY_CONTEXT;
+
+static EFI_STATUS
+EFIAPI
+CollectBody (
+  IN HTTP_BODY_PARSE_EVENT  EventType,
+  IN CHAR8                  *Data,
+  IN UINTN                  Length,
+  IN VOID                   *Context
+  )
+{
+  BODY_CONTEXT  *Ctx;
+
+  Ctx = (BODY_CONTEXT *)Context;
+  if (EventType == BodyParseEventOnData) {
+    Ctx->Body.append (Data, Length);
+    Ctx->Calls++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+static std::string
+EncodeChunked (
+  const std::string  &Payload,
+  std::mt19937       &Rng
+  )
+{
+  std::string  Encoded;
+  size_t       Offset;
+  size_t       Length;
+  char         Size[32];
+
+  for (Offset = 0; Offset < Payload.size (); Offset += Length) {
+    Length = (Rng () % 300) + 1;
+    Length = MIN (Length, Payload.size () - Offset);
+    snprintf (Size, sizeof (Size), "%zx\r\n", Length);
+    Encoded += Size;
+    Encoded += Payload.substr (Offset, Length);
+    Encoded += "\r\n";
+  }
+
+  Encoded += "0\r\n\r\n";
+  return Encoded;
+}
+
+//
+// Parse Message with a chunked body parser, splitting it at random points.
+//
+static EFI_STATUS
+ParseChunked (
+  std::string   &Message,
+  std::mt19937  &Rng,
+  BODY_CONTEXT  *Ctx,
+  BOOLEAN       *Complete
+  )
+{
+  EFI_HTTP_HEADER  Header;
+  VOID             *Parser;
+  EFI_STATUS       Status;
+  size_t           Offset;
+  size_t           Length;
+
+  Header.FieldName  = (CHAR8 *)HTTP_HEADER_TRANSFER_ENCODING;
+  Header.FieldValue = (CHAR8 *)HTTP_HEADER_TRANSFER_ENCODING_CHUNKED;
+
+  Status = HttpInitMsgParser (HttpMethodGet, HTTP_STATUS_200_OK, 1, &Header, CollectBody, Ctx, &Parser);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Offset = 0; Offset < Message.size (); Offset += Length) {
+    Length = (Rng () % 64) + 1;
+    Length = MIN (Length, Message.size () - Offset);
+    Status = HttpParseMessageBody (Parser, Length, &Message[Offset]);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  *Complete = HttpIsMessageComplete (Parser);
+  HttpFreeMsgParser (Parser);
+  return Status;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Header scanner
+////////////////////////////////////////////////////////////////////////
+
+TEST (HttpHeaderScannerTest, FindsEndInOneBuffer) {
+  std::string  Data;
+
+  Data = mResponseHeader + "body";
+  EXPECT_EQ (ScanInSteps (Data, Data.size ()), mResponseHeader.size ());
+}
+
+TEST (HttpHeaderScannerTest, FindsEndAtEverySplit) {
+  HTTP_HEADER_SCANNER  Scanner;
+  std::string          Data;
+  UINTN                Split;
+  UINTN                HeaderLength;
+  BOOLEAN              Found;
+
+  Data = mResponseHeader + "body";
+  for (Split = 0; Split <= Data.size (); Split++) {
+    HttpInitHeaderScanner (&Scanner);
+    HeaderLength = 0;
+    Found        = HttpScanHeader (&Scanner, Data.data (), Split, &HeaderLength);
+    if (!Found) {
+      Found = HttpScanHeader (&Scanner, Data.data () + Split, Data.size () - Split, &HeaderLength);
+    }
+
+    EXPECT_TRUE (Found) << "split at " << Split;
+    EXPECT_EQ (HeaderLength, mResponseHeader.size ()) << "split at " << Split;
+  }
+}
+
+TEST (HttpHeaderScannerTest, FindsEndByteByByte) {
+  EXPECT_EQ (ScanInSteps (mResponseHeader, 1), mResponseHeader.size ());
+}
+
+TEST (HttpHeaderScannerTest, NeedsMoreData) {
+  EXPECT_EQ (ScanInSteps ("HTTP/1.1 200 OK\r\nHost: a\r\n\r", 1), 0u);
+  EXPECT_EQ (ScanInSteps ("\r\r\n\n\r\n\n\r\n", 1), 0u);
+}
+
+TEST (HttpHeaderScannerTest, RejectsNullParameters) {
+  HTTP_HEADER_SCANNER  Scanner;
+  UINTN                HeaderLength;
+
+  HttpInitHeaderScanner (&Scanner);
+  EXPECT_FALSE (HttpScanHeader (NULL, "\r\n\r\n", 4, &HeaderLength));
+  EXPECT_FALSE (HttpScanHeader (&Scanner, NULL, 4, &HeaderLength));
+  EXPECT_FALSE (HttpScanHeader (&Scanner, "\r\n\r\n", 4, NULL));
+}
+
+TEST (HttpHeaderScannerTest, MatchesWholeBufferSearch) {
+  std::mt19937  Rng (0x4854);
+  std::string   Data;
+  const char    Alphabet[] = { '\r', '\n', 'a' };
+  UINTN         Iteration;
+  UINTN         Index;
+  UINTN         Step;
+
+  for (Iteration = 0; Iteration < TEST_FUZZ_ITERATIONS; Iteration++) {
+    Data.clear ();
+    for (Index = Rng () % 64; Index > 0; Index--) {
+      Data += Alphabet[Rng () % 3];
+    }
+
+    Step = (Rng () % 8) + 1;
+    ASSERT_EQ (ScanInSteps (Data, Step), ScanWhole (Data)) << "step " << Step;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Message body parser
+////////////////////////////////////////////////////////////////////////
+
+TEST (HttpBodyParserTest, ReassemblesChunkedBody) {
+  std::mt19937  Rng (0x4442);
+  std::string   Payload;
+  std::string   Message;
+  BODY_CONTEXT  Ctx;
+  BOOLEAN       Complete;
+  UINTN         Iteration;
+
+  for (Iteration = 0; Iteration < 200; Iteration++) {
+    Payload.assign (Rng () % 4096 + 1, '\0');
+    for (auto &Byte : Payload) {
+      Byte = (char)Rng ();
+    }
+
+    Message = EncodeChunked (Payload, Rng);
+    Ctx     = { };
+    ASSERT_EQ (ParseChunked (Message, Rng, &Ctx, &Complete), EFI_SUCCESS);
+    EXPECT_TRUE (Complete);
+    EXPECT_EQ (Ctx.Body, Payload);
+  }
+}
+
+TEST (HttpBodyParserTest, StopsAtEndOfMessage) {
+  std::mt19937  Rng (0x454f);
+  std::string   Message;
+  BODY_CONTEXT  Ctx;
+  BOOLEAN       Complete;
+
+  //
+  // The data after the last chunk belongs to the next message, it must not
+  // keep the parser spinning or be reported as body.
+  //
+  Message = "5\r\nhello\r\n0\r\n\r\nHTTP/1.1 200 OK\r\n";
+  Ctx     = { };
+  EXPECT_EQ (ParseChunked (Message, Rng, &Ctx, &Complete), EFI_SUCCESS);
+  EXPECT_TRUE (Complete);
+  EXPECT_EQ (Ctx.Body, "hello");
+}
+
+TEST (HttpBodyParserTest, IdentityBodyStopsAtContentLength) {
+  EFI_HTTP_HEADER  Header;
+  VOID             *Parser;
+  BODY_CONTEXT     Ctx;
+  CHAR8            Body[] = "0123456789abcdef";
+
+  Header.FieldName  = (CHAR8 *)HTTP_HEADER_CONTENT_LENGTH;
+  Header.FieldValue = (CHAR8 *)"10";
+
+  Ctx = { };
+  ASSERT_EQ (HttpInitMsgParser (HttpMethodGet, HTTP_STATUS_200_OK, 1, &Header, CollectBody, &Ctx, &Parser), EFI_SUCCESS);
+  EXPECT_EQ (HttpParseMessageBody (Parser, 4, Body), EFI_SUCCESS);
+  EXPECT_EQ (HttpParseMessageBody (Parser, 12, Body + 4), EFI_SUCCESS);
+  EXPECT_TRUE (HttpIsMessageComplete (Parser));
+  EXPECT_EQ (HttpParseMessageBody (Parser, 4, Body), EFI_SUCCESS);
+  EXPECT_EQ (Ctx.Body, "0123456789");
+  HttpFreeMsgParser (Parser);
+}
+
+TEST (HttpBodyParserTest, SurvivesRandomBytes) {
+  std::mt19937  Rng (0x5242);
+  std::string   Message;
+  BODY_CONTEXT  Ctx;
+  BOOLEAN       Complete;
+  UINTN         Iteration;
+
+  for (Iteration = 0; Iteration < TEST_FUZZ_ITERATIONS; Iteration++) {
+    Message.assign (Rng () % 256 + 1, '\0');
+    for (auto &Byte : Message) {
+      Byte = "0123456789abcdefxyz;\r\n"[Rng () % 22];
+    }
+
+    Ctx = { };
+    ParseChunked (Message, Rng, &Ctx, &Complete);
+    EXPECT_LE (Ctx.Body.size (), Message.size ());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Benchmark
+////////////////////////////////////////////////////////////////////////
+
+TEST (HttpHeaderScannerTest, DISABLED_Benchmark) {
+  std::string  Data;
+  UINTN        Offset;
+  UINTN        Length;
+  UINTN        Found;
+  CHAR8        *Buffer;
+
+  while (Data.size () < TEST_BENCH_HEADER_LEN) {
+    Data += "X-Padding: 0123456789abcdef0123456789abcdef\r\n";
+  }
+
+  Data += "\r\n";
+
+  //
+  // Rescan the whole header received so far on each fragment, as done
+  // before the scanner was introduced.
+  //
+  auto  Start = std::chrono::steady_clock::now ();
+
+  Buffer = (CHAR8 *)AllocateZeroPool (Data.size () + 1);
+  ASSERT_NE (Buffer, nullptr);
+  Found = 0;
+  for (Offset = 0; Offset < Data.size () && Found == 0; Offset += Length) {
+    Length = MIN (TEST_BENCH_FRAGMENT, Data.size () - Offset);
+    CopyMem (Buffer + Offset, Data.data () + Offset, Length);
+    if (AsciiStrStr (Buffer, "\r\n\r\n") != NULL) {
+      Found = Offset + Length;
+    }
+  }
+
+  FreePool (Buffer);
+  auto  Middle = std::chrono::steady_clock::now ();
+
+  EXPECT_EQ (ScanInSteps (Data, TEST_BENCH_FRAGMENT), Data.size ());
+  auto  End = std::chrono::steady_clock::now ();
+
+  std::cout << "[ BENCH    ] " << Data.size () << " byte header in " << TEST_BENCH_FRAGMENT
+            << " byte fragments: rescan "
+            << std::chrono::duration_cast<std::chrono::microseconds>(Middle - Start).count ()
+            << " us, incremental "
+            << std::chrono::duration_cast<std::chrono::microseconds>(End - Middle).count ()
+            << " us" << std::endl;
+}
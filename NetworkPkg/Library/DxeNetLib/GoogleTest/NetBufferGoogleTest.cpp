@@ -0,0 +1,258 @@
+/** @file
+  Tests for the net buffer pool in NetBuffer.c.
+
+  The benchmark compares the allocate/free cycle of a typical Ethernet
+  sized net buffer with and without the recycling of the pool. It only
+  reports the timings, it doesn't fail on them. It is disabled so that
+  the unit test run stays quiet, run it with
+  --gtest_also_run_disabled_tests --gtest_filter=*Benchmark.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <chrono>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/NetLib.h>
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_PACKET_LEN        1514
+#define TEST_BENCH_ITERATIONS  200000
+#define TEST_BENCH_BURST       16
+
+//
+// The index of the size classes, in the order of NetBuffer.c
+//
+#define POOL_CLASS_NBUF        0
+#define POOL_CLASS_VECTOR      1
+#define POOL_CLASS_BULK_SMALL  2
+#define POOL_CLASS_BULK_LARGE  4
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+static NET_BUF_POOL_STATS
+GetStats (
+  UINTN  Index
+  )
+{
+  NET_BUF_POOL_STATS  Stats;
+
+  EXPECT_EQ (NetbufPoolGetStats (Index, &Stats), EFI_SUCCESS);
+  return Stats;
+}
+
+//
+// The pool keeps its statistics over the whole test program. Each test
+// starts with empty free lists and compares the counters to a snapshot.
+//
+class NetBufferPoolTest : public ::testing::Test {
+protected:
+  NET_BUF_POOL_STATS Before[NET_BUF_POOL_CLASS_NUM];
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Index;
+
+    NetbufPoolFlush ();
+    for (Index = 0; Index < NET_BUF_POOL_CLASS_NUM; Index++) {
+      Before[Index] = GetStats (Index);
+    }
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    NetbufPoolFlush ();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+TEST_F (NetBufferPoolTest, GetStatsRejectsBadParameters) {
+  NET_BUF_POOL_STATS  Stats;
+
+  EXPECT_EQ (NetbufPoolGetStats (0, NULL), EFI_INVALID_PARAMETER);
+  EXPECT_EQ (NetbufPoolGetStats (NET_BUF_POOL_CLASS_NUM, &Stats), EFI_NOT_FOUND);
+}
+
+TEST_F (NetBufferPoolTest, FreedNetbufIsRecycled) {
+  NET_BUF             *Nbuf;
+  NET_BUF_POOL_STATS  Stats;
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  EXPECT_EQ (Nbuf->Vector->Len, (UINT32)TEST_PACKET_LEN);
+  EXPECT_EQ (Nbuf->BlockOp[0].BlockTail - Nbuf->BlockOp[0].BlockHead, TEST_PACKET_LEN);
+  NetbufFree (Nbuf);
+
+  Stats = GetStats (POOL_CLASS_BULK_LARGE);
+  EXPECT_EQ (Stats.Size, (UINT32)NET_BUF_POOL_BULK_LARGE);
+  EXPECT_EQ (Stats.Cached, 1U);
+  EXPECT_EQ (Stats.Hits, Before[POOL_CLASS_BULK_LARGE].Hits);
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+
+  //
+  // All three parts of the net buffer come from the free lists.
+  //
+  EXPECT_EQ (GetStats (POOL_CLASS_NBUF).Hits, Before[POOL_CLASS_NBUF].Hits + 1);
+  EXPECT_EQ (GetStats (POOL_CLASS_VECTOR).Hits, Before[POOL_CLASS_VECTOR].Hits + 1);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Hits, Before[POOL_CLASS_BULK_LARGE].Hits + 1);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Cached, 0U);
+
+  //
+  // A recycled net buffer must look like a fresh one.
+  //
+  EXPECT_EQ (Nbuf->TotalSize, 0U);
+  EXPECT_EQ (Nbuf->RefCnt, 1);
+  EXPECT_EQ (Nbuf->Vector->RefCnt, 1);
+  EXPECT_EQ (Nbuf->Ip.Ip4, nullptr);
+  NetbufFree (Nbuf);
+}
+
+TEST_F (NetBufferPoolTest, SmallBlocksUseSmallClass) {
+  NET_BUF  *Nbuf;
+
+  Nbuf = NetbufAlloc (60);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufFree (Nbuf);
+
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_SMALL).Allocs, Before[POOL_CLASS_BULK_SMALL].Allocs + 1);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_SMALL).Cached, 1U);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Allocs, Before[POOL_CLASS_BULK_LARGE].Allocs);
+}
+
+TEST_F (NetBufferPoolTest, LargeBlocksBypassPool) {
+  NET_BUF  *Nbuf;
+  UINTN    Index;
+
+  Nbuf = NetbufAlloc (NET_BUF_POOL_BULK_LARGE + 1);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufFree (Nbuf);
+
+  for (Index = POOL_CLASS_BULK_SMALL; Index < NET_BUF_POOL_CLASS_NUM; Index++) {
+    EXPECT_EQ (GetStats (Index).Allocs, Before[Index].Allocs);
+  }
+}
+
+TEST_F (NetBufferPoolTest, HighWaterMarkAndDepth) {
+  NET_BUF  *Nbuf[NET_BUF_POOL_DEPTH + 8];
+  UINTN    Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    Nbuf[Index] = NetbufAlloc (TEST_PACKET_LEN);
+    ASSERT_NE (Nbuf[Index], nullptr);
+  }
+
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).InUse, Before[POOL_CLASS_BULK_LARGE].InUse + ARRAY_SIZE (Nbuf));
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    NetbufFree (Nbuf[Index]);
+  }
+
+  EXPECT_GE (GetStats (POOL_CLASS_BULK_LARGE).MaxInUse, (UINT32)ARRAY_SIZE (Nbuf));
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).InUse, Before[POOL_CLASS_BULK_LARGE].InUse);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Cached, (UINT32)NET_BUF_POOL_DEPTH);
+
+  NetbufPoolFlush ();
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Cached, 0U);
+}
+
+TEST_F (NetBufferPoolTest, ClonesAndFragmentsShareTheVector) {
+  NET_BUF  *Nbuf;
+  NET_BUF  *Clone;
+  NET_BUF  *Fragment;
+  UINT8    *Data;
+
+  Nbuf = NetbufAlloc (TEST_PACKET_LEN);
+  ASSERT_NE (Nbuf, nullptr);
+  Data = NetbufAllocSpace (Nbuf, 1000, NET_BUF_TAIL);
+  ASSERT_NE (Data, nullptr);
+  SetMem (Data, 1000, 0x5A);
+
+  Clone = NetbufClone (Nbuf);
+  ASSERT_NE (Clone, nullptr);
+  Fragment = NetbufGetFragment (Nbuf, 100, 200, 20);
+  ASSERT_NE (Fragment, nullptr);
+
+  //
+  // The data block is only returned to the pool with the last reference.
+  //
+  NetbufFree (Nbuf);
+  NetbufFree (Clone);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Cached, 0U);
+  EXPECT_EQ (*NetbufGetByte (Fragment, 0, NULL), 0x5A);
+
+  NetbufFree (Fragment);
+  EXPECT_EQ (GetStats (POOL_CLASS_BULK_LARGE).Cached, 1U);
+}
+
+TEST_F (NetBufferPoolTest, DISABLED_Benchmark) {
+  NET_BUF  *Nbuf[TEST_BENCH_BURST];
+  VOID     *Raw[TEST_BENCH_BURST * 3];
+  UINTN    Iteration;
+  UINTN    Index;
+  double   PoolNs;
+  double   RawNs;
+
+  //
+  // Allocate and free bursts of packets the way a receive path does.
+  //
+  auto  Start = std::chrono::steady_clock::now ();
+
+  for (Iteration = 0; Iteration < TEST_BENCH_ITERATIONS / TEST_BENCH_BURST; Iteration++) {
+    for (Index = 0; Index < TEST_BENCH_BURST; Index++) {
+      Nbuf[Index] = NetbufAlloc (TEST_PACKET_LEN);
+    }
+
+    for (Index = 0; Index < TEST_BENCH_BURST; Index++) {
+      NetbufFree (Nbuf[Index]);
+    }
+  }
+
+  auto  Middle = std::chrono::steady_clock::now ();
+
+  //
+  // The same three allocations per packet without the pool.
+  //
+  for (Iteration = 0; Iteration < TEST_BENCH_ITERATIONS / TEST_BENCH_BURST; Iteration++) {
+    for (Index = 0; Index < TEST_BENCH_BURST; Index++) {
+      Raw[3 * Index]     = AllocateZeroPool (NET_BUF_SIZE (1));
+      Raw[3 * Index + 1] = AllocateZeroPool (NET_VECTOR_SIZE (1));
+      Raw[3 * Index + 2] = AllocatePool (TEST_PACKET_LEN);
+    }
+
+    for (Index = 0; Index < ARRAY_SIZE (Raw); Index++) {
+      FreePool (Raw[Index]);
+    }
+  }
+
+  auto  End = std::chrono::steady_clock::now ();
+
+  PoolNs = std::chrono::duration<double, std::nano>(Middle - Start).count () / TEST_BENCH_ITERATIONS;
+  RawNs  = std::chrono::duration<double, std::nano>(End - Middle).count () / TEST_BENCH_ITERATIONS;
+
+  RecordProperty ("PoolNsPerPacket", std::to_string (PoolNs));
+  RecordProperty ("AllocatePoolNsPerPacket", std::to_string (RawNs));
+  std::cout << "[ BENCH    ] NetbufAlloc/NetbufFree " << PoolNs << " ns/packet, "
+            << "AllocatePool/FreePool " << RawNs << " ns/packet" << std::endl;
+
+  EXPECT_GE (GetStats (POOL_CLASS_BULK_LARGE).Hits, Before[POOL_CLASS_BULK_LARGE].Hits + TEST_BENCH_ITERATIONS - TEST_BENCH_BURST);
+}
@@ -14,6 +14,268 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+//
+// A free object in the net buffer pool, linked through its first bytes.
+//
+typedef struct _NET_BUF_POOL_ENTRY NET_BUF_POOL_ENTRY;
+
+struct _NET_BUF_POOL_ENTRY {
+  NET_BUF_POOL_ENTRY    *Next;
+};
+
+typedef struct {
+  NET_BUF_POOL_ENTRY    *Head;
+  NET_BUF_POOL_STATS    Stats;
+} NET_BUF_POOL_CLASS;
+
+//
+// The size classes, in increasing order of size within the bulk classes.
+//
+NET_BUF_POOL_CLASS  mNetbufPool[NET_BUF_POOL_CLASS_NUM] = {
+  { NULL, { NET_BUF_SIZE (1)         } },
+  { NULL, { NET_VECTOR_SIZE (1)      } },
+  { NULL, { NET_BUF_POOL_BULK_SMALL  } },
+  { NULL, { NET_BUF_POOL_BULK_MEDIUM } },
+  { NULL, { NET_BUF_POOL_BULK_LARGE  } }
+};
+
+//
+// The network stack runs on a single processor, but an event notify function
+// at a higher TPL may interrupt a pool operation. The interrupting operation
+// sees the pool busy and falls back to the memory allocation services.
+//
+volatile BOOLEAN  mNetbufPoolBusy = FALSE;
+
+/**
+  Find the size class of the net buffer pool for an object size.
+
+  @param[in]  Size               The object size.
+
+  @return The size class, or NULL if Size isn't the size of a class.
+
+**/
+NET_BUF_POOL_CLASS *
+NetbufPoolGetClass (
+  IN UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < NET_BUF_POOL_CLASS_NUM; Index++) {
+    if (mNetbufPool[Index].Stats.Size == Size) {
+      return &mNetbufPool[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Round a data block length up to the size of a bulk class of the net
+  buffer pool.
+
+  @param[in]  Len                The length of the data block.
+
+  @return The size of the bulk class, or Len if it is larger than all
+          the bulk classes.
+
+**/
+UINT32
+NetbufPoolBulkSize (
+  IN UINT32  Len
+  )
+{
+  if (Len <= NET_BUF_POOL_BULK_SMALL) {
+    return NET_BUF_POOL_BULK_SMALL;
+  } else if (Len <= NET_BUF_POOL_BULK_MEDIUM) {
+    return NET_BUF_POOL_BULK_MEDIUM;
+  } else if (Len <= NET_BUF_POOL_BULK_LARGE) {
+    return NET_BUF_POOL_BULK_LARGE;
+  }
+
+  return Len;
+}
+
+/**
+  Allocate an object from the net buffer pool. Objects of sizes without
+  a size class are allocated from the memory allocation services.
+
+  @param[in]  Size               The object size.
+
+  @return Pointer to the object, or NULL if the allocation failed.
+
+**/
+VOID *
+NetbufPoolAlloc (
+  IN UINTN  Size
+  )
+{
+  NET_BUF_POOL_CLASS  *Class;
+  NET_BUF_POOL_ENTRY  *Entry;
+
+  Class = NetbufPoolGetClass (Size);
+  if ((Class == NULL) || mNetbufPoolBusy) {
+    return AllocatePool (Size);
+  }
+
+  mNetbufPoolBusy = TRUE;
+
+  Entry = Class->Head;
+  if (Entry != NULL) {
+    Class->Head = Entry->Next;
+    Class->Stats.Cached--;
+    Class->Stats.Hits++;
+  } else {
+    Entry = AllocatePool (Size);
+  }
+
+  Class->Stats.Allocs++;
+  if (Entry != NULL) {
+    Class->Stats.InUse++;
+    if (Class->Stats.InUse > Class->Stats.MaxInUse) {
+      Class->Stats.MaxInUse = Class->Stats.InUse;
+    }
+  }
+
+  mNetbufPoolBusy = FALSE;
+
+  return Entry;
+}
+
+/**
+  Return an object to the net buffer pool. The object is freed to the
+  memory allocation services when its size class is full.
+
+  @param[in]  Buffer             The object allocated by NetbufPoolAlloc().
+  @param[in]  Size               The object size.
+
+**/
+VOID
+NetbufPoolFree (
+  IN VOID   *Buffer,
+  IN UINTN  Size
+  )
+{
+  NET_BUF_POOL_CLASS  *Class;
+  NET_BUF_POOL_ENTRY  *Entry;
+
+  Class = NetbufPoolGetClass (Size);
+  if ((Class == NULL) || mNetbufPoolBusy) {
+    FreePool (Buffer);
+    return;
+  }
+
+  mNetbufPoolBusy = TRUE;
+
+  //
+  // The object may have been allocated by another module's pool.
+  //
+  if (Class->Stats.InUse > 0) {
+    Class->Stats.InUse--;
+  }
+
+  if (Class->Stats.Cached < NET_BUF_POOL_DEPTH) {
+    Entry       = (NET_BUF_POOL_ENTRY *)Buffer;
+    Entry->Next = Class->Head;
+    Class->Head = Entry;
+    Class->Stats.Cached++;
+    Buffer = NULL;
+  }
+
+  mNetbufPoolBusy = FALSE;
+
+  if (Buffer != NULL) {
+    FreePool (Buffer);
+  }
+}
+
+/**
+  Get the statistics of one size class of the net buffer pool.
+
+  The pool is private to each module that links this library, the
+  statistics are those of the calling module.
+
+  @param[in]   Index             The index of the size class, from 0 to
+                                 NET_BUF_POOL_CLASS_NUM - 1.
+  @param[out]  Stats             The statistics of the size class.
+
+  @retval EFI_SUCCESS            The statistics are returned.
+  @retval EFI_INVALID_PARAMETER  Stats is NULL.
+  @retval EFI_NOT_FOUND          There is no size class Index.
+
+**/
+EFI_STATUS
+EFIAPI
+NetbufPoolGetStats (
+  IN  UINTN               Index,
+  OUT NET_BUF_POOL_STATS  *Stats
+  )
+{
+  if (Stats == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Index >= NET_BUF_POOL_CLASS_NUM) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Stats, &mNetbufPool[Index].Stats, sizeof (NET_BUF_POOL_STATS));
+  return EFI_SUCCESS;
+}
+
+/**
+  Release all the free objects kept by the net buffer pool.
+
+**/
+VOID
+EFIAPI
+NetbufPoolFlush (
+  VOID
+  )
+{
+  UINTN               Index;
+  NET_BUF_POOL_ENTRY  *Entry;
+
+  if (mNetbufPoolBusy) {
+    return;
+  }
+
+  mNetbufPoolBusy = TRUE;
+
+  for (Index = 0; Index < NET_BUF_POOL_CLASS_NUM; Index++) {
+    while (mNetbufPool[Index].Head != NULL) {
+      Entry                   = mNetbufPool[Index].Head;
+      mNetbufPool[Index].Head = Entry->Next;
+      FreePool (Entry);
+    }
+
+    mNetbufPool[Index].Stats.Cached = 0;
+  }
+
+  mNetbufPoolBusy = FALSE;
+}
+
+/**
+  Release the free objects of the net buffer pool when the module
+  linking this library is unloaded.
+
+  @param[in]  ImageHandle       The firmware allocated handle for the EFI image.
+  @param[in]  SystemTable       A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS           The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+NetLibDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  NetbufPoolFlush ();
+  return EFI_SUCCESS;
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,24 +304,28 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetbufPoolAlloc (NET_BUF_SIZE (BlockOpNum));
 
   if (Nbuf == NULL) {
     return NULL;
   }
 
+  ZeroMem (Nbuf, NET_BUF_SIZE (BlockOpNum));
+
   Nbuf->Signature  = NET_BUF_SIGNATURE;
   Nbuf->RefCnt     = 1;
   Nbuf->BlockOpNum = BlockOpNum;
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NetbufPoolAlloc (NET_VECTOR_SIZE (BlockNum));
 
     if (Vector == NULL) {
       goto FreeNbuf;
     }
 
+    ZeroMem (Vector, NET_VECTOR_SIZE (BlockNum));
+
     Vector->Signature = NET_VECTOR_SIGNATURE;
     Vector->RefCnt    = 1;
     Vector->BlockNum  = BlockNum;
@@ -70,7 +336,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufPoolFree (Nbuf, NET_BUF_SIZE (BlockOpNum));
   return NULL;
 }
 
@@ -102,14 +368,19 @@ NetbufAlloc (
     return NULL;
   }
 
-  Bulk = AllocatePool (Len);
+  //
+  // The block is rounded up to a size class of the pool, only the requested
+  // length is made visible.
+  //
+  Bulk = NetbufPoolAlloc (NetbufPoolBulkSize (Len));
 
   if (Bulk == NULL) {
     goto FreeNBuf;
   }
 
-  Vector      = Nbuf->Vector;
-  Vector->Len = Len;
+  Vector       = Nbuf->Vector;
+  Vector->Len  = Len;
+  Vector->Flag = NET_VECTOR_POOL_BULK;
 
   Vector->Block[0].Bulk = Bulk;
   Vector->Block[0].Len  = Len;
@@ -124,7 +395,8 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  NetbufPoolFree (Nbuf->Vector, NET_VECTOR_SIZE (1));
+  NetbufPoolFree (Nbuf, NET_BUF_SIZE (1));
   return NULL;
 }
 
@@ -162,20 +434,26 @@ NetbufFreeVector (
     // first block since it is allocated by us
     //
     if ((Vector->Flag & NET_VECTOR_OWN_FIRST) != 0) {
-      gBS->FreePool (Vector->Block[0].Bulk);
+      FreePool (Vector->Block[0].Bulk);
     }
 
     Vector->Free (Vector->Arg);
+  } else if ((Vector->Flag & NET_VECTOR_POOL_BULK) != 0) {
+    //
+    // The single block allocated by NetbufAlloc()
+    //
+    ASSERT (Vector->BlockNum == 1);
+    NetbufPoolFree (Vector->Block[0].Bulk, NetbufPoolBulkSize (Vector->Block[0].Len));
   } else {
     //
     // Free each memory block associated with the Vector
     //
     for (Index = 0; Index < Vector->BlockNum; Index++) {
-      gBS->FreePool (Vector->Block[Index].Bulk);
+      FreePool (Vector->Block[Index].Bulk);
     }
   }
 
-  FreePool (Vector);
+  NetbufPoolFree (Vector, NET_VECTOR_SIZE (Vector->BlockNum));
 }
 
 /**
@@ -208,7 +486,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufPoolFree (Nbuf, NET_BUF_SIZE (Nbuf->BlockOpNum));
   }
 }
 
@@ -234,7 +512,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetbufPoolAlloc (NET_BUF_SIZE (Nbuf->BlockOpNum));
 
   if (Clone == NULL) {
     return NULL;
@@ -662,7 +940,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetbufPoolFree (Child->Vector, NET_VECTOR_SIZE (1));
+  NetbufPoolFree (Child, NET_BUF_SIZE (BlockOpNum));
   return NULL;
 }
 
@@ -1840,7 +2119,7 @@ NetIpSecNetbufFree (
       FreePool (Nbuf->Vector->Block[0].Bulk);
     }
 
-    FreePool (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufPoolFree (Nbuf->Vector, NET_VECTOR_SIZE (Nbuf->Vector->BlockNum));
+    NetbufPoolFree (Nbuf, NET_BUF_SIZE (Nbuf->BlockOpNum));
   }
 }
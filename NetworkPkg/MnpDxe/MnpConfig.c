@@ -1194,9 +1194,11 @@ MnpStart (
   IN     BOOLEAN           EnableSystemPoll
   )
 {
-  EFI_STATUS       Status;
-  EFI_TIMER_DELAY  TimerOpType;
-  MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_STATUS               Status;
+  EFI_TIMER_DELAY          TimerOpType;
+  MNP_DEVICE_DATA          *MnpDeviceData;
+  EFI_TIMER_ARCH_PROTOCOL  *Timer;
+  UINT64                   TimerPeriod;
 
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
@@ -1265,7 +1267,24 @@ MnpStart (
     //
     TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    //
+    // Timer events are only signaled on the platform timer tick, a shorter
+    // poll period would not poll any faster. Use the tick as the floor.
+    //
+    MnpDeviceData->MinPollInterval = MNP_SYS_POLL_MIN_INTERVAL;
+    if (!EFI_ERROR (gBS->LocateProtocol (&gEfiTimerArchProtocolGuid, NULL, (VOID **)&Timer)) &&
+        !EFI_ERROR (Timer->GetTimerPeriod (Timer, &TimerPeriod)))
+    {
+      MnpDeviceData->MinPollInterval = MAX (TimerPeriod, MNP_SYS_POLL_MIN_INTERVAL);
+    }
+
+    //
+    // Start polling fast, the configuration is usually followed by traffic.
+    //
+    MnpDeviceData->PollInterval = MnpDeviceData->MinPollInterval;
+    MnpDeviceData->IdlePolls    = 0;
+
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
@@ -1326,6 +1345,26 @@ MnpStop (
   //
   // No configured children now.
   //
+  if (MnpDeviceData->PollCount != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "MnpStop: %lu polls, %lu with packets, %lu packets, max %u per poll, receive latency avg %lu us max %lu us\n",
+      MnpDeviceData->PollCount,
+      MnpDeviceData->RxPollCount,
+      MnpDeviceData->RxPackets,
+      MnpDeviceData->MaxRxPerPoll,
+      (MnpDeviceData->RxPollCount == 0) ? 0 : DivU64x64Remainder (MnpDeviceData->RxLatencyUs, MnpDeviceData->RxPollCount, NULL),
+      MnpDeviceData->MaxRxLatencyUs
+      ));
+
+    MnpDeviceData->PollCount      = 0;
+    MnpDeviceData->RxPollCount    = 0;
+    MnpDeviceData->RxPackets      = 0;
+    MnpDeviceData->RxLatencyUs    = 0;
+    MnpDeviceData->MaxRxLatencyUs = 0;
+    MnpDeviceData->MaxRxPerPoll   = 0;
+  }
+
   if (MnpDeviceData->EnableSystemPoll) {
     //
     //  The system poll in on, cancel the poll timer.
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Protocol/Timer.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -27,6 +28,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 #include "ComponentName.h"
 
@@ -70,6 +73,29 @@ typedef struct {
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
 
+  //
+  // Adaptive system poll. The poll period is shortened while packets are
+  // received and lengthened after MNP_SYS_POLL_IDLE_COUNT idle polls.
+  // MinPollInterval is MNP_SYS_POLL_MIN_INTERVAL raised to the timer tick.
+  //
+  UINT64                         PollInterval;
+  UINT64                         MinPollInterval;
+  UINT32                         IdlePolls;
+
+  //
+  // System poll statistics, reported when the MNP is stopped. The receive
+  // latency is the time since the previous poll when a poll finds packets,
+  // which bounds the time the packets have been waiting in the NIC.
+  // LastPollTick is the performance counter value at the previous poll.
+  //
+  UINT64                         LastPollTick;
+  UINT64                         PollCount;
+  UINT64                         RxPollCount;
+  UINT64                         RxPackets;
+  UINT64                         RxLatencyUs;
+  UINT64                         MaxRxLatencyUs;
+  UINT32                         MaxRxPerPoll;
+
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
 
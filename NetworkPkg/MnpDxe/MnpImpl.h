@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_MIN_INTERVAL    (1 * TICKS_PER_MS)     // 1 millisecond, raised to the timer tick
+#define MNP_SYS_POLL_IDLE_COUNT      8
+#define MNP_MAX_RX_PER_POLL          32
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -517,6 +520,21 @@ MnpCheckMediaStatus (
   IN VOID       *Context
   );
 
+/**
+  Adjust the system poll period to the receive activity. The period drops to
+  the minimum poll period as soon as packets are received, and doubles up to
+  the idle period after MNP_SYS_POLL_IDLE_COUNT polls without packets.
+
+  @param[in, out]  MnpDeviceData      Pointer to the mnp device context data.
+  @param[in]       Received           Number of packets received by the poll.
+
+**/
+VOID
+MnpUpdatePollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Received
+  );
+
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
@@ -1083,6 +1083,60 @@ MnpCheckMediaStatus (
   }
 }
 
+/**
+  Adjust the system poll period to the receive activity. The period drops to
+  the minimum poll period as soon as packets are received, and doubles up to
+  the idle period after MNP_SYS_POLL_IDLE_COUNT polls without packets.
+
+  @param[in, out]  MnpDeviceData      Pointer to the mnp device context data.
+  @param[in]       Received           Number of packets received by the poll.
+
+**/
+VOID
+MnpUpdatePollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Received
+  )
+{
+  UINT64      Interval;
+  UINT64      MaxInterval;
+  EFI_STATUS  Status;
+
+  //
+  // A Snp with a WaitForPacket event reports a packet one poll late when idle.
+  //
+  MaxInterval = MNP_SYS_POLL_INTERVAL;
+  if (MnpDeviceData->Snp->WaitForPacket != NULL) {
+    MaxInterval = MNP_SYS_POLL_INTERVAL / 2;
+  }
+
+  MaxInterval = MAX (MaxInterval, MnpDeviceData->MinPollInterval);
+
+  if (Received != 0) {
+    MnpDeviceData->IdlePolls = 0;
+    Interval                 = MnpDeviceData->MinPollInterval;
+  } else {
+    MnpDeviceData->IdlePolls++;
+    Interval = MnpDeviceData->PollInterval;
+    if ((MnpDeviceData->IdlePolls % MNP_SYS_POLL_IDLE_COUNT) == 0) {
+      Interval = MIN (MultU64x32 (Interval, 2), MaxInterval);
+    }
+  }
+
+  if (Interval == MnpDeviceData->PollInterval) {
+    return;
+  }
+
+  MnpDeviceData->PollInterval = Interval;
+
+  if (MnpDeviceData->EnableSystemPoll) {
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "MnpUpdatePollInterval: gBS->SetTimer for PollTimer failed, %r.\n", Status));
+    }
+  }
+}
+
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
@@ -1098,15 +1152,61 @@ MnpSystemPoll (
   IN VOID       *Context
   )
 {
-  MNP_DEVICE_DATA  *MnpDeviceData;
+  MNP_DEVICE_DATA              *MnpDeviceData;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  UINT64                       Elapsed;
+  UINT64                       LatencyUs;
+  UINT32                       Received;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  Snp      = MnpDeviceData->Snp;
+  Elapsed  = GetElapsedTicks (&MnpDeviceData->LastPollTick);
+  Received = 0;
+
+  MnpDeviceData->PollCount++;
+
   //
-  // Try to receive packets from Snp.
+  // When idle, ask the WaitForPacket event of the Snp first, it is cheaper
+  // than a receive. Its notify function may only run after this poll returns,
+  // so the idle period is halved for such Snp, see MnpUpdatePollInterval.
   //
-  MnpReceivePacket (MnpDeviceData);
+  if ((MnpDeviceData->IdlePolls < MNP_SYS_POLL_IDLE_COUNT) ||
+      (Snp->WaitForPacket == NULL) ||
+      (gBS->CheckEvent (Snp->WaitForPacket) != EFI_NOT_READY))
+  {
+    //
+    // Try to receive packets from Snp, drain a burst in one poll.
+    //
+    while (Received < MNP_MAX_RX_PER_POLL) {
+      if (EFI_ERROR (MnpReceivePacket (MnpDeviceData))) {
+        break;
+      }
+
+      Received++;
+    }
+  }
+
+  if (Received != 0) {
+    LatencyUs = 0;
+    if (MnpDeviceData->PollCount > 1) {
+      LatencyUs = DivU64x32 (GetTimeInNanoSecond (Elapsed), 1000);
+    }
+
+    MnpDeviceData->RxPollCount++;
+    MnpDeviceData->RxPackets   += Received;
+    MnpDeviceData->RxLatencyUs += LatencyUs;
+    if (LatencyUs > MnpDeviceData->MaxRxLatencyUs) {
+      MnpDeviceData->MaxRxLatencyUs = LatencyUs;
+    }
+
+    if (Received > MnpDeviceData->MaxRxPerPoll) {
+      MnpDeviceData->MaxRxPerPoll = Received;
+    }
+  }
+
+  MnpUpdatePollInterval (MnpDeviceData, Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -774,6 +774,12 @@ MnpPoll (
   // Try to receive packets.
   //
   Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  if (!EFI_ERROR (Status)) {
+    //
+    // Traffic is flowing, speed up the system poll as well.
+    //
+    MnpUpdatePollInterval (Instance->MnpServiceData->MnpDeviceData, 1);
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
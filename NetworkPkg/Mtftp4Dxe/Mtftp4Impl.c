@@ -26,6 +26,28 @@ Mtftp4CleanOperation (
   LIST_ENTRY          *Next;
   MTFTP4_BLOCK_RANGE  *Block;
   EFI_MTFTP4_TOKEN    *Token;
+  UINT64              ElapsedUs;
+
+  if (((Instance->Operation == EFI_MTFTP4_OPCODE_RRQ) ||
+       (Instance->Operation == EFI_MTFTP4_OPCODE_DIR)) &&
+      (Instance->TotalBlock != 0))
+  {
+    Instance->ElapsedTicks += GetElapsedTicks (&Instance->LastTick);
+    ElapsedUs               = DivU64x32 (GetTimeInNanoSecond (Instance->ElapsedTicks), 1000);
+    DEBUG ((
+      DEBUG_INFO,
+      "Mtftp4CleanOperation: %lu blocks of %u bytes in %lu ms, %lu KB/s, window %u, %u kept out of order, %u duplicates, %u gap ACKs, %r\n",
+      Instance->TotalBlock,
+      (UINT32)Instance->BlkSize,
+      DivU64x32 (ElapsedUs, 1000),
+      (ElapsedUs == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Instance->TotalBlock, Instance->BlkSize * 1000), ElapsedUs, NULL),
+      (UINT32)Instance->WindowSize,
+      Instance->AheadSaved,
+      Instance->DupBlocks,
+      Instance->GapAcks,
+      Result
+      ));
+  }
 
   //
   // Free various resources.
@@ -75,6 +97,12 @@ Mtftp4CleanOperation (
   Instance->WindowSize    = 1;
   Instance->TotalBlock    = 0;
   Instance->AckedBlock    = 0;
+  Instance->AheadBlocks   = 0;
+  Instance->GapAcked      = FALSE;
+  Instance->AheadSaved    = 0;
+  Instance->DupBlocks     = 0;
+  Instance->GapAcks       = 0;
+  Instance->ElapsedTicks  = 0;
   Instance->LastBlock     = 0;
   Instance->ServerIp      = 0;
   Instance->ListeningPort = 0;
@@ -440,6 +468,7 @@ Mtftp4Start (
   Instance->Token      = Token;
   Instance->BlkSize    = MTFTP4_DEFAULT_BLKSIZE;
   Instance->WindowSize = MTFTP4_DEFAULT_WINDOWSIZE;
+  Instance->LastTick   = GetPerformanceCounter ();
 
   CopyMem (&Instance->ServerIp, &Config->ServerIp, sizeof (IP4_ADDR));
   Instance->ServerIp = NTOHL (Instance->ServerIp);
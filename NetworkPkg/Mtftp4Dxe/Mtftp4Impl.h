@@ -29,6 +29,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UdpIoLib.h>
 #include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 extern EFI_MTFTP4_PROTOCOL  gMtftp4ProtocolTemplate;
 
@@ -50,6 +52,7 @@ typedef struct _MTFTP4_PROTOCOL  MTFTP4_PROTOCOL;
 #define MTFTP4_DEFAULT_RETRY        5
 #define MTFTP4_DEFAULT_BLKSIZE      512
 #define MTFTP4_DEFAULT_WINDOWSIZE   1
+#define MTFTP4_MAX_AHEAD_BLOCKS     64
 #define MTFTP4_TIME_TO_GETMAP       5
 
 #define MTFTP4_STATE_UNCONFIGED  0
@@ -126,6 +129,25 @@ struct _MTFTP4_PROTOCOL {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Blocks of a windowed download received ahead of a lost one, they
+  // are already saved in the user's buffer. Bit N stands for the block
+  // (next expected block + N + 1). GapAcked is set once the hole has
+  // been reported to the server.
+  //
+  UINT64                    AheadBlocks;
+  BOOLEAN                   GapAcked;
+
+  //
+  // Download statistics, reported when the operation completes.
+  // ElapsedTicks is accumulated on every data packet, from LastTick.
+  //
+  UINT64                    LastTick;
+  UINT64                    ElapsedTicks;
+  UINT32                    AheadSaved;
+  UINT32                    DupBlocks;
+  UINT32                    GapAcks;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
@@ -222,6 +222,127 @@ Mtftp4RrqSaveBlock (
   return EFI_SUCCESS;
 }
 
+/**
+  Save a data block that arrived ahead of the next expected one in a
+  windowed download. RFC7440 makes the server resend the window from
+  the first lost block, the blocks kept here are then skipped.
+
+  Only full blocks of a unicast download into the user's buffer are
+  kept, the others are dropped and received again in order.
+
+  @param  Instance              The Mtftp session
+  @param  Packet                The received data packet
+  @param  Len                   The packet length
+  @param  Offset                The distance from the next expected block
+
+  @retval EFI_SUCCESS           The block is saved or dropped
+  @retval EFI_ABORTED           The user tells to abort by return an error through
+                                CheckPacket
+
+**/
+EFI_STATUS
+Mtftp4RrqSaveAheadBlock (
+  IN OUT MTFTP4_PROTOCOL    *Instance,
+  IN     EFI_MTFTP4_PACKET  *Packet,
+  IN     UINT32             Len,
+  IN     UINT16             Offset
+  )
+{
+  EFI_MTFTP4_TOKEN  *Token;
+  EFI_STATUS        Status;
+  UINT64            Bit;
+  UINT64            Start;
+  UINT32            DataLen;
+
+  Token   = Instance->Token;
+  DataLen = Len - MTFTP4_DATA_HEAD_LEN;
+
+  if ((Token->Buffer == NULL) || (Instance->McastUdpPort != NULL) ||
+      (DataLen != Instance->BlkSize) || (Offset == 0) ||
+      (Offset >= Instance->WindowSize) || (Offset > MTFTP4_MAX_AHEAD_BLOCKS))
+  {
+    return EFI_SUCCESS;
+  }
+
+  Bit = LShiftU64 (1, Offset - 1);
+  if ((Instance->AheadBlocks & Bit) != 0) {
+    Instance->DupBlocks++;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The next expected block is the (TotalBlock + 1)th block of the file.
+  //
+  Start = MultU64x32 (Instance->TotalBlock + Offset, Instance->BlkSize);
+  if (Start + DataLen > Token->BufferSize) {
+    return EFI_SUCCESS;
+  }
+
+  if (Token->CheckPacket != NULL) {
+    Status = Token->CheckPacket (&Instance->Mtftp4, Token, (UINT16)Len, Packet);
+
+    if (EFI_ERROR (Status)) {
+      Mtftp4SendError (
+        Instance,
+        EFI_MTFTP4_ERRORCODE_ILLEGAL_OPERATION,
+        (UINT8 *)"User aborted download"
+        );
+
+      return EFI_ABORTED;
+    }
+  }
+
+  CopyMem ((UINT8 *)Token->Buffer + Start, Packet->Data.Data, DataLen);
+
+  Instance->AheadBlocks |= Bit;
+  Instance->AheadSaved++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Remove the blocks saved ahead of time that follow the block just
+  received from the file hole, they don't need to be received again.
+
+  @param  Instance              The Mtftp session
+
+  @return The number of blocks removed.
+
+**/
+UINT32
+Mtftp4RrqDrainAheadBlocks (
+  IN OUT MTFTP4_PROTOCOL  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  INTN        Next;
+  UINT64      BlockCounter;
+  BOOLEAN     Present;
+  UINT32      Drained;
+
+  Drained = 0;
+
+  while (Instance->AheadBlocks != 0) {
+    Present               = (BOOLEAN)((Instance->AheadBlocks & 1) != 0);
+    Instance->AheadBlocks = RShiftU64 (Instance->AheadBlocks, 1);
+
+    if (!Present) {
+      break;
+    }
+
+    Next = Mtftp4GetNextBlockNum (&Instance->Blocks);
+    ASSERT (Next >= 0);
+
+    Status = Mtftp4RemoveBlockNum (&Instance->Blocks, (UINT16)Next, FALSE, &BlockCounter);
+    ASSERT_EFI_ERROR (Status);
+
+    Instance->TotalBlock++;
+    Drained++;
+  }
+
+  return Drained;
+}
+
 /**
   Function to process the received data packets.
 
@@ -250,20 +371,47 @@ Mtftp4RrqHandleData (
   EFI_STATUS  Status;
   UINT16      BlockNum;
   INTN        Expected;
+  UINT16      Offset;
+  UINT32      Drained;
 
   *Completed = FALSE;
   Status     = EFI_SUCCESS;
+  Drained    = 0;
   BlockNum   = NTOHS (Packet->Data.Block);
   Expected   = Mtftp4GetNextBlockNum (&Instance->Blocks);
 
   ASSERT (Expected >= 0);
 
+  Instance->ElapsedTicks += GetElapsedTicks (&Instance->LastTick);
+
   //
   // If we are active (Master) and received an unexpected packet, transmit
   // the ACK for the block we received, then restart receiving the
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // In a windowed download, keep the blocks after the hole and report
+    // the hole only once. Every ACK makes the server restart its window,
+    // acking each block behind the hole would resend the data many times.
+    // A duplicate or old block may mean that our last ACK was lost, so it
+    // falls through and that ACK is sent again.
+    //
+    if (Instance->WindowSize > 1) {
+      Offset = (UINT16)(BlockNum - Expected);
+      if (Offset >= Instance->WindowSize) {
+        Instance->DupBlocks++;
+      } else {
+        Status = Mtftp4RrqSaveAheadBlock (Instance, Packet, Len, Offset);
+        if (EFI_ERROR (Status) || Instance->GapAcked) {
+          return Status;
+        }
+
+        Instance->GapAcked = TRUE;
+        Instance->GapAcks++;
+      }
+    }
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -281,6 +429,11 @@ Mtftp4RrqHandleData (
   //
   Instance->TotalBlock++;
 
+  if (Instance->Master) {
+    Instance->GapAcked = FALSE;
+    Drained            = Mtftp4RrqDrainAheadBlocks (Instance);
+  }
+
   //
   // Reset the passive client's timer whenever it received a
   // valid data packet.
@@ -311,7 +464,11 @@ Mtftp4RrqHandleData (
       BlockNum = (UINT16)(Expected - 1);
     }
 
-    if ((Instance->WindowSize == (Instance->TotalBlock - Instance->AckedBlock)) || (Expected < 0)) {
+    //
+    // Ack at the end of each window. When the hole has just been filled
+    // by the kept blocks, ack at once so that the server skips them.
+    //
+    if ((Instance->WindowSize <= (Instance->TotalBlock - Instance->AckedBlock)) || (Drained != 0) || (Expected < 0)) {
       Status = Mtftp4RrqSendAck (Instance, BlockNum);
     }
   }
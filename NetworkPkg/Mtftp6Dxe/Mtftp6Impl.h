@@ -24,6 +24,8 @@
 #include <Library/BaseLib.h>
 #include <Library/NetLib.h>
 #include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 typedef struct _MTFTP6_SERVICE   MTFTP6_SERVICE;
 typedef struct _MTFTP6_INSTANCE  MTFTP6_INSTANCE;
@@ -41,6 +43,7 @@ typedef struct _MTFTP6_INSTANCE  MTFTP6_INSTANCE;
 #define MTFTP6_DEFAULT_MAX_RETRY        5
 #define MTFTP6_DEFAULT_BLK_SIZE         512
 #define MTFTP6_DEFAULT_WINDOWSIZE       1
+#define MTFTP6_MAX_AHEAD_BLOCKS         64
 #define MTFTP6_TICK_PER_SECOND          10000000U
 
 #define MTFTP6_SERVICE_FROM_THIS(a)   CR (a, MTFTP6_SERVICE, ServiceBinding, MTFTP6_SERVICE_SIGNATURE)
@@ -86,6 +89,25 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Blocks of a windowed download received ahead of a lost one, they
+  // are already saved in the user's buffer. Bit N stands for the block
+  // (next expected block + N + 1). GapAcked is set once the hole has
+  // been reported to the server.
+  //
+  UINT64                    AheadBlocks;
+  BOOLEAN                   GapAcked;
+
+  //
+  // Download statistics, reported when the operation completes.
+  // ElapsedTicks is accumulated on every data packet, from LastTick.
+  //
+  UINT64                    LastTick;
+  UINT64                    ElapsedTicks;
+  UINT32                    AheadSaved;
+  UINT32                    DupBlocks;
+  UINT32                    GapAcks;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
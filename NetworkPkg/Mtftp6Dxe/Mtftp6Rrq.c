@@ -192,6 +192,136 @@ Mtftp6RrqSaveBlock (
   return EFI_SUCCESS;
 }
 
+/**
+  Save a data block that arrived ahead of the next expected one in a
+  windowed download. RFC7440 makes the server resend the window from
+  the first lost block, the blocks kept here are then skipped.
+
+  Only full blocks of a unicast download into the user's buffer are
+  kept, the others are dropped and received again in order.
+
+  @param[in]  Instance           The pointer to the Mtftp6 instance.
+  @param[in]  Packet             The pointer to the received packet.
+  @param[in]  Len                The length of the packet.
+  @param[in]  Offset             The distance from the next expected block.
+  @param[out] UdpPacket          The net buf of the received packet.
+
+  @retval EFI_SUCCESS            The block is saved or dropped.
+  @retval EFI_ABORTED            The user aborted the download through
+                                 CheckPacket.
+
+**/
+EFI_STATUS
+Mtftp6RrqSaveAheadBlock (
+  IN  MTFTP6_INSTANCE    *Instance,
+  IN  EFI_MTFTP6_PACKET  *Packet,
+  IN  UINT32             Len,
+  IN  UINT16             Offset,
+  OUT NET_BUF            **UdpPacket
+  )
+{
+  EFI_MTFTP6_TOKEN  *Token;
+  EFI_STATUS        Status;
+  UINT64            Bit;
+  UINT64            Start;
+  UINT32            DataLen;
+
+  Token   = Instance->Token;
+  DataLen = Len - MTFTP6_DATA_HEAD_LEN;
+
+  if ((Token->Buffer == NULL) || (Instance->McastUdpIo != NULL) ||
+      (DataLen != Instance->BlkSize) || (Offset == 0) ||
+      (Offset >= Instance->WindowSize) || (Offset > MTFTP6_MAX_AHEAD_BLOCKS))
+  {
+    return EFI_SUCCESS;
+  }
+
+  Bit = LShiftU64 (1, Offset - 1);
+  if ((Instance->AheadBlocks & Bit) != 0) {
+    Instance->DupBlocks++;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The next expected block is the (TotalBlock + 1)th block of the file.
+  //
+  Start = MultU64x32 (Instance->TotalBlock + Offset, Instance->BlkSize);
+  if (Start + DataLen > Token->BufferSize) {
+    return EFI_SUCCESS;
+  }
+
+  if (Token->CheckPacket != NULL) {
+    Status = Token->CheckPacket (&Instance->Mtftp6, Token, (UINT16)Len, Packet);
+
+    if (EFI_ERROR (Status)) {
+      //
+      // Free the received packet before send new packet in ReceiveNotify,
+      // since the Udp6Io might need to be reconfigured.
+      //
+      NetbufFree (*UdpPacket);
+      *UdpPacket = NULL;
+
+      Mtftp6SendError (
+        Instance,
+        EFI_MTFTP6_ERRORCODE_ILLEGAL_OPERATION,
+        (UINT8 *)"User aborted download"
+        );
+
+      return EFI_ABORTED;
+    }
+  }
+
+  CopyMem ((UINT8 *)Token->Buffer + Start, Packet->Data.Data, DataLen);
+
+  Instance->AheadBlocks |= Bit;
+  Instance->AheadSaved++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Remove the blocks saved ahead of time that follow the block just
+  received from the file hole, they don't need to be received again.
+
+  @param[in]  Instance           The pointer to the Mtftp6 instance.
+
+  @return The number of blocks removed.
+
+**/
+UINT32
+Mtftp6RrqDrainAheadBlocks (
+  IN MTFTP6_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  INTN        Next;
+  UINT64      BlockCounter;
+  BOOLEAN     Present;
+  UINT32      Drained;
+
+  Drained = 0;
+
+  while (Instance->AheadBlocks != 0) {
+    Present               = (BOOLEAN)((Instance->AheadBlocks & 1) != 0);
+    Instance->AheadBlocks = RShiftU64 (Instance->AheadBlocks, 1);
+
+    if (!Present) {
+      break;
+    }
+
+    Next = Mtftp6GetNextBlockNum (&Instance->BlkList);
+    ASSERT (Next >= 0);
+
+    Status = Mtftp6RemoveBlockNum (&Instance->BlkList, (UINT16)Next, FALSE, &BlockCounter);
+    ASSERT_EFI_ERROR (Status);
+
+    Instance->TotalBlock++;
+    Drained++;
+  }
+
+  return Drained;
+}
+
 /**
   Process the received data packets. It will save the block
   then send back an ACK if it is active.
@@ -220,20 +350,47 @@ Mtftp6RrqHandleData (
   EFI_STATUS  Status;
   UINT16      BlockNum;
   INTN        Expected;
+  UINT16      Offset;
+  UINT32      Drained;
 
   *IsCompleted = FALSE;
   Status       = EFI_SUCCESS;
+  Drained      = 0;
   BlockNum     = NTOHS (Packet->Data.Block);
   Expected     = Mtftp6GetNextBlockNum (&Instance->BlkList);
 
   ASSERT (Expected >= 0);
 
+  Instance->ElapsedTicks += GetElapsedTicks (&Instance->LastTick);
+
   //
   // If we are active (Master) and received an unexpected packet, transmit
   // the ACK for the block we received, then restart receiving the
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->IsMaster && (Expected != BlockNum)) {
+    //
+    // In a windowed download, keep the blocks after the hole and report
+    // the hole only once. Every ACK makes the server restart its window,
+    // acking each block behind the hole would resend the data many times.
+    // A duplicate or old block may mean that our last ACK was lost, so it
+    // falls through and that ACK is sent again.
+    //
+    if (Instance->WindowSize > 1) {
+      Offset = (UINT16)(BlockNum - Expected);
+      if (Offset >= Instance->WindowSize) {
+        Instance->DupBlocks++;
+      } else {
+        Status = Mtftp6RrqSaveAheadBlock (Instance, Packet, Len, Offset, UdpPacket);
+        if (EFI_ERROR (Status) || Instance->GapAcked) {
+          return Status;
+        }
+
+        Instance->GapAcked = TRUE;
+        Instance->GapAcks++;
+      }
+    }
+
     //
     // Free the received packet before send new packet in ReceiveNotify,
     // since the udpio might need to be reconfigured.
@@ -258,6 +415,11 @@ Mtftp6RrqHandleData (
   //
   Instance->TotalBlock++;
 
+  if (Instance->IsMaster) {
+    Instance->GapAcked = FALSE;
+    Drained            = Mtftp6RrqDrainAheadBlocks (Instance);
+  }
+
   //
   // Reset the passive client's timer whenever it received a valid data packet.
   //
@@ -294,7 +456,11 @@ Mtftp6RrqHandleData (
     NetbufFree (*UdpPacket);
     *UdpPacket = NULL;
 
-    if ((Instance->WindowSize == (Instance->TotalBlock - Instance->AckedBlock)) || (Expected < 0)) {
+    //
+    // Ack at the end of each window. When the hole has just been filled
+    // by the kept blocks, ack at once so that the server skips them.
+    //
+    if ((Instance->WindowSize <= (Instance->TotalBlock - Instance->AckedBlock)) || (Drained != 0) || (Expected < 0)) {
       Status = Mtftp6RrqSendAck (Instance, BlockNum);
     }
   }
@@ -898,6 +898,28 @@ Mtftp6OperationClean (
   LIST_ENTRY          *Entry;
   LIST_ENTRY          *Next;
   MTFTP6_BLOCK_RANGE  *Block;
+  UINT64              ElapsedUs;
+
+  if (((Instance->Operation == EFI_MTFTP6_OPCODE_RRQ) ||
+       (Instance->Operation == EFI_MTFTP6_OPCODE_DIR)) &&
+      (Instance->TotalBlock != 0))
+  {
+    Instance->ElapsedTicks += GetElapsedTicks (&Instance->LastTick);
+    ElapsedUs               = DivU64x32 (GetTimeInNanoSecond (Instance->ElapsedTicks), 1000);
+    DEBUG ((
+      DEBUG_INFO,
+      "Mtftp6OperationClean: %lu blocks of %u bytes in %lu ms, %lu KB/s, window %u, %u kept out of order, %u duplicates, %u gap ACKs, %r\n",
+      Instance->TotalBlock,
+      (UINT32)Instance->BlkSize,
+      DivU64x32 (ElapsedUs, 1000),
+      (ElapsedUs == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Instance->TotalBlock, Instance->BlkSize * 1000), ElapsedUs, NULL),
+      (UINT32)Instance->WindowSize,
+      Instance->AheadSaved,
+      Instance->DupBlocks,
+      Instance->GapAcks,
+      Result
+      ));
+  }
 
   //
   // Clean up the current token and event.
@@ -958,6 +980,12 @@ Mtftp6OperationClean (
   Instance->WindowSize     = 1;
   Instance->TotalBlock     = 0;
   Instance->AckedBlock     = 0;
+  Instance->AheadBlocks    = 0;
+  Instance->GapAcked       = FALSE;
+  Instance->AheadSaved     = 0;
+  Instance->DupBlocks      = 0;
+  Instance->GapAcks        = 0;
+  Instance->ElapsedTicks   = 0;
   Instance->LastBlk        = 0;
   Instance->PacketToLive   = 0;
   Instance->MaxRetry       = 0;
@@ -1059,6 +1087,7 @@ Mtftp6OperationStart (
   Instance->MaxRetry       = Instance->Config->TryCount;
   Instance->Timeout        = Instance->Config->TimeoutValue;
   Instance->IsMaster       = TRUE;
+  Instance->LastTick       = GetPerformanceCounter ();
 
   CopyMem (
     &Instance->ServerIp,
@@ -0,0 +1,402 @@
+/** @file
+  Tests for the SACK support in TcpOption.c and TcpSack.c.
+
+  The loss tests replay the ACK stream a receiver produces when some
+  segments of a window are dropped on the link, and check which data
+  the sender chooses to retransmit.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_ISS  0x1000
+#define TEST_MSS  1000
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+UINT32  mTcpTick = 1000;
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+//
+// Build a TCP header followed by the given option bytes.
+//
+static TCP_HEAD *
+BuildHead (
+  UINT8        *Buffer,
+  const UINT8  *Option,
+  UINT8        OptionLen
+  )
+{
+  TCP_HEAD  *Head;
+
+  Head = (TCP_HEAD *)Buffer;
+  ZeroMem (Head, sizeof (TCP_HEAD));
+  Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + OptionLen) >> 2);
+  CopyMem (Head + 1, Option, OptionLen);
+  return Head;
+}
+
+class TcpSackTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  SOCKET Sock;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Sock, sizeof (Sock));
+    InitializeListHead (&Tcb.SndQue);
+    InitializeListHead (&Tcb.RcvQue);
+
+    Sock.RcvBuffer.HighWater = 0x10000;
+    Tcb.Sk                   = &Sock;
+    Tcb.SndMss               = TEST_MSS;
+    Tcb.RcvMss               = TEST_MSS;
+    Tcb.SndUna               = TEST_ISS;
+    Tcb.SndNxt               = TEST_ISS + 10 * TEST_MSS;
+    Tcb.SackHighRxt          = TEST_ISS;
+    Tcb.RcvNxt               = TEST_ISS;
+    TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_SND_SACK);
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    NetbufFreeList (&Tcb.RcvQue);
+  }
+
+  //
+  // Queue a received out-of-order segment on the RcvQue, the list
+  // is kept sorted as TcpQueueData () does.
+  //
+  void
+  QueueRcv (
+    TCP_SEQNO  Seq,
+    UINT32     Len
+    )
+  {
+    NET_BUF     *Nbuf;
+    LIST_ENTRY  *Entry;
+
+    Nbuf = NetbufAlloc (Len);
+    ASSERT_NE (Nbuf, nullptr);
+    NetbufAllocSpace (Nbuf, Len, NET_BUF_TAIL);
+
+    TCPSEG_NETBUF (Nbuf)->Seq = Seq;
+    TCPSEG_NETBUF (Nbuf)->End = Seq + Len;
+
+    for (Entry = Tcb.RcvQue.ForwardLink; Entry != &Tcb.RcvQue; Entry = Entry->ForwardLink) {
+      if (TCP_SEQ_LT (Seq, TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Seq)) {
+        break;
+      }
+    }
+
+    InsertTailList (Entry, &Nbuf->List);
+    Tcb.SackRcvLast = Seq;
+  }
+
+  //
+  // Feed an ACK carrying the given SACK blocks to the scoreboard.
+  //
+  void
+  ReceiveSack (
+    const TCP_SACK_BLOCK  *Block,
+    UINT8                 Num
+    )
+  {
+    TCP_OPTION  Option;
+
+    ZeroMem (&Option, sizeof (Option));
+    Option.Flag    = TCP_OPTION_RCVD_SACK;
+    Option.SackNum = Num;
+    CopyMem (Option.SackBlock, Block, Num * sizeof (TCP_SACK_BLOCK));
+    TcpSackUpdateScoreboard (&Tcb, &Option);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Option parsing
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// The SACK permitted option in a SYN is recognized.
+TEST_F (TcpSackTest, ParseSackPermitted) {
+  UINT8               Buffer[64];
+  static const UINT8  Opt[] = { TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_SACK_PERM, TCP_OPTION_SACK_PERM_LEN };
+  TCP_OPTION          Option;
+
+  ASSERT_EQ (TcpParseOption (BuildHead (Buffer, Opt, sizeof (Opt)), &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+  EXPECT_EQ (Option.SackNum, 0);
+}
+
+// Test Description:
+// SACK blocks following a timestamp option are parsed in order.
+TEST_F (TcpSackTest, ParseSackBlocks) {
+  UINT8               Buffer[64];
+  static const UINT8  Opt[] = {
+    TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_TS,   TCP_OPTION_TS_LEN,
+    0x00,           0x00,           0x00,            0x01,
+    0x00,           0x00,           0x00,            0x02,
+    TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_SACK, 2 + 2 * TCP_OPTION_SACK_BLOCK_LEN,
+    0x00,           0x00,           0x17,            0x70,
+    0x00,           0x00,           0x1b,            0x58,
+    0x00,           0x00,           0x1f,            0x40,
+    0x00,           0x00,           0x23,            0x28
+  };
+  TCP_OPTION          Option;
+
+  ASSERT_EQ (TcpParseOption (BuildHead (Buffer, Opt, sizeof (Opt)), &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS));
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+  ASSERT_EQ (Option.SackNum, 2);
+  EXPECT_EQ (Option.SackBlock[0].Left, 0x1770u);
+  EXPECT_EQ (Option.SackBlock[0].Right, 0x1b58u);
+  EXPECT_EQ (Option.SackBlock[1].Left, 0x1f40u);
+  EXPECT_EQ (Option.SackBlock[1].Right, 0x2328u);
+}
+
+// Test Description:
+// A SACK option whose length is not a multiple of the block size is rejected.
+TEST_F (TcpSackTest, ParseMalformedSack) {
+  UINT8               Buffer[64];
+  static const UINT8  Opt[] = {
+    TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_SACK, 6,
+    0x00,           0x00,           0x17,            0x70
+  };
+  TCP_OPTION          Option;
+
+  EXPECT_EQ (TcpParseOption (BuildHead (Buffer, Opt, sizeof (Opt)), &Option), -1);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Option building
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// An active open advertises SACK permitted, and the peer can parse it back.
+TEST_F (TcpSackTest, SynAdvertisesSackPermitted) {
+  NET_BUF     *Nbuf;
+  TCP_HEAD    *Head;
+  UINT16      Len;
+  UINT8       Buffer[64];
+  TCP_OPTION  Option;
+
+  Nbuf = NetbufAlloc (TCP_MAX_HEAD);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufReserve (Nbuf, TCP_MAX_HEAD);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN;
+
+  Len = TcpSynBuildOption (&Tcb, Nbuf);
+  ASSERT_LE (Len, 40);
+
+  Head = (TCP_HEAD *)Buffer;
+  ZeroMem (Head, sizeof (TCP_HEAD));
+  Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+  NetbufCopy (Nbuf, 0, Len, (UINT8 *)(Head + 1));
+
+  ASSERT_EQ (TcpParseOption (Head, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_MSS));
+
+  NetbufFree (Nbuf);
+}
+
+// Test Description:
+// A pure ACK reports the queued out-of-order data, latest block first,
+// and leaves room for the timestamp option.
+TEST_F (TcpSackTest, AckReportsOutOfOrderData) {
+  NET_BUF     *Nbuf;
+  TCP_HEAD    *Head;
+  UINT16      Len;
+  UINT8       Buffer[64];
+  TCP_OPTION  Option;
+
+  QueueRcv (TEST_ISS + 2 * TEST_MSS, TEST_MSS);
+  QueueRcv (TEST_ISS + 3 * TEST_MSS, TEST_MSS);
+  QueueRcv (TEST_ISS + 5 * TEST_MSS, TEST_MSS);
+  QueueRcv (TEST_ISS + 7 * TEST_MSS, TEST_MSS);
+  QueueRcv (TEST_ISS + 9 * TEST_MSS, TEST_MSS);
+  Tcb.SackRcvLast = TEST_ISS + 7 * TEST_MSS;
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_SND_TS);
+
+  Nbuf = NetbufAlloc (TCP_MAX_HEAD);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufReserve (Nbuf, TCP_MAX_HEAD);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_ACK;
+
+  Len = TcpBuildOption (&Tcb, Nbuf);
+  EXPECT_EQ (Len, TCP_OPTION_TS_ALIGNED_LEN + 4 + 3 * TCP_OPTION_SACK_BLOCK_LEN);
+
+  Head = (TCP_HEAD *)Buffer;
+  ZeroMem (Head, sizeof (TCP_HEAD));
+  Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+  NetbufCopy (Nbuf, 0, Len, (UINT8 *)(Head + 1));
+
+  ASSERT_EQ (TcpParseOption (Head, &Option), 0);
+  ASSERT_EQ (Option.SackNum, 3);
+  EXPECT_EQ (Option.SackBlock[0].Left, (UINT32)(TEST_ISS + 7 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[1].Left, (UINT32)(TEST_ISS + 2 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[1].Right, (UINT32)(TEST_ISS + 4 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[2].Left, (UINT32)(TEST_ISS + 5 * TEST_MSS));
+
+  NetbufFree (Nbuf);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Scoreboard
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// Overlapping and adjacent blocks are merged, invalid ones are ignored.
+TEST_F (TcpSackTest, ScoreboardMergesBlocks) {
+  TCP_SACK_BLOCK  Block[4];
+
+  Block[0].Left  = TEST_ISS + 4 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 5 * TEST_MSS;
+  Block[1].Left  = TEST_ISS + 2 * TEST_MSS;
+  Block[1].Right = TEST_ISS + 3 * TEST_MSS;
+  Block[2].Left  = TEST_ISS + 9 * TEST_MSS;
+  Block[2].Right = TEST_ISS + 11 * TEST_MSS; // Beyond SND.NXT
+  ReceiveSack (Block, 3);
+
+  ASSERT_EQ (Tcb.SackNum, 2);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, (UINT32)(TEST_ISS + 2 * TEST_MSS));
+  EXPECT_EQ (Tcb.SackBlock[1].Left, (UINT32)(TEST_ISS + 4 * TEST_MSS));
+
+  Block[0].Left  = TEST_ISS + 3 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 4 * TEST_MSS;
+  ReceiveSack (Block, 1);
+
+  ASSERT_EQ (Tcb.SackNum, 1);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, (UINT32)(TEST_ISS + 2 * TEST_MSS));
+  EXPECT_EQ (Tcb.SackBlock[0].Right, (UINT32)(TEST_ISS + 5 * TEST_MSS));
+  EXPECT_EQ (TcpSackedBytes (&Tcb), (UINT32)(3 * TEST_MSS));
+}
+
+// Test Description:
+// The cumulative ACK trims the scoreboard.
+TEST_F (TcpSackTest, ScoreboardTrimmedByAck) {
+  TCP_SACK_BLOCK  Block[2];
+
+  Block[0].Left  = TEST_ISS + 2 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 4 * TEST_MSS;
+  Block[1].Left  = TEST_ISS + 6 * TEST_MSS;
+  Block[1].Right = TEST_ISS + 7 * TEST_MSS;
+  ReceiveSack (Block, 2);
+
+  TcpSackTrimScoreboard (&Tcb, TEST_ISS + 3 * TEST_MSS);
+  ASSERT_EQ (Tcb.SackNum, 2);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, (UINT32)(TEST_ISS + 3 * TEST_MSS));
+
+  TcpSackTrimScoreboard (&Tcb, TEST_ISS + 5 * TEST_MSS);
+  ASSERT_EQ (Tcb.SackNum, 1);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, (UINT32)(TEST_ISS + 6 * TEST_MSS));
+
+  TcpSackClearScoreboard (&Tcb);
+  EXPECT_EQ (Tcb.SackNum, 0);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Loss recovery
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// Segments 1, 4 and 6 of a ten segment window are lost. The receiver
+// SACKs everything else, and the sender finds exactly the three holes,
+// in order, without retransmitting data the peer already holds. The
+// unSACKed tail is not considered lost.
+TEST_F (TcpSackTest, MultipleLossesInOneWindow) {
+  TCP_SACK_BLOCK       Block[3];
+  TCP_SEQNO            Seq;
+  UINT32               Len;
+  UINT32               Index;
+  TCP_SEQNO            From;
+  static const UINT32  Lost[] = { 1, 4, 6 };
+
+  //
+  // Segment 0 is ACKed, the receiver then reports what arrived
+  // after each hole, the most recent block first.
+  //
+  Tcb.SndUna = TEST_ISS + TEST_MSS;
+
+  Block[0].Left  = TEST_ISS + 2 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 4 * TEST_MSS;
+  ReceiveSack (Block, 1);
+
+  Block[0].Left  = TEST_ISS + 5 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 6 * TEST_MSS;
+  Block[1].Left  = TEST_ISS + 2 * TEST_MSS;
+  Block[1].Right = TEST_ISS + 4 * TEST_MSS;
+  ReceiveSack (Block, 2);
+
+  Block[0].Left  = TEST_ISS + 7 * TEST_MSS;
+  Block[0].Right = TEST_ISS + 9 * TEST_MSS;
+  Block[1].Left  = TEST_ISS + 5 * TEST_MSS;
+  Block[1].Right = TEST_ISS + 6 * TEST_MSS;
+  Block[2].Left  = TEST_ISS + 2 * TEST_MSS;
+  Block[2].Right = TEST_ISS + 4 * TEST_MSS;
+  ReceiveSack (Block, 3);
+
+  ASSERT_EQ (Tcb.SackNum, 3);
+  EXPECT_GT (TcpSackedBytes (&Tcb), (UINT32)(3 * TEST_MSS));
+
+  From = Tcb.SndUna;
+  for (Index = 0; Index < ARRAY_SIZE (Lost); Index++) {
+    ASSERT_TRUE (TcpSackNextHole (&Tcb, From, &Seq, &Len));
+    EXPECT_EQ (Seq, (UINT32)(TEST_ISS + Lost[Index] * TEST_MSS));
+    EXPECT_EQ (Len, (UINT32)TEST_MSS);
+    From = Seq + Len;
+  }
+
+  EXPECT_FALSE (TcpSackNextHole (&Tcb, From, &Seq, &Len));
+
+  //
+  // The retransmission of segment 1 arrives, the partial ACK moves
+  // SND.UNA to the next hole.
+  //
+  TcpSackTrimScoreboard (&Tcb, TEST_ISS + 4 * TEST_MSS);
+  Tcb.SndUna = TEST_ISS + 4 * TEST_MSS;
+  ASSERT_TRUE (TcpSackNextHole (&Tcb, Tcb.SndUna, &Seq, &Len));
+  EXPECT_EQ (Seq, (UINT32)(TEST_ISS + 4 * TEST_MSS));
+}
+
+// Test Description:
+// A full scoreboard keeps the lowest blocks, which are the ones that
+// describe the holes to be repaired first.
+TEST_F (TcpSackTest, ScoreboardOverflowKeepsLowestBlocks) {
+  TCP_SACK_BLOCK  Block;
+  UINT32          Index;
+
+  Tcb.SndNxt = TEST_ISS + 40 * TEST_MSS;
+
+  for (Index = TCP_SACK_SCOREBOARD_SIZE + 2; Index > 0; Index--) {
+    Block.Left  = TEST_ISS + (2 * Index) * TEST_MSS;
+    Block.Right = Block.Left + TEST_MSS;
+    ReceiveSack (&Block, 1);
+  }
+
+  ASSERT_EQ (Tcb.SackNum, TCP_SACK_SCOREBOARD_SIZE);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, (UINT32)(TEST_ISS + 2 * TEST_MSS));
+  EXPECT_EQ (Tcb.SackBlock[TCP_SACK_SCOREBOARD_SIZE - 1].Left, (UINT32)(TEST_ISS + 2 * TCP_SACK_SCOREBOARD_SIZE * TEST_MSS));
+}
@@ -493,6 +493,100 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Build the SACK blocks that describe the out-of-order data queued
+  in the Tcb's RcvQue. The block holding the most recently received
+  segment is reported first.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the SACK blocks.
+  @param[in]   MaxNum    The maximum number of blocks to build.
+
+  @return The number of blocks stored in Block.
+
+**/
+UINT8
+TcpSackBuildRcvBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxNum
+  );
+
+/**
+  Update the sender's scoreboard with the SACK blocks received
+  from the peer.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Option    Pointer to the options of the incoming segment.
+
+**/
+VOID
+TcpSackUpdateScoreboard (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Remove the part of the scoreboard that is cumulatively acknowledged.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack       The new SND.UNA.
+
+**/
+VOID
+TcpSackTrimScoreboard (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack
+  );
+
+/**
+  Discard the scoreboard.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClearScoreboard (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Get the number of bytes selectively acknowledged by the peer.
+
+  @param[in]  Tcb       Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes in the scoreboard.
+
+**/
+UINT32
+TcpSackedBytes (
+  IN TCP_CB  *Tcb
+  );
+
+/**
+  Find the next hole in the scoreboard to retransmit.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]   From      The sequence number to start the search from.
+  @param[out]  Seq       The first sequence number of the hole.
+  @param[out]  Len       The length of the hole.
+
+  @retval TRUE           A hole is found.
+  @retval FALSE          There is no hole at or above From.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB     *Tcb,
+  IN  TCP_SEQNO  From,
+  OUT TCP_SEQNO  *Seq,
+  OUT UINT32     *Len
+  );
+
 //
 // Functions in TcpTimer.c
 //
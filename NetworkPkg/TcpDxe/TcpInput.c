@@ -30,7 +30,44 @@ TcpSeqAcceptable (
 }
 
 /**
-  NewReno fast recovery defined in RFC3782.
+  Retransmit the next hole of the SACK scoreboard, in the spirit
+  of the NextSeg () of RFC6675. One segment is sent for each ACK
+  received during the fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledgment number of the incoming segment.
+
+  @retval TRUE     A hole is retransmitted.
+  @retval FALSE    No hole is left to retransmit.
+
+**/
+BOOLEAN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+
+  if (!TcpSackNextHole (Tcb, TCP_SEQ_GT (Tcb->SackHighRxt, Ack) ? Tcb->SackHighRxt : Ack, &Seq, &Len)) {
+    return FALSE;
+  }
+
+  if (TcpRetransmit (Tcb, Seq) != 0) {
+    return FALSE;
+  }
+
+  Tcb->SackHighRxt = Seq + MIN (Len, Tcb->SndMss);
+  Tcb->SackRetxmits++;
+
+  return TRUE;
+}
+
+/**
+  NewReno fast recovery defined in RFC3782. When SACK is negotiated,
+  the retransmissions are driven by the scoreboard instead, so that
+  several losses in one window are repaired in one round trip.
 
   @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
   @param[in]       Seg      Segment that triggers the fast recovery.
@@ -59,12 +96,14 @@ TcpFastRecover (
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+    Tcb->FastRetxmits++;
 
     //
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd        = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackHighRxt = Tcb->SndUna + Tcb->SndMss;
 
     DEBUG (
       (DEBUG_NET,
@@ -88,6 +127,11 @@ TcpFastRecover (
     // by TcpToSendData
     //
     Tcb->CWnd += Tcb->SndMss;
+
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+      TcpSackRetransmit (Tcb, Seg->Ack);
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +163,15 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, the next hole
+      // not yet retransmitted is sent instead.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+          (!TcpSackRetransmit (Tcb, Seg->Ack) && TCP_SEQ_GEQ (Seg->Ack, Tcb->SackHighRxt)))
+      {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -1213,6 +1263,8 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  TcpSackUpdateScoreboard (Tcb, &Option);
+
   //
   // Count duplicate acks.
   //
@@ -1226,6 +1278,19 @@ TcpInput (
     Tcb->DupAck = 0;
   }
 
+  //
+  // With SACK, also start the fast retransmission when more than
+  // three segments above SND.UNA are SACKed, as in IsLost () of
+  // RFC6675, even if some duplicate ACKs were lost or reordered.
+  //
+  if ((Tcb->CongestState == TCP_CONGEST_OPEN) &&
+      (Tcb->DupAck != 0) &&
+      (Tcb->DupAck < 3) &&
+      (TcpSackedBytes (Tcb) > (UINT32)(3 * Tcb->SndMss)))
+  {
+    Tcb->DupAck = 3;
+  }
+
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
@@ -1261,6 +1326,7 @@ TcpInput (
     }
 
     Tcb->SndUna = Seg->Ack;
+    TcpSackTrimScoreboard (Tcb, Seg->Ack);
 
     if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_URG) &&
         TCP_SEQ_LT (Tcb->SndUp, Seg->Ack))
@@ -1477,6 +1543,13 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      //
+      // Out-of-order data, it goes first in the SACK option.
+      //
+      Tcb->SackRcvLast = Seg->Seq;
+    }
+
     if (TcpQueueData (Tcb, Nbuf) == 0) {
       DEBUG (
         (DEBUG_ERROR,
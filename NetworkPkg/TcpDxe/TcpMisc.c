@@ -140,6 +140,9 @@ TcpInitTcbLocal (
   Tcb->RcvWndScale   = 0;
   Tcb->RetxmitSeqMax = 0;
 
+  Tcb->SackNum     = 0;
+  Tcb->SackHighRxt = Tcb->Iss;
+
   Tcb->ProbeTimerOn = FALSE;
 
   return EFI_SUCCESS;
@@ -221,6 +224,13 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_SACK);
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+
+    Tcb->SackRcvLast = Tcb->RcvNxt;
+  }
 }
 
 /**
@@ -833,6 +843,20 @@ TcpSetState (
 
     case TCP_CLOSED:
 
+      DEBUG (
+        (DEBUG_INFO,
+         "Tcb (%p) closed: cwnd %u, ssthresh %u, srtt %ums, rto %ums, %u retransmits, %u fast retransmits, %u SACK retransmits, %u timeouts\n",
+         Tcb,
+         Tcb->CWnd,
+         Tcb->Ssthresh,
+         (Tcb->SRtt * TCP_TICK) >> TCP_RTT_SHIFT,
+         Tcb->Rto * TCP_TICK,
+         Tcb->RetxmitSegs,
+         Tcb->FastRetxmits,
+         Tcb->SackRetxmits,
+         Tcb->RtoTimeouts)
+        );
+
       SockConnClosed (Tcb->Sk);
 
       break;
@@ -692,6 +692,8 @@ TcpRetransmit (
     Tcb->RetxmitSeqMax = Seq;
   }
 
+  Tcb->RetxmitSegs++;
+
   //
   // The retransmitted buffer may be on the SndQue,
   // trim TCP head because all the buffers on SndQue
@@ -70,6 +70,9 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable selective acknowledgment.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK-permitted option in syn.
+#define TCP_CTRL_SND_SACK      0x20000  ///< SACK is negotiated on this connection.
 
 //
 // Timer related values
@@ -204,6 +207,13 @@
 
 #define TCP_MAX_WIN  0xFFFFU
 
+//
+// Number of SACK blocks the sender keeps in its scoreboard. The peer
+// reports at most four blocks per segment, older blocks are merged or
+// dropped once the scoreboard is full.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  8
+
 ///
 /// TCP segmentation data.
 ///
@@ -224,6 +234,14 @@ typedef struct _TCP_PEER {
   TCP_PORTNO        Port; ///< Port number, in network byte order.
 } TCP_PEER;
 
+///
+/// A SACK block, [Left, Right) of the sequence space.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number following the last byte of the block.
+} TCP_SACK_BLOCK;
+
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
 ///
@@ -312,6 +330,25 @@ struct _TCP_CONTROL_BLOCK {
   //
   TCP_SEQNO           RetxmitSeqMax;     ///< Max Seq number in previous retransmission.
 
+  //
+  // RFC2018 and RFC6675 variables.
+  // SACK scoreboard of the sender, sorted by sequence number and
+  // never overlapping, plus the receiver's most recent out-of-order
+  // arrival that must be reported in the first SACK block.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE];
+  UINT8               SackNum;     ///< Number of valid blocks in SackBlock.
+  TCP_SEQNO           SackHighRxt; ///< Highest sequence retransmitted in recovery.
+  TCP_SEQNO           SackRcvLast; ///< Start of the latest out-of-order segment.
+
+  //
+  // Per-connection statistics, reported when the connection is closed.
+  //
+  UINT32              RetxmitSegs;  ///< Total number of retransmitted segments.
+  UINT32              FastRetxmits; ///< Number of fast retransmission episodes.
+  UINT32              SackRetxmits; ///< Number of segments retransmitted from SACK holes.
+  UINT32              RtoTimeouts;  ///< Number of retransmission timeouts.
+
   //
   // configuration parameters, for EFI_TCP4_PROTOCOL specification
   //
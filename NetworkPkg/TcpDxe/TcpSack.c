@@ -0,0 +1,381 @@
+/** @file
+  Selective acknowledgment (SACK) routines, as defined in RFC2018
+  and the loss recovery algorithm of RFC6675.
+
+  The receiver side reports the out-of-order data held in the
+  reassemble queue. The sender side keeps a scoreboard of the
+  blocks reported by the peer, so that only the holes are
+  retransmitted during fast recovery.
+
+  Copyright (c) 2009 - 2018, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Build the SACK blocks that describe the out-of-order data queued
+  in the Tcb's RcvQue. The block holding the most recently received
+  segment is reported first, the other blocks follow in sequence
+  order, as required by RFC2018 section 4.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the SACK blocks.
+  @param[in]   MaxNum    The maximum number of blocks to build.
+
+  @return The number of blocks stored in Block.
+
+**/
+UINT8
+TcpSackBuildRcvBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxNum
+  )
+{
+  LIST_ENTRY      *Entry;
+  NET_BUF         *Node;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Latest;
+  TCP_SACK_BLOCK  Current;
+  BOOLEAN         Started;
+  BOOLEAN         FoundLatest;
+  UINT8           Num;
+
+  ASSERT ((Tcb != NULL) && (Block != NULL));
+
+  if ((MaxNum == 0) || IsListEmpty (&Tcb->RcvQue)) {
+    return 0;
+  }
+
+  //
+  // Coalesce the adjacent segments into blocks. Segments on
+  // the RcvQue are sorted by sequence and never overlap.
+  //
+  Num         = 0;
+  Started     = FALSE;
+  FoundLatest = FALSE;
+  ZeroMem (&Latest, sizeof (Latest));
+  ZeroMem (&Current, sizeof (Current));
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->RcvQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_LEQ (Seg->End, Tcb->RcvNxt)) {
+      continue;
+    }
+
+    if (Started && TCP_SEQ_LEQ (Seg->Seq, Current.Right)) {
+      if (TCP_SEQ_GT (Seg->End, Current.Right)) {
+        Current.Right = Seg->End;
+      }
+
+      continue;
+    }
+
+    if (Started) {
+      if (!FoundLatest && TCP_SEQ_BETWEEN (Current.Left, Tcb->SackRcvLast, Current.Right - 1)) {
+        CopyMem (&Latest, &Current, sizeof (TCP_SACK_BLOCK));
+        FoundLatest = TRUE;
+      } else if (Num < MaxNum) {
+        CopyMem (&Block[Num++], &Current, sizeof (TCP_SACK_BLOCK));
+      }
+    }
+
+    Current.Left  = TCP_SEQ_LT (Seg->Seq, Tcb->RcvNxt) ? Tcb->RcvNxt : Seg->Seq;
+    Current.Right = Seg->End;
+    Started       = TRUE;
+  }
+
+  if (Started) {
+    if (!FoundLatest && TCP_SEQ_BETWEEN (Current.Left, Tcb->SackRcvLast, Current.Right - 1)) {
+      CopyMem (&Latest, &Current, sizeof (TCP_SACK_BLOCK));
+      FoundLatest = TRUE;
+    } else if (Num < MaxNum) {
+      CopyMem (&Block[Num++], &Current, sizeof (TCP_SACK_BLOCK));
+    }
+  }
+
+  if (FoundLatest) {
+    if (Num == MaxNum) {
+      Num--;
+    }
+
+    CopyMem (&Block[1], &Block[0], Num * sizeof (TCP_SACK_BLOCK));
+    CopyMem (&Block[0], &Latest, sizeof (TCP_SACK_BLOCK));
+    Num++;
+  }
+
+  return Num;
+}
+
+/**
+  Insert one SACK block reported by the peer into the scoreboard,
+  merging it with the blocks it overlaps or touches.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left      The left edge of the block.
+  @param[in]       Right     The right edge of the block.
+
+**/
+STATIC
+VOID
+TcpSackInsertBlock (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  UINT8  Index;
+  UINT8  Next;
+
+  //
+  // Find the first block whose right edge reaches the new block.
+  //
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_GEQ (Tcb->SackBlock[Index].Right, Left)) {
+      break;
+    }
+  }
+
+  if ((Index < Tcb->SackNum) && TCP_SEQ_LEQ (Tcb->SackBlock[Index].Left, Right)) {
+    //
+    // Overlapping: extend the block, then absorb any following
+    // blocks now covered by it.
+    //
+    if (TCP_SEQ_LT (Left, Tcb->SackBlock[Index].Left)) {
+      Tcb->SackBlock[Index].Left = Left;
+    }
+
+    if (TCP_SEQ_GT (Right, Tcb->SackBlock[Index].Right)) {
+      Tcb->SackBlock[Index].Right = Right;
+    }
+
+    Next = (UINT8)(Index + 1);
+    while ((Next < Tcb->SackNum) &&
+           TCP_SEQ_LEQ (Tcb->SackBlock[Next].Left, Tcb->SackBlock[Index].Right))
+    {
+      if (TCP_SEQ_GT (Tcb->SackBlock[Next].Right, Tcb->SackBlock[Index].Right)) {
+        Tcb->SackBlock[Index].Right = Tcb->SackBlock[Next].Right;
+      }
+
+      Next++;
+    }
+
+    if (Next > Index + 1) {
+      CopyMem (
+        &Tcb->SackBlock[Index + 1],
+        &Tcb->SackBlock[Next],
+        (Tcb->SackNum - Next) * sizeof (TCP_SACK_BLOCK)
+        );
+      Tcb->SackNum = (UINT8)(Tcb->SackNum - (Next - Index - 1));
+    }
+
+    return;
+  }
+
+  //
+  // A new block. When the scoreboard is full, drop the highest
+  // block, the peer will report it again if it is still valid.
+  //
+  if (Tcb->SackNum == TCP_SACK_SCOREBOARD_SIZE) {
+    if (Index == TCP_SACK_SCOREBOARD_SIZE) {
+      return;
+    }
+
+    Tcb->SackNum--;
+  }
+
+  CopyMem (
+    &Tcb->SackBlock[Index + 1],
+    &Tcb->SackBlock[Index],
+    (Tcb->SackNum - Index) * sizeof (TCP_SACK_BLOCK)
+    );
+
+  Tcb->SackBlock[Index].Left  = Left;
+  Tcb->SackBlock[Index].Right = Right;
+  Tcb->SackNum++;
+}
+
+/**
+  Update the sender's scoreboard with the SACK blocks received
+  from the peer. Blocks outside of [SND.UNA, SND.NXT] are invalid
+  and ignored.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Option    Pointer to the options of the incoming segment.
+
+**/
+VOID
+TcpSackUpdateScoreboard (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_OPTION  *Option
+  )
+{
+  UINT8      Index;
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+
+  ASSERT ((Tcb != NULL) && (Option != NULL));
+
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+      !TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK))
+  {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    Left  = Option->SackBlock[Index].Left;
+    Right = Option->SackBlock[Index].Right;
+
+    if (TCP_SEQ_GEQ (Left, Right) || TCP_SEQ_GT (Right, Tcb->SndNxt)) {
+      continue;
+    }
+
+    //
+    // A block at or below SND.UNA is a D-SACK or stale, skip it.
+    //
+    if (TCP_SEQ_LEQ (Right, Tcb->SndUna)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Tcb->SndUna)) {
+      Left = Tcb->SndUna;
+    }
+
+    TcpSackInsertBlock (Tcb, Left, Right);
+  }
+}
+
+/**
+  Remove the part of the scoreboard that is cumulatively acknowledged.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack       The new SND.UNA.
+
+**/
+VOID
+TcpSackTrimScoreboard (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Ack
+  )
+{
+  UINT8  Index;
+
+  ASSERT (Tcb != NULL);
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_GT (Tcb->SackBlock[Index].Right, Ack)) {
+      break;
+    }
+  }
+
+  if (Index != 0) {
+    CopyMem (
+      &Tcb->SackBlock[0],
+      &Tcb->SackBlock[Index],
+      (Tcb->SackNum - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackNum = (UINT8)(Tcb->SackNum - Index);
+  }
+
+  if ((Tcb->SackNum != 0) && TCP_SEQ_LT (Tcb->SackBlock[0].Left, Ack)) {
+    Tcb->SackBlock[0].Left = Ack;
+  }
+
+  if (TCP_SEQ_LT (Tcb->SackHighRxt, Ack)) {
+    Tcb->SackHighRxt = Ack;
+  }
+}
+
+/**
+  Discard the scoreboard. RFC2018 requires the sender to ignore the
+  SACK information after a retransmission timeout, since the peer
+  may have discarded the out-of-order data.
+
+  @param[in, out]  Tcb       Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClearScoreboard (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  ASSERT (Tcb != NULL);
+
+  Tcb->SackNum     = 0;
+  Tcb->SackHighRxt = Tcb->SndUna;
+}
+
+/**
+  Get the number of bytes selectively acknowledged by the peer.
+
+  @param[in]  Tcb       Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes in the scoreboard.
+
+**/
+UINT32
+TcpSackedBytes (
+  IN TCP_CB  *Tcb
+  )
+{
+  UINT8   Index;
+  UINT32  Bytes;
+
+  ASSERT (Tcb != NULL);
+
+  Bytes = 0;
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    Bytes += TCP_SUB_SEQ (Tcb->SackBlock[Index].Right, Tcb->SackBlock[Index].Left);
+  }
+
+  return Bytes;
+}
+
+/**
+  Find the next hole in the scoreboard to retransmit. Only the holes
+  below the highest SACKed sequence are considered lost; the data
+  beyond it may still be in flight.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]   From      The sequence number to start the search from.
+  @param[out]  Seq       The first sequence number of the hole.
+  @param[out]  Len       The length of the hole.
+
+  @retval TRUE           A hole is found.
+  @retval FALSE          There is no hole at or above From.
+
+**/
+BOOLEAN
+TcpSackNextHole (
+  IN  TCP_CB     *Tcb,
+  IN  TCP_SEQNO  From,
+  OUT TCP_SEQNO  *Seq,
+  OUT UINT32     *Len
+  )
+{
+  UINT8      Index;
+  TCP_SEQNO  Start;
+
+  ASSERT ((Tcb != NULL) && (Seq != NULL) && (Len != NULL));
+
+  Start = TCP_SEQ_LT (From, Tcb->SndUna) ? Tcb->SndUna : From;
+
+  for (Index = 0; Index < Tcb->SackNum; Index++) {
+    if (TCP_SEQ_LT (Start, Tcb->SackBlock[Index].Left)) {
+      *Seq = Start;
+      *Len = TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Start);
+      return TRUE;
+    }
+
+    if (TCP_SEQ_LT (Start, Tcb->SackBlock[Index].Right)) {
+      Start = Tcb->SackBlock[Index].Right;
+    }
+  }
+
+  return FALSE;
+}
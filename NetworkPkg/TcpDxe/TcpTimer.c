@@ -215,6 +215,14 @@ TcpRexmitTimeout (
     return;
   }
 
+  Tcb->RtoTimeouts++;
+
+  //
+  // The peer may renege the SACKed data, restart from the
+  // first unacknowledged byte as RFC2018 section 8 requires.
+  //
+  TcpSackClearScoreboard (Tcb);
+
   TcpBackoffRto (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
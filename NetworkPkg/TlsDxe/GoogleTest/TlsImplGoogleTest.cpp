@@ -0,0 +1,340 @@
+/** @file
+  Tests for the session resumption cache in TlsImpl.c.
+
+  The TLS library is replaced by a fake connection, which hands out a fixed
+  serialized session and records the session offered for resumption.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../TlsImpl.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_MAX_SESSION  32
+#define TEST_HOST_LEN     16
+
+////////////////////////////////////////////////////////////////////////
+// Fake TLS connection
+////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  UINT32         Verify;
+  CONST CHAR8    *Session;
+  EFI_STATUS     SetStatus;
+  CHAR8          Offered[TEST_MAX_SESSION];
+  UINTN          OfferedSize;
+} FAKE_TLS_CONN;
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+extern "C" {
+  INTN
+  EFIAPI
+  TlsCtrlTrafficOut (
+    IN     VOID   *Tls,
+    IN OUT VOID   *Buffer,
+    IN     UINTN  BufferSize
+    )
+  {
+    return -1;
+  }
+
+  INTN
+  EFIAPI
+  TlsCtrlTrafficIn (
+    IN     VOID   *Tls,
+    IN     VOID   *Buffer,
+    IN     UINTN  BufferSize
+    )
+  {
+    return -1;
+  }
+
+  INTN
+  EFIAPI
+  TlsRead (
+    IN     VOID   *Tls,
+    IN OUT VOID   *Buffer,
+    IN     UINTN  BufferSize
+    )
+  {
+    return -1;
+  }
+
+  INTN
+  EFIAPI
+  TlsWrite (
+    IN     VOID   *Tls,
+    IN     VOID   *Buffer,
+    IN     UINTN  BufferSize
+    )
+  {
+    return -1;
+  }
+
+  UINT32
+  EFIAPI
+  TlsGetVerify (
+    IN     VOID  *Tls
+    )
+  {
+    return ((FAKE_TLS_CONN *)Tls)->Verify;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  TlsGetResumeSession (
+    IN     VOID   *Tls,
+    OUT    VOID   *Data  OPTIONAL,
+    IN OUT UINTN  *DataSize
+    )
+  {
+    FAKE_TLS_CONN  *Conn;
+    UINTN          Length;
+
+    Conn = (FAKE_TLS_CONN *)Tls;
+    if (Conn->Session == NULL) {
+      return EFI_NOT_FOUND;
+    }
+
+    Length = AsciiStrSize (Conn->Session);
+    if ((Data == NULL) || (*DataSize < Length)) {
+      *DataSize = Length;
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    CopyMem (Data, Conn->Session, Length);
+    *DataSize = Length;
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  TlsSetResumeSession (
+    IN     VOID        *Tls,
+    IN     CONST VOID  *Data,
+    IN     UINTN       DataSize
+    )
+  {
+    FAKE_TLS_CONN  *Conn;
+
+    Conn = (FAKE_TLS_CONN *)Tls;
+    if (EFI_ERROR (Conn->SetStatus)) {
+      return Conn->SetStatus;
+    }
+
+    if (DataSize > sizeof (Conn->Offered)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    CopyMem (Conn->Offered, Data, DataSize);
+    Conn->OfferedSize = DataSize;
+    return EFI_SUCCESS;
+  }
+
+  BOOLEAN
+  EFIAPI
+  TlsGetSessionReused (
+    IN     VOID  *Tls
+    )
+  {
+    return FALSE;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// TlsSessionCache Tests
+////////////////////////////////////////////////////////////////////////
+
+class TlsSessionCacheTest : public ::testing::Test {
+protected:
+  TLS_SERVICE Service;
+  CHAR8 Hosts[TLS_SESSION_CACHE_MAX + 1][TEST_HOST_LEN];
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Index;
+
+    ZeroMem (&Service, sizeof (Service));
+    Service.Signature = TLS_SERVICE_SIGNATURE;
+    InitializeListHead (&Service.SessionCache);
+
+    for (Index = 0; Index < ARRAY_SIZE (Hosts); Index++) {
+      snprintf (Hosts[Index], sizeof (Hosts[Index]), "host%u.test", (unsigned)Index);
+    }
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    TlsSessionCacheFlush (&Service);
+  }
+
+  //
+  // Run the cache operation on a connection to HostName.
+  //
+  VOID
+  Save (
+    CONST CHAR8  *HostName,
+    UINT32       Verify,
+    CONST CHAR8  *Session
+    )
+  {
+    TLS_INSTANCE   Instance;
+    FAKE_TLS_CONN  Conn;
+
+    ZeroMem (&Conn, sizeof (Conn));
+    Conn.Verify  = Verify;
+    Conn.Session = Session;
+    InitInstance (&Instance, &Conn, HostName);
+    TlsSessionCacheSave (&Instance);
+  }
+
+  BOOLEAN
+  Apply (
+    CONST CHAR8    *HostName,
+    FAKE_TLS_CONN  *Conn
+    )
+  {
+    TLS_INSTANCE  Instance;
+
+    InitInstance (&Instance, Conn, HostName);
+    return TlsSessionCacheApply (&Instance);
+  }
+
+  VOID
+  InitInstance (
+    TLS_INSTANCE   *Instance,
+    FAKE_TLS_CONN  *Conn,
+    CONST CHAR8    *HostName
+    )
+  {
+    ZeroMem (Instance, sizeof (*Instance));
+    Instance->Signature = TLS_INSTANCE_SIGNATURE;
+    Instance->Service   = &Service;
+    Instance->HostName  = (CHAR8 *)HostName;
+    Instance->TlsConn   = Conn;
+  }
+};
+
+TEST_F (TlsSessionCacheTest, SavedSessionIsOfferedToSameHost) {
+  FAKE_TLS_CONN  Conn;
+
+  Save (Hosts[0], EFI_TLS_VERIFY_PEER, "session-a");
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)1);
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  ASSERT_TRUE (Apply (Hosts[0], &Conn));
+  EXPECT_EQ (Conn.OfferedSize, sizeof ("session-a"));
+  EXPECT_STREQ (Conn.Offered, "session-a");
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  EXPECT_FALSE (Apply (Hosts[1], &Conn));
+  EXPECT_EQ (Conn.OfferedSize, (UINTN)0);
+}
+
+TEST_F (TlsSessionCacheTest, SessionIsNotOfferedForOtherVerifyMethod) {
+  FAKE_TLS_CONN  Conn;
+
+  //
+  // A session set up without peer verification must not be resumed by a
+  // connection which requires it.
+  //
+  Save (Hosts[0], EFI_TLS_VERIFY_NONE, "unverified");
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  EXPECT_FALSE (Apply (Hosts[0], &Conn));
+  EXPECT_EQ (Conn.OfferedSize, (UINTN)0);
+}
+
+TEST_F (TlsSessionCacheTest, SaveReplacesSessionOfSameHost) {
+  FAKE_TLS_CONN  Conn;
+
+  Save (Hosts[0], EFI_TLS_VERIFY_PEER, "first");
+  Save (Hosts[0], EFI_TLS_VERIFY_PEER, "second");
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)1);
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  ASSERT_TRUE (Apply (Hosts[0], &Conn));
+  EXPECT_STREQ (Conn.Offered, "second");
+}
+
+TEST_F (TlsSessionCacheTest, LeastRecentlyUsedSessionIsEvicted) {
+  FAKE_TLS_CONN  Conn;
+  UINTN          Index;
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_MAX; Index++) {
+    Save (Hosts[Index], EFI_TLS_VERIFY_PEER, Hosts[Index]);
+  }
+
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)TLS_SESSION_CACHE_MAX);
+
+  //
+  // Using the oldest session makes the next one the least recently used.
+  //
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  ASSERT_TRUE (Apply (Hosts[0], &Conn));
+
+  Save (Hosts[TLS_SESSION_CACHE_MAX], EFI_TLS_VERIFY_PEER, Hosts[TLS_SESSION_CACHE_MAX]);
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)TLS_SESSION_CACHE_MAX);
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  EXPECT_FALSE (Apply (Hosts[1], &Conn));
+
+  for (Index = 0; Index <= TLS_SESSION_CACHE_MAX; Index++) {
+    if (Index == 1) {
+      continue;
+    }
+
+    ZeroMem (&Conn, sizeof (Conn));
+    Conn.Verify = EFI_TLS_VERIFY_PEER;
+    EXPECT_TRUE (Apply (Hosts[Index], &Conn)) << Hosts[Index];
+    EXPECT_STREQ (Conn.Offered, Hosts[Index]);
+  }
+}
+
+TEST_F (TlsSessionCacheTest, RejectedSessionIsDropped) {
+  FAKE_TLS_CONN  Conn;
+
+  Save (Hosts[0], EFI_TLS_VERIFY_PEER, "stale");
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify    = EFI_TLS_VERIFY_PEER;
+  Conn.SetStatus = EFI_INVALID_PARAMETER;
+  EXPECT_FALSE (Apply (Hosts[0], &Conn));
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)0);
+}
+
+TEST_F (TlsSessionCacheTest, NothingIsCachedWithoutHostNameOrSession) {
+  FAKE_TLS_CONN  Conn;
+
+  Save (NULL, EFI_TLS_VERIFY_PEER, "no-host");
+  Save (Hosts[0], EFI_TLS_VERIFY_PEER, NULL);
+  EXPECT_EQ (Service.SessionCacheCount, (UINTN)0);
+
+  ZeroMem (&Conn, sizeof (Conn));
+  Conn.Verify = EFI_TLS_VERIFY_PEER;
+  EXPECT_FALSE (Apply (NULL, &Conn));
+}
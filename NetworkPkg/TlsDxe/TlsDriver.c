@@ -25,11 +25,28 @@ TlsCleanInstance (
   IN TLS_INSTANCE  *Instance
   )
 {
+  EFI_TPL  OldTpl;
+
   if (Instance != NULL) {
     if (Instance->TlsConn != NULL) {
+      //
+      // Pick up the session ticket a TLS 1.3 server sends after the handshake.
+      //
+      if ((Instance->TlsSessionState == EfiTlsSessionDataTransferring) ||
+          (Instance->TlsSessionState == EfiTlsSessionClosing))
+      {
+        OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+        TlsSessionCacheSave (Instance);
+        gBS->RestoreTPL (OldTpl);
+      }
+
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -86,6 +103,8 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    TlsSessionCacheFlush (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -131,6 +150,7 @@ TlsCreateService (
   CopyMem (&TlsService->ServiceBinding, &mTlsServiceBinding, sizeof (TlsService->ServiceBinding));
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
+  InitializeListHead (&TlsService->SessionCache);
   TlsService->ImageHandle = Image;
 
   *Service = TlsService;
@@ -26,6 +26,11 @@
 
 #define TLS_INSTANCE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+//
+// Maximum number of resumable sessions kept per driver, one per peer.
+//
+#define TLS_SESSION_CACHE_MAX  8
+
 ///
 /// TLS Service Data
 ///
@@ -36,6 +41,18 @@ typedef struct _TLS_SERVICE TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// Resumable session saved from a completed handshake, keyed by the peer
+/// host name and the verification method the session was established with.
+///
+typedef struct {
+  LIST_ENTRY    Link;
+  CHAR8         *HostName;
+  UINT32        VerifyMethod;
+  UINTN         DataSize;
+  UINT8         *Data;
+} TLS_SESSION_CACHE_ENTRY;
+
 struct _TLS_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -55,6 +72,19 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Sessions of completed handshakes, most recently used first, which are
+  // offered for resumption by later connections to the same host.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheCount;
+
+  //
+  // Handshake statistics.
+  //
+  UINT32                          HandshakeCount;
+  UINT32                          ResumedCount;
 };
 
 struct _TLS_INSTANCE {
@@ -71,6 +101,18 @@ struct _TLS_INSTANCE {
 
   EFI_TLS_SESSION_STATE             TlsSessionState;
 
+  //
+  // Peer host name set through EfiTlsVerifyHost, used as the session cache key.
+  //
+  CHAR8                             *HostName;
+
+  //
+  // Performance counter value when the handshake started, valid once
+  // HandshakeStarted is set.
+  //
+  BOOLEAN                           HandshakeStarted;
+  UINT64                            HandshakeStart;
+
   //
   // Main SSL Connection which is created by a server or a client
   // per established connection.
@@ -348,3 +348,248 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Find the cached session for a peer.
+
+  @param[in]  Service        The TLS service data.
+  @param[in]  HostName       The peer host name.
+  @param[in]  VerifyMethod   The verification method of the connection.
+
+  @return The cache entry, or NULL if no session is cached for the peer.
+
+**/
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheFind (
+  IN TLS_SERVICE  *Service,
+  IN CONST CHAR8  *HostName,
+  IN UINT32       VerifyMethod
+  )
+{
+  LIST_ENTRY               *Entry;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+
+  NET_LIST_FOR_EACH (Entry, &Service->SessionCache) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, TLS_SESSION_CACHE_ENTRY, Link);
+    if ((CacheEntry->VerifyMethod == VerifyMethod) &&
+        (AsciiStriCmp (CacheEntry->HostName, HostName) == 0))
+    {
+      return CacheEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Remove an entry from the session cache and free it.
+
+  @param[in]  Service        The TLS service data.
+  @param[in]  CacheEntry     The cache entry to remove.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN TLS_SERVICE              *Service,
+  IN TLS_SESSION_CACHE_ENTRY  *CacheEntry
+  )
+{
+  RemoveEntryList (&CacheEntry->Link);
+  Service->SessionCacheCount--;
+
+  ZeroMem (CacheEntry->Data, CacheEntry->DataSize);
+  FreePool (CacheEntry->Data);
+  FreePool (CacheEntry->HostName);
+  FreePool (CacheEntry);
+}
+
+/**
+  Offer the cached session of the peer for resumption on a TLS instance.
+
+  The session is only offered if it was established with the same verification
+  method as the new connection, so a session set up without peer verification
+  is never resumed by a connection which requires it.
+
+  @param[in]  Instance       The TLS instance, before its ClientHello is built.
+
+  @retval TRUE               A cached session is offered.
+  @retval FALSE              A full handshake will be done.
+
+**/
+BOOLEAN
+TlsSessionCacheApply (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+  EFI_STATUS               Status;
+
+  if (Instance->HostName == NULL) {
+    return FALSE;
+  }
+
+  CacheEntry = TlsSessionCacheFind (
+                 Instance->Service,
+                 Instance->HostName,
+                 TlsGetVerify (Instance->TlsConn)
+                 );
+  if (CacheEntry == NULL) {
+    return FALSE;
+  }
+
+  Status = TlsSetResumeSession (Instance->TlsConn, CacheEntry->Data, CacheEntry->DataSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "TlsSessionCacheApply: Drop session of %a - %r\n", CacheEntry->HostName, Status));
+    TlsSessionCacheRemove (Instance->Service, CacheEntry);
+    return FALSE;
+  }
+
+  //
+  // Keep the most recently used session at the head.
+  //
+  RemoveEntryList (&CacheEntry->Link);
+  InsertHeadList (&Instance->Service->SessionCache, &CacheEntry->Link);
+
+  return TRUE;
+}
+
+/**
+  Save the session of a TLS instance to the session cache.
+
+  The previous session of the same peer is replaced. If the cache is full, the
+  least recently used session is dropped. A TLS 1.3 server sends its session
+  ticket after the handshake, so this is called both when the handshake is
+  done and when the instance is destroyed.
+
+  @param[in]  Instance       The TLS instance, after its handshake completed.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *CacheEntry;
+  UINT32                   VerifyMethod;
+  UINTN                    DataSize;
+  UINT8                    *Data;
+  EFI_STATUS               Status;
+
+  Service = Instance->Service;
+  if ((Instance->HostName == NULL) || (Instance->TlsConn == NULL)) {
+    return;
+  }
+
+  DataSize = 0;
+  Status   = TlsGetResumeSession (Instance->TlsConn, NULL, &DataSize);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return;
+  }
+
+  Data = AllocatePool (DataSize);
+  if (Data == NULL) {
+    return;
+  }
+
+  Status = TlsGetResumeSession (Instance->TlsConn, Data, &DataSize);
+  if (EFI_ERROR (Status)) {
+    FreePool (Data);
+    return;
+  }
+
+  VerifyMethod = TlsGetVerify (Instance->TlsConn);
+  CacheEntry   = TlsSessionCacheFind (Service, Instance->HostName, VerifyMethod);
+  if (CacheEntry != NULL) {
+    ZeroMem (CacheEntry->Data, CacheEntry->DataSize);
+    FreePool (CacheEntry->Data);
+    RemoveEntryList (&CacheEntry->Link);
+  } else {
+    CacheEntry = AllocateZeroPool (sizeof (TLS_SESSION_CACHE_ENTRY));
+    if (CacheEntry == NULL) {
+      FreePool (Data);
+      return;
+    }
+
+    CacheEntry->HostName = AllocateCopyPool (AsciiStrSize (Instance->HostName), Instance->HostName);
+    if (CacheEntry->HostName == NULL) {
+      FreePool (CacheEntry);
+      FreePool (Data);
+      return;
+    }
+
+    CacheEntry->VerifyMethod = VerifyMethod;
+
+    if (Service->SessionCacheCount >= TLS_SESSION_CACHE_MAX) {
+      TlsSessionCacheRemove (
+        Service,
+        NET_LIST_USER_STRUCT (Service->SessionCache.BackLink, TLS_SESSION_CACHE_ENTRY, Link)
+        );
+    }
+
+    Service->SessionCacheCount++;
+  }
+
+  CacheEntry->Data     = Data;
+  CacheEntry->DataSize = DataSize;
+  InsertHeadList (&Service->SessionCache, &CacheEntry->Link);
+}
+
+/**
+  Free all the sessions in the session cache.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  )
+{
+  while (!IsListEmpty (&Service->SessionCache)) {
+    TlsSessionCacheRemove (
+      Service,
+      NET_LIST_USER_STRUCT (Service->SessionCache.ForwardLink, TLS_SESSION_CACHE_ENTRY, Link)
+      );
+  }
+}
+
+/**
+  Record the end of the handshake of a TLS instance.
+
+  The handshake time and whether the session was resumed are logged, and the
+  new session is saved to the session cache.
+
+  @param[in]  Instance       The TLS instance whose handshake just completed.
+
+**/
+VOID
+TlsHandshakeDone (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  BOOLEAN  Resumed;
+  UINT64   ElapsedUs;
+
+  PERF_INMODULE_END ("TlsHandshake");
+
+  Resumed   = TlsGetSessionReused (Instance->TlsConn);
+  ElapsedUs = DivU64x32 (GetTimeInNanoSecond (GetElapsedTicks (&Instance->HandshakeStart)), 1000);
+
+  Instance->Service->HandshakeCount++;
+  if (Resumed) {
+    Instance->Service->ResumedCount++;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "TlsDxe: Handshake with %a done in %lu us, %a (%d of %d handshakes resumed)\n",
+    Instance->HostName != NULL ? Instance->HostName : "<unknown>",
+    ElapsedUs,
+    Resumed ? "session resumed" : "full handshake",
+    Instance->Service->ResumedCount,
+    Instance->Service->HandshakeCount
+    ));
+
+  TlsSessionCacheSave (Instance);
+}
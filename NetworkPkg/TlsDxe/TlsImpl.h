@@ -22,6 +22,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/NetLib.h>
 #include <Library/BaseCryptLib.h>
 #include <Library/TlsLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // Consumed Protocols
@@ -86,6 +89,65 @@ TlsDecryptPacket (
   IN     UINT32                 *FragmentCount
   );
 
+/**
+  Offer the cached session of the peer for resumption on a TLS instance.
+
+  The session is only offered if it was established with the same verification
+  method as the new connection, so a session set up without peer verification
+  is never resumed by a connection which requires it.
+
+  @param[in]  Instance       The TLS instance, before its ClientHello is built.
+
+  @retval TRUE               A cached session is offered.
+  @retval FALSE              A full handshake will be done.
+
+**/
+BOOLEAN
+TlsSessionCacheApply (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Save the session of a TLS instance to the session cache.
+
+  The previous session of the same peer is replaced. If the cache is full, the
+  least recently used session is dropped. A TLS 1.3 server sends its session
+  ticket after the handshake, so this is called both when the handshake is
+  done and when the instance is destroyed.
+
+  @param[in]  Instance       The TLS instance, after its handshake completed.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Free all the sessions in the session cache.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  );
+
+/**
+  Record the end of the handshake of a TLS instance.
+
+  The handshake time and whether the session was resumed are logged, and the
+  new session is saved to the session cache.
+
+  @param[in]  Instance       The TLS instance whose handshake just completed.
+
+**/
+VOID
+TlsHandshakeDone (
+  IN TLS_INSTANCE  *Instance
+  );
+
 /**
   Set TLS session data.
 
@@ -187,6 +187,22 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      //
+      // Remember the peer for the session cache.
+      //
+      if (Instance->HostName != NULL) {
+        FreePool (Instance->HostName);
+      }
+
+      Instance->HostName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->HostName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
 
       break;
     case EfiTlsSessionID:
@@ -484,6 +500,17 @@ TlsBuildResponsePacket (
   if ((RequestBuffer == NULL) && (RequestSize == 0)) {
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
+        //
+        // Offer the cached session of this peer, if any, for resumption. The
+        // ClientHello may be built twice if Buffer is too small, so do it once.
+        //
+        if (!Instance->HandshakeStarted) {
+          Instance->HandshakeStarted = TRUE;
+          Instance->HandshakeStart   = GetPerformanceCounter ();
+          PERF_INMODULE_BEGIN ("TlsHandshake");
+          TlsSessionCacheApply (Instance);
+        }
+
         //
         // ClientHello.
         //
@@ -562,6 +589,12 @@ TlsBuildResponsePacket (
     // TlsDoHandshake() can handle all of those cases.
     //
     if (TlsInHandshake (Instance->TlsConn)) {
+      if (!Instance->HandshakeStarted) {
+        Instance->HandshakeStarted = TRUE;
+        Instance->HandshakeStart   = GetPerformanceCounter ();
+        PERF_INMODULE_BEGIN ("TlsHandshake");
+      }
+
       Status = TlsDoHandshake (
                  Instance->TlsConn,
                  RequestBuffer,
@@ -575,6 +608,7 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsHandshakeDone (Instance);
       }
     } else {
       //
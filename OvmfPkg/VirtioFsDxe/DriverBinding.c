@@ -8,6 +8,7 @@
 
 #include <Library/BaseLib.h>                  // AsciiStrCmp()
 #include <Library/MemoryAllocationLib.h>      // AllocatePool()
+#include <Library/TimerLib.h>                 // GetPerformanceCounter()
 #include <Library/UefiBootServicesTableLib.h> // gBS
 #include <Protocol/ComponentName2.h>          // EFI_COMPONENT_NAME2_PROTOCOL
 #include <Protocol/DriverBinding.h>           // EFI_DRIVER_BINDING_PROTOCOL
@@ -74,7 +75,7 @@ VirtioFsBindingStart (
   EFI_STATUS  Status;
   EFI_STATUS  CloseStatus;
 
-  VirtioFs = AllocatePool (sizeof *VirtioFs);
+  VirtioFs = AllocateZeroPool (sizeof *VirtioFs);
   if (VirtioFs == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -114,6 +115,32 @@ VirtioFsBindingStart (
     goto UninitVirtioFs;
   }
 
+  //
+  // Keep the attribute cache clock running across performance counter
+  // wrap-arounds.
+  //
+  VirtioFs->ClockLastValue = GetPerformanceCounter ();
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  VirtioFsClockSample,
+                  VirtioFs,
+                  &VirtioFs->ClockTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
+  Status = gBS->SetTimer (
+                  VirtioFs->ClockTimer,
+                  TimerPeriodic,
+                  VIRTIO_FS_CLOCK_SAMPLE_PERIOD
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseClockTimer;
+  }
+
   InitializeListHead (&VirtioFs->OpenFiles);
   VirtioFs->SimpleFs.Revision   = EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_REVISION;
   VirtioFs->SimpleFs.OpenVolume = VirtioFsOpenVolume;
@@ -125,11 +152,15 @@ VirtioFsBindingStart (
                   &VirtioFs->SimpleFs
                   );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto CloseClockTimer;
   }
 
   return EFI_SUCCESS;
 
+CloseClockTimer:
+  CloseStatus = gBS->CloseEvent (VirtioFs->ClockTimer);
+  ASSERT_EFI_ERROR (CloseStatus);
+
 CloseExitBoot:
   CloseStatus = gBS->CloseEvent (VirtioFs->ExitBoot);
   ASSERT_EFI_ERROR (CloseStatus);
@@ -192,6 +223,9 @@ VirtioFsBindingStop (
     return Status;
   }
 
+  Status = gBS->CloseEvent (VirtioFs->ClockTimer);
+  ASSERT_EFI_ERROR (Status);
+
   Status = gBS->CloseEvent (VirtioFs->ExitBoot);
   ASSERT_EFI_ERROR (Status);
 
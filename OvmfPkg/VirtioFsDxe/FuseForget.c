@@ -1,5 +1,5 @@
 /** @file
-  FUSE_FORGET wrapper for the Virtio Filesystem device.
+  FUSE_FORGET / FUSE_BATCH_FORGET wrappers for the Virtio Filesystem device.
 
   Copyright (C) 2020, Red Hat, Inc.
 
@@ -82,6 +82,116 @@ VirtioFsFuseForget (
   //
   ForgetReq.NumberOfLookups = 1;
 
+  //
+  // Submit the request. There's not going to be a response.
+  //
+  VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
+  Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, NULL);
+  return Status;
+}
+
+/**
+  Make the Virtio Filesystem device drop one reference count from each one of
+  several NodeIds that the driver learned by filename lookup or by reading a
+  directory stream.
+
+  Send a single FUSE_BATCH_FORGET request to the Virtio Filesystem device for
+  this, rather than one FUSE_FORGET request per NodeId. Like FUSE_FORGET,
+  FUSE_BATCH_FORGET doesn't elicit a response.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the
+                           FUSE_BATCH_FORGET request to. On output, the FUSE
+                           request counter "VirtioFs->RequestId" will have been
+                           incremented, unless NumNodes is zero.
+
+  @param[in] NumNodes      The number of elements in Nodes. At most
+                           VIRTIO_FS_MAX_BATCH_FORGET.
+
+  @param[in] Nodes         The inode numbers that the server should
+                           un-reference, each with the number of references
+                           to drop.
+
+  @retval EFI_SUCCESS            The FUSE_BATCH_FORGET request has been
+                                 submitted, or NumNodes is zero.
+
+  @retval EFI_INVALID_PARAMETER  NumNodes exceeds VIRTIO_FS_MAX_BATCH_FORGET.
+
+  @return                        Error codes propagated from
+                                 VirtioFsSgListsValidate(),
+                                 VirtioFsFuseNewRequest(),
+                                 VirtioFsSgListsSubmit().
+**/
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT32                             NumNodes,
+  IN     VIRTIO_FS_FUSE_FORGET_ONE_REQUEST  *Nodes
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST               CommonReq;
+  VIRTIO_FS_FUSE_BATCH_FORGET_REQUEST  BatchForgetReq;
+  VIRTIO_FS_IO_VECTOR                  ReqIoVec[3];
+  VIRTIO_FS_SCATTER_GATHER_LIST        ReqSgList;
+  EFI_STATUS                           Status;
+  UINT32                               Idx;
+
+  if (NumNodes == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (NumNodes > VIRTIO_FS_MAX_BATCH_FORGET) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Set up the scatter-gather list (note: only request).
+  //
+  ReqIoVec[0].Buffer = &CommonReq;
+  ReqIoVec[0].Size   = sizeof CommonReq;
+  ReqIoVec[1].Buffer = &BatchForgetReq;
+  ReqIoVec[1].Size   = sizeof BatchForgetReq;
+  ReqIoVec[2].Buffer = Nodes;
+  ReqIoVec[2].Size   = NumNodes * sizeof *Nodes;
+  ReqSgList.IoVec    = ReqIoVec;
+  ReqSgList.NumVec   = ARRAY_SIZE (ReqIoVec);
+
+  //
+  // Validate the scatter-gather list (request only); calculate the total
+  // transfer size.
+  //
+  Status = VirtioFsSgListsValidate (VirtioFs, &ReqSgList, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Populate the common request header. FUSE_BATCH_FORGET doesn't refer to a
+  // single inode.
+  //
+  Status = VirtioFsFuseNewRequest (
+             VirtioFs,
+             &CommonReq,
+             ReqSgList.TotalSize,
+             VirtioFsFuseOpBatchForget,
+             0
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Populate the FUSE_BATCH_FORGET-specific fields.
+  //
+  BatchForgetReq.Count = NumNodes;
+  BatchForgetReq.Dummy = 0;
+
+  for (Idx = 0; Idx < NumNodes; Idx++) {
+    VirtioFsAttrCacheInvalidate (VirtioFs, Nodes[Idx].NodeId);
+  }
+
   //
   // Submit the request. There's not going to be a response.
   //
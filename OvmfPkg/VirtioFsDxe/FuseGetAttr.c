@@ -12,12 +12,15 @@
   Send a FUSE_GETATTR request to the Virtio Filesystem device, for fetching the
   attributes of an inode.
 
+  The request is not sent if the attribute cache holds attributes for the
+  inode that the Virtio Filesystem device declared still valid.
+
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
   @param[in,out] VirtioFs  The Virtio Filesystem device to send the
                            FUSE_GETATTR request to. On output, the FUSE request
-                           counter "VirtioFs->RequestId" will have been
+                           counter "VirtioFs->RequestId" may have been
                            incremented.
 
   @param[in] NodeId        The inode number for which the attributes should be
@@ -52,6 +55,13 @@ VirtioFsFuseGetAttr (
   VIRTIO_FS_SCATTER_GATHER_LIST    RespSgList;
   EFI_STATUS                       Status;
 
+  //
+  // Serve the request from the attribute cache, if possible.
+  //
+  if (VirtioFsAttrCacheLookup (VirtioFs, NodeId, FuseAttr)) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Set up the scatter-gather lists.
   //
@@ -124,5 +134,15 @@ VirtioFsFuseGetAttr (
     Status = VirtioFsErrnoToEfiStatus (CommonResp.Error);
   }
 
+  if (!EFI_ERROR (Status)) {
+    VirtioFsAttrCacheUpdate (
+      VirtioFs,
+      NodeId,
+      FuseAttr,
+      GetAttrResp.AttrValid,
+      GetAttrResp.AttrValidNsec
+      );
+  }
+
   return Status;
 }
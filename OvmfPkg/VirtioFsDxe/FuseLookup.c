@@ -145,9 +145,17 @@ VirtioFsFuseLookup (
   }
 
   //
-  // Output the NodeId to which Name has been resolved to.
+  // Output the NodeId to which Name has been resolved to. Remember the
+  // attributes for the FUSE_GETATTR requests that are likely to follow.
   //
   *NodeId = NodeResp.NodeId;
+  VirtioFsAttrCacheUpdate (
+    VirtioFs,
+    NodeResp.NodeId,
+    FuseAttr,
+    NodeResp.AttrValid,
+    NodeResp.AttrValidNsec
+    );
   return EFI_SUCCESS;
 
 Fail:
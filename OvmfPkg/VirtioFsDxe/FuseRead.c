@@ -203,3 +203,221 @@ VirtioFsFuseReadFileOrDir (
   *Size = (UINT32)TailBufferFill;
   return EFI_SUCCESS;
 }
+
+/**
+  Read a range of a regular file, keeping several FUSE_READ requests in flight
+  on the request queue.
+
+  The range is split into up to "VirtioFs->MaxReads" consecutive chunks, and a
+  FUSE_READ request is sent for each chunk. All requests are submitted to the
+  Virtio Filesystem device at once, so the device may serve them in parallel,
+  and the driver waits for the device only once.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request sent.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in,out] Size      On input, the number of bytes to read; it must be
+                           nonzero. On successful return, the number of bytes
+                           actually read, which may be smaller than the value
+                           on input. The bytes read are always contiguous from
+                           Offset: a chunk that the device returns short (for
+                           example due to EOF) ends the transfer. EOF at Offset
+                           is reported by setting Size to zero.
+
+  @param[out] Data         Buffer to read the bytes from the regular file into.
+                           The caller is responsible for providing room for (at
+                           least) as many bytes in Data as Size is on input.
+
+  @retval EFI_SUCCESS            Read successful. The caller is responsible for
+                                 checking Size to learn the actual byte count
+                                 transferred.
+
+  @retval EFI_INVALID_PARAMETER  Size is zero on input.
+
+  @return                        The "errno" value mapped to an EFI_STATUS
+                                 code, if the Virtio Filesystem device
+                                 explicitly reported an error for the first
+                                 chunk.
+
+  @return                        Error codes propagated from
+                                 VirtioFsSgListsValidate(),
+                                 VirtioFsFuseNewRequest(),
+                                 VirtioFsSgListsSubmitMultiple(),
+                                 VirtioFsFuseCheckResponse().
+**/
+EFI_STATUS
+VirtioFsFuseReadFilePipelined (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST         CommonReq[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_FUSE_READ_REQUEST    ReadReq[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_IO_VECTOR            ReqIoVec[VIRTIO_FS_MAX_PIPELINED_REQUESTS][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  ReqSgList[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_FUSE_RESPONSE        CommonResp[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  VIRTIO_FS_IO_VECTOR            RespIoVec[VIRTIO_FS_MAX_PIPELINED_REQUESTS][2];
+  VIRTIO_FS_SCATTER_GATHER_LIST  RespSgList[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  EFI_STATUS                     Status;
+  UINTN                          ChunkSize;
+  UINTN                          NumReads;
+  UINTN                          Queued;
+  UINTN                          Idx;
+  UINTN                          TailBufferFill;
+  UINTN                          Transferred;
+
+  if (*Size == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // FUSE_INIT doesn't report a read limit, and a single FUSE_READ request has
+  // always been accepted for the whole range. Split the range evenly, but
+  // don't go below the transfer size that the device declared for
+  // FUSE_WRITE, and stay well within what FUSE_READ can express.
+  //
+  ChunkSize = *Size / VirtioFs->MaxReads + 1;
+  ChunkSize = MAX (ChunkSize, (UINTN)VirtioFs->MaxWrite);
+  ChunkSize = MIN (ChunkSize, (UINTN)SIZE_1GB);
+  ChunkSize = ALIGN_VALUE (ChunkSize, SIZE_4KB);
+
+  Queued   = 0;
+  NumReads = 0;
+  while ((Queued < *Size) && (NumReads < VirtioFs->MaxReads)) {
+    //
+    // Set up the scatter-gather lists.
+    //
+    ReqIoVec[NumReads][0].Buffer = &CommonReq[NumReads];
+    ReqIoVec[NumReads][0].Size   = sizeof CommonReq[NumReads];
+    ReqIoVec[NumReads][1].Buffer = &ReadReq[NumReads];
+    ReqIoVec[NumReads][1].Size   = sizeof ReadReq[NumReads];
+    ReqSgList[NumReads].IoVec    = ReqIoVec[NumReads];
+    ReqSgList[NumReads].NumVec   = ARRAY_SIZE (ReqIoVec[NumReads]);
+
+    RespIoVec[NumReads][0].Buffer = &CommonResp[NumReads];
+    RespIoVec[NumReads][0].Size   = sizeof CommonResp[NumReads];
+    RespIoVec[NumReads][1].Buffer = (UINT8 *)Data + Queued;
+    RespIoVec[NumReads][1].Size   = MIN (ChunkSize, *Size - Queued);
+    RespSgList[NumReads].IoVec    = RespIoVec[NumReads];
+    RespSgList[NumReads].NumVec   = ARRAY_SIZE (RespIoVec[NumReads]);
+
+    //
+    // Validate the scatter-gather lists; calculate the total transfer sizes.
+    //
+    Status = VirtioFsSgListsValidate (
+               VirtioFs,
+               &ReqSgList[NumReads],
+               &RespSgList[NumReads]
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    //
+    // Populate the common request header.
+    //
+    Status = VirtioFsFuseNewRequest (
+               VirtioFs,
+               &CommonReq[NumReads],
+               ReqSgList[NumReads].TotalSize,
+               VirtioFsFuseOpRead,
+               NodeId
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    //
+    // Populate the FUSE_READ-specific fields.
+    //
+    ReadReq[NumReads].FileHandle = FuseHandle;
+    ReadReq[NumReads].Offset     = Offset + Queued;
+    ReadReq[NumReads].Size       = (UINT32)RespIoVec[NumReads][1].Size;
+    ReadReq[NumReads].ReadFlags  = 0;
+    ReadReq[NumReads].LockOwner  = 0;
+    ReadReq[NumReads].Flags      = 0;
+    ReadReq[NumReads].Padding    = 0;
+
+    Queued += RespIoVec[NumReads][1].Size;
+    NumReads++;
+  }
+
+  //
+  // Submit the requests.
+  //
+  Status = VirtioFsSgListsSubmitMultiple (
+             VirtioFs,
+             NumReads,
+             ReqSgList,
+             RespSgList
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Verify the responses in file offset order. Note that TailBufferFill is
+  // variable.
+  //
+  Transferred = 0;
+  for (Idx = 0; Idx < NumReads; Idx++) {
+    Status = VirtioFsFuseCheckResponse (
+               &RespSgList[Idx],
+               CommonReq[Idx].Unique,
+               &TailBufferFill
+               );
+    if (EFI_ERROR (Status)) {
+      if (Status == EFI_DEVICE_ERROR) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+          "Offset=0x%Lx Size=0x%x Errno=%d\n",
+          __func__,
+          VirtioFs->Label,
+          NodeId,
+          FuseHandle,
+          ReadReq[Idx].Offset,
+          ReadReq[Idx].Size,
+          CommonResp[Idx].Error
+          ));
+        Status = VirtioFsErrnoToEfiStatus (CommonResp[Idx].Error);
+      }
+
+      break;
+    }
+
+    Transferred += TailBufferFill;
+    if (TailBufferFill < ReadReq[Idx].Size) {
+      //
+      // Any data in the subsequent chunks would not be contiguous.
+      //
+      break;
+    }
+  }
+
+  //
+  // Report an error only if it prevented the transfer of any bytes.
+  //
+  if (EFI_ERROR (Status) && (Transferred == 0)) {
+    return Status;
+  }
+
+  *Size = Transferred;
+  return EFI_SUCCESS;
+}
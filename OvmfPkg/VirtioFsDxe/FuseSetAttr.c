@@ -149,8 +149,10 @@ VirtioFsFuseSetAttr (
   }
 
   //
-  // Submit the request.
+  // Submit the request. Whatever the outcome, the cached attributes of the
+  // inode may be stale from now on.
   //
+  VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
   Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, &RespSgList);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -188,5 +190,15 @@ VirtioFsFuseSetAttr (
     Status = VirtioFsErrnoToEfiStatus (CommonResp.Error);
   }
 
+  if (!EFI_ERROR (Status)) {
+    VirtioFsAttrCacheUpdate (
+      VirtioFs,
+      NodeId,
+      &AttrResp,
+      GetAttrResp.AttrValid,
+      GetAttrResp.AttrValidNsec
+      );
+  }
+
   return Status;
 }
@@ -130,8 +130,10 @@ VirtioFsFuseWrite (
   WriteReq.Padding    = 0;
 
   //
-  // Submit the request.
+  // Submit the request. Whatever the outcome, the cached attributes of the
+  // inode may be stale from now on.
   //
+  VirtioFsAttrCacheInvalidate (VirtioFs, NodeId);
   Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, &RespSgList);
   if (EFI_ERROR (Status)) {
     return Status;
@@ -6,11 +6,14 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
-#include <Library/BaseLib.h>             // StrLen()
-#include <Library/BaseMemoryLib.h>       // CopyMem()
-#include <Library/MemoryAllocationLib.h> // AllocatePool()
-#include <Library/TimeBaseLib.h>         // EpochToEfiTime()
-#include <Library/VirtioLib.h>           // Virtio10WriteFeatures()
+#include <Library/BaseLib.h>                  // StrLen()
+#include <Library/BaseMemoryLib.h>            // CopyMem()
+#include <Library/ElapsedTicksLib.h>          // GetElapsedTicks()
+#include <Library/MemoryAllocationLib.h>      // AllocatePool()
+#include <Library/TimeBaseLib.h>              // EpochToEfiTime()
+#include <Library/TimerLib.h>                 // GetTimeInNanoSecond()
+#include <Library/UefiBootServicesTableLib.h> // gBS
+#include <Library/VirtioLib.h>                // Virtio10WriteFeatures()
 
 #include "VirtioFsDxe.h"
 
@@ -209,6 +212,18 @@ VirtioFsInit (
     goto Failed;
   }
 
+  //
+  // A FUSE_READ request takes four descriptors (request header, read request,
+  // response header, data). Determine how many of them we can keep in flight.
+  //
+  VirtioFs->MaxReads = (UINT16)MAX (
+                                 1,
+                                 MIN (
+                                   VIRTIO_FS_MAX_PIPELINED_REQUESTS,
+                                   VirtioFs->QueueSize / 4
+                                   )
+                                 );
+
   //
   // 7.d. [...] population of virtqueues [...]
   //
@@ -531,8 +546,7 @@ VirtioFsSgListsValidate (
                             more response bytes than ResponseSgList->TotalSize.
 
   @return                   Error codes propagated from
-                            VirtioMapAllBytesInSharedBuffer(), VirtioFlush(),
-                            or VirtioFs->Virtio->UnmapSharedBuffer().
+                            VirtioFsSgListsSubmitMultiple().
 **/
 EFI_STATUS
 VirtioFsSgListsSubmit (
@@ -541,157 +555,328 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   )
 {
-  VIRTIO_FS_SCATTER_GATHER_LIST  *SgListParam[2];
-  VIRTIO_MAP_OPERATION           SgListVirtioMapOp[ARRAY_SIZE (SgListParam)];
-  UINT16                         SgListDescriptorFlag[ARRAY_SIZE (SgListParam)];
-  UINTN                          ListId;
-  VIRTIO_FS_SCATTER_GATHER_LIST  *SgList;
-  UINTN                          IoVecIdx;
-  VIRTIO_FS_IO_VECTOR            *IoVec;
-  EFI_STATUS                     Status;
-  DESC_INDICES                   Indices;
-  UINT32                         TotalBytesWrittenByDevice;
-  UINT32                         BytesPermittedForWrite;
-
-  SgListParam[0]          = RequestSgList;
+  return VirtioFsSgListsSubmitMultiple (
+           VirtioFs,
+           1,
+           RequestSgList,
+           ResponseSgList
+           );
+}
+
+/**
+  Submit several validated pairs of (request buffer list, response buffer list)
+  to the Virtio Filesystem device at once, and wait until the device has
+  processed all of them.
+
+  Every pair is placed on the request queue as a separate descriptor chain, and
+  the device is notified only once. The device may process the chains in any
+  order (and in parallel).
+
+  On input, each pair of VIRTIO_FS_SCATTER_GATHER_LIST objects
+  (RequestSgLists[Idx], ResponseSgLists[Idx]) must have been validated
+  together, using the VirtioFsSgListsValidate() function.
+
+  On output (on successful return), the fields listed at
+  VirtioFsSgListsSubmit() will have been updated in all IO Vectors.
+
+  The function may only be called after VirtioFsInit() returns successfully and
+  before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs         The Virtio Filesystem device that the
+                                  request-response exchanges should now be
+                                  submitted to.
+
+  @param[in] NumRequests          The number of elements in RequestSgLists, and
+                                  in ResponseSgLists (if the latter is not
+                                  NULL).
+
+  @param[in,out] RequestSgLists   Array of scatter-gather lists that describe
+                                  the request parts of the exchanges.
+
+  @param[in,out] ResponseSgLists  Array of scatter-gather lists that describe
+                                  the response parts of the exchanges. May be
+                                  NULL if and only if none of the exchanges
+                                  has a response part.
+
+  @retval EFI_SUCCESS            Transfer complete. The caller should
+                                 investigate the
+                                 VIRTIO_FS_IO_VECTOR.Transferred fields in
+                                 ResponseSgLists, like after
+                                 VirtioFsSgListsSubmit().
+
+  @retval EFI_INVALID_PARAMETER  NumRequests is zero or exceeds
+                                 VIRTIO_FS_MAX_PIPELINED_REQUESTS.
+
+  @retval EFI_UNSUPPORTED        The descriptor chains of all the exchanges do
+                                 not fit on the virtio queue together.
+
+  @retval EFI_DEVICE_ERROR       The Virtio Filesystem device reported
+                                 populating more response bytes than the
+                                 TotalSize field of a response scatter-gather
+                                 list, or it reported an unexpected descriptor
+                                 chain as used.
+
+  @return                        Error codes propagated from
+                                 VirtioMapAllBytesInSharedBuffer(),
+                                 VirtioFs->Virtio->SetQueueNotify(), or
+                                 VirtioFs->Virtio->UnmapSharedBuffer().
+**/
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumRequests,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgLists OPTIONAL
+  )
+{
+  VIRTIO_FS_SCATTER_GATHER_LIST   *SgListParam[VIRTIO_FS_MAX_PIPELINED_REQUESTS][2];
+  VIRTIO_MAP_OPERATION            SgListVirtioMapOp[2];
+  UINT16                          SgListDescriptorFlag[2];
+  UINT16                          HeadDescIdx[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  UINT32                          BytesWrittenByDevice[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  BOOLEAN                         Completed[VIRTIO_FS_MAX_PIPELINED_REQUESTS];
+  UINTN                           ReqIdx;
+  UINTN                           ListId;
+  VIRTIO_FS_SCATTER_GATHER_LIST   *SgList;
+  UINTN                           IoVecIdx;
+  VIRTIO_FS_IO_VECTOR             *IoVec;
+  UINTN                           DescriptorsNeeded;
+  EFI_STATUS                      Status;
+  DESC_INDICES                    Indices;
+  UINT16                          NextAvailIdx;
+  UINT16                          UsedIdx;
+  UINTN                           PollPeriodUsecs;
+  volatile CONST VRING_USED_ELEM  *UsedElem;
+  UINT32                          TotalBytesWrittenByDevice;
+  UINT32                          BytesPermittedForWrite;
+
+  if ((NumRequests == 0) || (NumRequests > VIRTIO_FS_MAX_PIPELINED_REQUESTS)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   SgListVirtioMapOp[0]    = VirtioOperationBusMasterRead;
   SgListDescriptorFlag[0] = 0;
 
-  SgListParam[1]          = ResponseSgList;
   SgListVirtioMapOp[1]    = VirtioOperationBusMasterWrite;
   SgListDescriptorFlag[1] = VRING_DESC_F_WRITE;
 
   //
-  // Map all IO Vectors.
+  // Each pair has been validated separately; make sure that all the
+  // descriptor chains fit on the virtio queue together.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  DescriptorsNeeded = 0;
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    SgListParam[ReqIdx][0] = &RequestSgLists[ReqIdx];
+    SgListParam[ReqIdx][1] = (ResponseSgLists == NULL) ?
+                             NULL :
+                             &ResponseSgLists[ReqIdx];
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam[ReqIdx]); ListId++) {
+      SgList = SgListParam[ReqIdx][ListId];
+      if (SgList != NULL) {
+        DescriptorsNeeded += SgList->NumVec;
+      }
     }
+  }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Map this IO Vector.
-      //
-      Status = VirtioMapAllBytesInSharedBuffer (
-                 VirtioFs->Virtio,
-                 SgListVirtioMapOp[ListId],
-                 IoVec->Buffer,
-                 IoVec->Size,
-                 &IoVec->MappedAddress,
-                 &IoVec->Mapping
-                 );
-      if (EFI_ERROR (Status)) {
-        goto Unmap;
+  if (DescriptorsNeeded > VirtioFs->QueueSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Map all IO Vectors.
+  //
+  Status = EFI_SUCCESS;
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam[ReqIdx]); ListId++) {
+      SgList = SgListParam[ReqIdx][ListId];
+      if (SgList == NULL) {
+        continue;
       }
 
-      IoVec->Mapped = TRUE;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Map this IO Vector.
+        //
+        Status = VirtioMapAllBytesInSharedBuffer (
+                   VirtioFs->Virtio,
+                   SgListVirtioMapOp[ListId],
+                   IoVec->Buffer,
+                   IoVec->Size,
+                   &IoVec->MappedAddress,
+                   &IoVec->Mapping
+                   );
+        if (EFI_ERROR (Status)) {
+          goto Unmap;
+        }
+
+        IoVec->Mapped = TRUE;
+      }
     }
   }
 
   //
-  // Compose the descriptor chain.
+  // Compose the descriptor chains back to back, starting at entry #0 of the
+  // descriptor table.
   //
   VirtioPrepare (&VirtioFs->Ring, &Indices);
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    HeadDescIdx[ReqIdx] = Indices.NextDescIdx;
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam[ReqIdx]); ListId++) {
+      SgList = SgListParam[ReqIdx][ListId];
+      if (SgList == NULL) {
+        continue;
+      }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      UINT16  NextFlag;
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        UINT16  NextFlag;
 
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Set VRING_DESC_F_NEXT on all except the very last descriptor.
-      //
-      NextFlag = VRING_DESC_F_NEXT;
-      if ((ListId == ARRAY_SIZE (SgListParam) - 1) &&
-          (IoVecIdx == SgList->NumVec - 1))
-      {
-        NextFlag = 0;
-      }
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Set VRING_DESC_F_NEXT on all except the very last descriptor of the
+        // chain.
+        //
+        NextFlag = VRING_DESC_F_NEXT;
+        if ((IoVecIdx == SgList->NumVec - 1) &&
+            ((ListId == ARRAY_SIZE (SgListParam[ReqIdx]) - 1) ||
+             (SgListParam[ReqIdx][ListId + 1] == NULL)))
+        {
+          NextFlag = 0;
+        }
 
-      VirtioAppendDesc (
-        &VirtioFs->Ring,
-        IoVec->MappedAddress,
-        (UINT32)IoVec->Size,
-        SgListDescriptorFlag[ListId] | NextFlag,
-        &Indices
-        );
+        VirtioAppendDesc (
+          &VirtioFs->Ring,
+          IoVec->MappedAddress,
+          (UINT32)IoVec->Size,
+          SgListDescriptorFlag[ListId] | NextFlag,
+          &Indices
+          );
+      }
     }
   }
 
   //
-  // Submit the descriptor chain.
+  // Publish the head descriptors of all chains in the Available Ring, then
+  // notify the device once (virtio-0.9.5, 2.4.1.2 through 2.4.1.4).
   //
-  Status = VirtioFlush (
-             VirtioFs->Virtio,
-             VIRTIO_FS_REQUEST_QUEUE,
-             &VirtioFs->Ring,
-             &Indices,
-             &TotalBytesWrittenByDevice
-             );
+  NextAvailIdx = *VirtioFs->Ring.Avail.Idx;
+  UsedIdx      = NextAvailIdx;
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    VirtioFs->Ring.Avail.Ring[NextAvailIdx++ % VirtioFs->Ring.QueueSize] =
+      HeadDescIdx[ReqIdx];
+    Completed[ReqIdx] = FALSE;
+  }
+
+  MemoryFence ();
+  *VirtioFs->Ring.Avail.Idx = NextAvailIdx;
+
+  MemoryFence ();
+  Status = VirtioFs->Virtio->SetQueueNotify (
+                               VirtioFs->Virtio,
+                               VIRTIO_FS_REQUEST_QUEUE
+                               );
   if (EFI_ERROR (Status)) {
     goto Unmap;
   }
 
   //
-  // Sanity-check: the Virtio Filesystem device should not have written more
-  // bytes than what we offered buffers for.
+  // Wait until the device processes all chains (virtio-0.9.5, 2.4.2). Due to
+  // the lock-step progress across calls, the used index catches up with the
+  // available index exactly when all chains submitted above have been used.
   //
-  if (ResponseSgList == NULL) {
-    BytesPermittedForWrite = 0;
-  } else {
-    BytesPermittedForWrite = ResponseSgList->TotalSize;
-  }
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (*VirtioFs->Ring.Used.Idx != NextAvailIdx) {
+    gBS->Stall (PollPeriodUsecs);
 
-  if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
-    Status = EFI_DEVICE_ERROR;
-    goto Unmap;
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+
+    MemoryFence ();
   }
 
+  MemoryFence ();
+
   //
-  // Update the transfer sizes in the IO Vectors.
+  // Match the used elements with the chains; the device may have completed
+  // the chains in any order.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  for ( ; UsedIdx != NextAvailIdx; UsedIdx++) {
+    UsedElem = &VirtioFs->Ring.Used.UsedElem[UsedIdx % VirtioFs->Ring.QueueSize];
+    for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+      if (!Completed[ReqIdx] && (UsedElem->Id == HeadDescIdx[ReqIdx])) {
+        break;
+      }
     }
 
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
-        //
-        // We report that the Virtio Filesystem device has read all buffers in
-        // the request.
-        //
-        IoVec->Transferred = IoVec->Size;
-      } else {
-        //
-        // Regarding the response, calculate how much of the current IO Vector
-        // has been populated by the Virtio Filesystem device. In
-        // "TotalBytesWrittenByDevice", VirtioFlush() reported the total count
-        // across all device-writeable descriptors, in the order they were
-        // chained on the ring.
-        //
-        IoVec->Transferred = MIN (
-                               (UINTN)TotalBytesWrittenByDevice,
-                               IoVec->Size
-                               );
-        TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
-      }
+    if (ReqIdx == NumRequests) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
     }
+
+    Completed[ReqIdx]            = TRUE;
+    BytesWrittenByDevice[ReqIdx] = UsedElem->Len;
   }
 
-  //
-  // By now, "TotalBytesWrittenByDevice" has been exhausted.
-  //
-  ASSERT (TotalBytesWrittenByDevice == 0);
+  for (ReqIdx = 0; ReqIdx < NumRequests; ReqIdx++) {
+    //
+    // Sanity-check: the Virtio Filesystem device should not have written more
+    // bytes than what we offered buffers for.
+    //
+    TotalBytesWrittenByDevice = BytesWrittenByDevice[ReqIdx];
+    if (SgListParam[ReqIdx][1] == NULL) {
+      BytesPermittedForWrite = 0;
+    } else {
+      BytesPermittedForWrite = SgListParam[ReqIdx][1]->TotalSize;
+    }
+
+    if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
+    }
+
+    //
+    // Update the transfer sizes in the IO Vectors.
+    //
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam[ReqIdx]); ListId++) {
+      SgList = SgListParam[ReqIdx][ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
+          //
+          // We report that the Virtio Filesystem device has read all buffers
+          // in the request.
+          //
+          IoVec->Transferred = IoVec->Size;
+        } else {
+          //
+          // Regarding the response, calculate how much of the current IO
+          // Vector has been populated by the Virtio Filesystem device. In
+          // "TotalBytesWrittenByDevice", the used element reported the total
+          // count across all device-writeable descriptors of the chain, in
+          // the order they were chained on the ring.
+          //
+          IoVec->Transferred = MIN (
+                                 (UINTN)TotalBytesWrittenByDevice,
+                                 IoVec->Size
+                                 );
+          TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+        }
+      }
+    }
+
+    //
+    // By now, "TotalBytesWrittenByDevice" has been exhausted.
+    //
+    ASSERT (TotalBytesWrittenByDevice == 0);
+  }
 
   //
   // We've succeeded; fall through.
@@ -702,49 +887,51 @@ Unmap:
   // unmapping occurs in reverse order of mapping, in an attempt to avoid
   // memory fragmentation.
   //
-  ListId = ARRAY_SIZE (SgListParam);
-  while (ListId > 0) {
-    --ListId;
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
-
-    IoVecIdx = SgList->NumVec;
-    while (IoVecIdx > 0) {
-      EFI_STATUS  UnmapStatus;
-
-      --IoVecIdx;
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Unmap this IO Vector, if it has been mapped.
-      //
-      if (!IoVec->Mapped) {
+  ReqIdx = NumRequests;
+  while (ReqIdx > 0) {
+    --ReqIdx;
+    ListId = ARRAY_SIZE (SgListParam[ReqIdx]);
+    while (ListId > 0) {
+      --ListId;
+      SgList = SgListParam[ReqIdx][ListId];
+      if (SgList == NULL) {
         continue;
       }
 
-      UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
-                                        VirtioFs->Virtio,
-                                        IoVec->Mapping
-                                        );
-      //
-      // Re-set the following fields to the values they initially got from
-      // VirtioFsSgListsValidate() -- the above unmapping attempt is considered
-      // final, even if it fails.
-      //
-      IoVec->Mapped        = FALSE;
-      IoVec->MappedAddress = 0;
-      IoVec->Mapping       = NULL;
+      IoVecIdx = SgList->NumVec;
+      while (IoVecIdx > 0) {
+        EFI_STATUS  UnmapStatus;
 
-      //
-      // If we are on the success path, but the unmapping failed, we need to
-      // transparently flip to the failure path -- the caller must learn they
-      // should not consult the response buffers.
-      //
-      // The branch below can be taken at most once.
-      //
-      if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
-        Status = UnmapStatus;
+        --IoVecIdx;
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Unmap this IO Vector, if it has been mapped.
+        //
+        if (!IoVec->Mapped) {
+          continue;
+        }
+
+        UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (
+                                          VirtioFs->Virtio,
+                                          IoVec->Mapping
+                                          );
+        //
+        // Re-set the following fields to the values they initially got from
+        // VirtioFsSgListsValidate() -- the above unmapping attempt is
+        // considered final, even if it fails.
+        //
+        IoVec->Mapped        = FALSE;
+        IoVec->MappedAddress = 0;
+        IoVec->Mapping       = NULL;
+
+        //
+        // If we are on the success path, but the unmapping failed, we need to
+        // transparently flip to the failure path -- the caller must learn they
+        // should not consult the response buffers.
+        //
+        if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
+          Status = UnmapStatus;
+        }
       }
     }
   }
@@ -1173,6 +1360,181 @@ VirtioFsErrnoToEfiStatus (
   return EFI_DEVICE_ERROR;
 }
 
+/**
+  Timer event notification function that advances the attribute cache clock
+  of a Virtio Filesystem object.
+
+  The performance counter is sampled at least once per
+  VIRTIO_FS_CLOCK_SAMPLE_PERIOD, so that it cannot wrap around more than once
+  between two samples, and the ticks elapsed since the previous sample are
+  accumulated in VIRTIO_FS.ClockTicks.
+
+  @param[in] ClockTimerEvent  The VIRTIO_FS.ClockTimer event that has been
+                              signaled, or NULL when called directly.
+
+  @param[in] VirtioFsAsVoid   Pointer to the VIRTIO_FS object, passed in as
+                              (VOID*).
+**/
+VOID
+EFIAPI
+VirtioFsClockSample (
+  IN EFI_EVENT  ClockTimerEvent,
+  IN VOID       *VirtioFsAsVoid
+  )
+{
+  VIRTIO_FS  *VirtioFs;
+  EFI_TPL    OldTpl;
+
+  VirtioFs = VirtioFsAsVoid;
+
+  OldTpl                = gBS->RaiseTPL (TPL_CALLBACK);
+  VirtioFs->ClockTicks += GetElapsedTicks (&VirtioFs->ClockLastValue);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Read the attribute cache clock of a Virtio Filesystem object.
+
+  Unlike the performance counter, the clock never wraps around; it counts the
+  time elapsed since VirtioFsBindingStart().
+
+  @param[in,out] VirtioFs  The Virtio Filesystem object whose clock should be
+                           read and advanced.
+
+  @return  The value of the clock, in nanoseconds.
+**/
+UINT64
+VirtioFsGetClock (
+  IN OUT VIRTIO_FS  *VirtioFs
+  )
+{
+  VirtioFsClockSample (NULL, VirtioFs);
+  return GetTimeInNanoSecond (VirtioFs->ClockTicks);
+}
+
+/**
+  Look up the attributes of an inode in the attribute cache.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose attribute cache
+                           should be searched. An expired entry for NodeId is
+                           dropped from the cache.
+
+  @param[in] NodeId        The inode number to look up.
+
+  @param[out] FuseAttr     On successful return, the cached attributes of
+                           NodeId.
+
+  @retval TRUE   FuseAttr has been populated from a cache entry that the
+                 Virtio Filesystem device declared still valid.
+
+  @retval FALSE  NodeId is not cached, or its cached attributes have expired.
+**/
+BOOLEAN
+VirtioFsAttrCacheLookup (
+  IN OUT VIRTIO_FS                        *VirtioFs,
+  IN     UINT64                           NodeId,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  )
+{
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Entry;
+
+  Entry = &VirtioFs->AttrCache[NodeId & (VIRTIO_FS_ATTR_CACHE_SIZE - 1)];
+  if ((NodeId == 0) || (Entry->NodeId != NodeId)) {
+    return FALSE;
+  }
+
+  if (VirtioFsGetClock (VirtioFs) >= Entry->ExpiresAt) {
+    Entry->NodeId = 0;
+    return FALSE;
+  }
+
+  CopyMem (FuseAttr, &Entry->Attr, sizeof *FuseAttr);
+  return TRUE;
+}
+
+/**
+  Store the attributes of an inode, as reported by the Virtio Filesystem
+  device, in the attribute cache.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose attribute cache
+                           should be updated.
+
+  @param[in] NodeId        The inode number that FuseAttr describes.
+
+  @param[in] FuseAttr      The attributes to cache.
+
+  @param[in] AttrValid     The whole seconds part of the period for which the
+                           Virtio Filesystem device declared FuseAttr valid.
+
+  @param[in] AttrValidNsec The nanoseconds part of the same period. If both
+                           AttrValid and AttrValidNsec are zero, FuseAttr is
+                           not cached, and any cached attributes of NodeId are
+                           dropped.
+**/
+VOID
+VirtioFsAttrCacheUpdate (
+  IN OUT VIRTIO_FS                           *VirtioFs,
+  IN     UINT64                              NodeId,
+  IN     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  IN     UINT64                              AttrValid,
+  IN     UINT32                              AttrValidNsec
+  )
+{
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Entry;
+  UINT64                      Now;
+  UINT64                      Validity;
+
+  if (NodeId == 0) {
+    return;
+  }
+
+  Entry = &VirtioFs->AttrCache[NodeId & (VIRTIO_FS_ATTR_CACHE_SIZE - 1)];
+  if ((AttrValid == 0) && (AttrValidNsec == 0)) {
+    if (Entry->NodeId == NodeId) {
+      Entry->NodeId = 0;
+    }
+
+    return;
+  }
+
+  //
+  // Saturate the expiry time rather than let it wrap around.
+  //
+  Now = VirtioFsGetClock (VirtioFs);
+  if (AttrValid >= DivU64x32 (MAX_UINT64 - AttrValidNsec, 1000000000)) {
+    Validity = MAX_UINT64;
+  } else {
+    Validity = MultU64x32 (AttrValid, 1000000000) + AttrValidNsec;
+  }
+
+  Entry->NodeId    = NodeId;
+  Entry->ExpiresAt = (Validity > MAX_UINT64 - Now) ? MAX_UINT64 : Now + Validity;
+  CopyMem (&Entry->Attr, FuseAttr, sizeof Entry->Attr);
+}
+
+/**
+  Drop the cached attributes of an inode, before the driver changes the inode,
+  or stops referencing it.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose attribute cache
+                           should be updated.
+
+  @param[in] NodeId        The inode number whose attributes should be dropped.
+**/
+VOID
+VirtioFsAttrCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  )
+{
+  VIRTIO_FS_ATTR_CACHE_ENTRY  *Entry;
+
+  Entry = &VirtioFs->AttrCache[NodeId & (VIRTIO_FS_ATTR_CACHE_SIZE - 1)];
+  if (Entry->NodeId == NodeId) {
+    Entry->NodeId = 0;
+  }
+}
+
 //
 // Parser states for canonicalizing a POSIX pathname.
 //
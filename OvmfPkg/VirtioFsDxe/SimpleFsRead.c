@@ -69,16 +69,18 @@ RefillFileInfoCache (
   IN OUT VIRTIO_FS_FILE  *VirtioFsFile
   )
 {
-  VIRTIO_FS                       *VirtioFs;
-  EFI_STATUS                      Status;
-  VIRTIO_FS_FUSE_STATFS_RESPONSE  FilesysAttr;
-  UINT32                          DirentBufSize;
-  UINT8                           *DirentBuf;
-  UINTN                           SingleFileInfoSize;
-  UINT8                           *FileInfoArray;
-  UINT64                          DirStreamCookie;
-  UINT64                          CacheEndsAtCookie;
-  UINTN                           NumFileInfo;
+  VIRTIO_FS                          *VirtioFs;
+  EFI_STATUS                         Status;
+  VIRTIO_FS_FUSE_STATFS_RESPONSE     FilesysAttr;
+  UINT32                             DirentBufSize;
+  UINT8                              *DirentBuf;
+  UINTN                              SingleFileInfoSize;
+  UINT8                              *FileInfoArray;
+  UINT64                             DirStreamCookie;
+  UINT64                             CacheEndsAtCookie;
+  UINTN                              NumFileInfo;
+  VIRTIO_FS_FUSE_FORGET_ONE_REQUEST  Forget[VIRTIO_FS_MAX_BATCH_FORGET];
+  UINT32                             NumForget;
 
   //
   // Allocate a DirentBuf that can receive at least
@@ -131,6 +133,7 @@ RefillFileInfoCache (
   DirStreamCookie   = VirtioFsFile->FilePosition;
   CacheEndsAtCookie = VirtioFsFile->FilePosition;
   NumFileInfo       = 0;
+  NumForget         = 0;
   do {
     UINT32  Remaining;
     UINT32  Consumed;
@@ -242,10 +245,18 @@ RefillFileInfoCache (
       // Make the Virtio Filesystem device forget the NodeId in this directory
       // entry, as we'll need it no more. (The "." and ".." entries need no
       // FUSE_FORGET requests, when returned by FUSE_READDIRPLUS -- and so the
-      // Virtio Filesystem device reports their NodeId fields as zero.)
+      // Virtio Filesystem device reports their NodeId fields as zero.) Collect
+      // the NodeIds for a FUSE_BATCH_FORGET request, rather than sending a
+      // FUSE_FORGET request per entry.
       //
       if (Dirent->NodeResp.NodeId != 0) {
-        VirtioFsFuseForget (VirtioFs, Dirent->NodeResp.NodeId);
+        Forget[NumForget].NodeId          = Dirent->NodeResp.NodeId;
+        Forget[NumForget].NumberOfLookups = 1;
+        NumForget++;
+        if (NumForget == ARRAY_SIZE (Forget)) {
+          VirtioFsFuseBatchForget (VirtioFs, NumForget, Forget);
+          NumForget = 0;
+        }
       }
 
       //
@@ -256,6 +267,9 @@ RefillFileInfoCache (
       Remaining      -= DirentSize;
     }
 
+    VirtioFsFuseBatchForget (VirtioFs, NumForget, Forget);
+    NumForget = 0;
+
     if (Remaining > 0) {
       //
       // This suggests that a VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE header was
@@ -289,6 +303,7 @@ RefillFileInfoCache (
   return EFI_SUCCESS;
 
 FreeFileInfoArray:
+  VirtioFsFuseBatchForget (VirtioFs, NumForget, Forget);
   FreePool (FileInfoArray);
 
 FreeDirentBuf:
@@ -392,17 +407,13 @@ ReadRegularFile (
   Transferred = 0;
   Left        = *BufferSize;
   while (Left > 0) {
-    UINT32  ReadSize;
+    UINTN  ReadSize;
 
-    //
-    // FUSE_READ cannot express a >=4GB buffer size.
-    //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status   = VirtioFsFuseReadFileOrDir (
+    ReadSize = Left;
+    Status   = VirtioFsFuseReadFilePipelined (
                  VirtioFs,
                  VirtioFsFile->NodeId,
                  VirtioFsFile->FuseHandle,
-                 FALSE,                                  // IsDir
                  VirtioFsFile->FilePosition + Transferred,
                  &ReadSize,
                  (UINT8 *)Buffer + Transferred
@@ -52,6 +52,41 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO  256
 
+//
+// Maximum number of FUSE requests submitted to the request queue at once. A
+// regular file read keeps up to this many FUSE_READ requests in flight.
+//
+#define VIRTIO_FS_MAX_PIPELINED_REQUESTS  8
+
+//
+// Maximum number of nodes forgotten with a single FUSE_BATCH_FORGET request.
+//
+#define VIRTIO_FS_MAX_BATCH_FORGET  64
+
+//
+// Number of entries in the attribute cache (must be a power of two).
+//
+#define VIRTIO_FS_ATTR_CACHE_SIZE  64
+
+//
+// Period of the timer that samples the performance counter for the attribute
+// cache clock. It must be shorter than the time it takes for the counter to
+// wrap around (about 4.7 seconds for the 24-bit ACPI PM timer on OVMF).
+//
+#define VIRTIO_FS_CLOCK_SAMPLE_PERIOD  EFI_TIMER_PERIOD_SECONDS (1)
+
+//
+// Attributes of an inode, cached for as long as the Virtio Filesystem device
+// declared them valid (in the AttrValid / AttrValidNsec fields of its
+// FUSE_GETATTR and FUSE_LOOKUP responses). NodeId is zero for a free entry.
+// ExpiresAt is in nanoseconds of VirtioFsGetClock().
+//
+typedef struct {
+  UINT64                                NodeId;
+  UINT64                                ExpiresAt;
+  VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE    Attr;
+} VIRTIO_FS_ATTR_CACHE_ENTRY;
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -79,9 +114,18 @@ typedef struct {
   VOID                               *RingMap;  // VirtioRingMap       2
   UINT64                             RequestId; // FuseInitSession     1
   UINT32                             MaxWrite;  // FuseInitSession     1
+  UINT16                             MaxReads;  // VirtioFsInit        1
   EFI_EVENT                          ExitBoot;  // DriverBindingStart  0
   LIST_ENTRY                         OpenFiles; // DriverBindingStart  0
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    SimpleFs;  // DriverBindingStart  0
+  VIRTIO_FS_ATTR_CACHE_ENTRY         AttrCache[VIRTIO_FS_ATTR_CACHE_SIZE];
+                                                // DriverBindingStart  0
+  UINT64                             ClockTicks;
+                                                // DriverBindingStart  0
+  UINT64                             ClockLastValue;
+                                                // DriverBindingStart  0
+  EFI_EVENT                          ClockTimer;
+                                                // DriverBindingStart  0
 } VIRTIO_FS;
 
 #define VIRTIO_FS_FROM_SIMPLE_FS(SimpleFsReference) \
@@ -218,6 +262,14 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgList OPTIONAL
   );
 
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS                      *VirtioFs,
+  IN     UINTN                          NumRequests,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *RequestSgLists,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST  *ResponseSgLists OPTIONAL
+  );
+
 EFI_STATUS
 VirtioFsFuseNewRequest (
   IN OUT VIRTIO_FS              *VirtioFs,
@@ -239,6 +291,40 @@ VirtioFsErrnoToEfiStatus (
   IN INT32  Errno
   );
 
+VOID
+EFIAPI
+VirtioFsClockSample (
+  IN EFI_EVENT  ClockTimerEvent,
+  IN VOID       *VirtioFsAsVoid
+  );
+
+UINT64
+VirtioFsGetClock (
+  IN OUT VIRTIO_FS  *VirtioFs
+  );
+
+BOOLEAN
+VirtioFsAttrCacheLookup (
+  IN OUT VIRTIO_FS                        *VirtioFs,
+  IN     UINT64                           NodeId,
+  OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr
+  );
+
+VOID
+VirtioFsAttrCacheUpdate (
+  IN OUT VIRTIO_FS                           *VirtioFs,
+  IN     UINT64                              NodeId,
+  IN     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE  *FuseAttr,
+  IN     UINT64                              AttrValid,
+  IN     UINT32                              AttrValidNsec
+  );
+
+VOID
+VirtioFsAttrCacheInvalidate (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId
+  );
+
 EFI_STATUS
 VirtioFsAppendPath (
   IN     CHAR8   *LhsPath8,
@@ -327,6 +413,13 @@ VirtioFsFuseForget (
   IN     UINT64     NodeId
   );
 
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT32                             NumNodes,
+  IN     VIRTIO_FS_FUSE_FORGET_ONE_REQUEST  *Nodes
+  );
+
 EFI_STATUS
 VirtioFsFuseGetAttr (
   IN OUT VIRTIO_FS                        *VirtioFs,
@@ -379,6 +472,16 @@ VirtioFsFuseReadFileOrDir (
   OUT VOID          *Data
   );
 
+EFI_STATUS
+VirtioFsFuseReadFilePipelined (
+  IN OUT VIRTIO_FS  *VirtioFs,
+  IN     UINT64     NodeId,
+  IN     UINT64     FuseHandle,
+  IN     UINT64     Offset,
+  IN OUT UINTN      *Size,
+  OUT VOID          *Data
+  );
+
 EFI_STATUS
 VirtioFsFuseWrite (
   IN OUT VIRTIO_FS  *VirtioFs,
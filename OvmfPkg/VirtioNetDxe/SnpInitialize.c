@@ -383,6 +383,7 @@ VirtioNetInitRx (
   //
   MemoryFence ();
   Dev->RxLastUsed = *Dev->RxRing.Used.Idx;
+  Dev->RxUnkicked = 0;
   ASSERT (Dev->RxLastUsed == 0);
 
   //
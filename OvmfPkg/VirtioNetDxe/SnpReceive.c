@@ -75,6 +75,7 @@ VirtioNetReceive (
   UINT8       *RxPtr;
   UINT16      AvailIdx;
   EFI_STATUS  NotifyStatus;
+  BOOLEAN     Notified;
   UINTN       RxBufOffset;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
@@ -103,6 +104,26 @@ VirtioNetReceive (
 
   if (Dev->RxLastUsed == RxCurUsed) {
     Status = EFI_NOT_READY;
+
+    //
+    // hand over the buffers recycled since the last notification
+    //
+    if (Dev->RxUnkicked != 0) {
+      NotifyStatus = VirtioNetNotifyQueue (
+                       Dev,
+                       &Dev->RxRing,
+                       VIRTIO_NET_Q_RX,
+                       &Notified
+                       );
+      if (EFI_ERROR (NotifyStatus)) {
+        Status = NotifyStatus;
+      }
+
+      if (Notified) {
+        Dev->RxUnkicked = 0;
+      }
+    }
+
     goto Exit;
   }
 
@@ -175,11 +196,31 @@ RecycleDesc:
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = AvailIdx;
 
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device: the notification is an
+  // expensive VM exit. Batch it while the used ring has packets left to
+  // process, and skip it when the host says it will not need it. The count of
+  // recycled buffers is only cleared by an actual notification, so that the
+  // next call which finds no packet retries it.
+  //
+  ++Dev->RxUnkicked;
+  if ((Dev->RxLastUsed == RxCurUsed) ||
+      (Dev->RxUnkicked >= VNET_RX_KICK_BATCH))
+  {
+    NotifyStatus = VirtioNetNotifyQueue (
+                     Dev,
+                     &Dev->RxRing,
+                     VIRTIO_NET_Q_RX,
+                     &Notified
+                     );
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
+
+    if (Notified) {
+      Dev->RxUnkicked = 0;
+    }
   }
 
 Exit:
@@ -9,6 +9,7 @@
 **/
 
 #include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
 
 #include "VirtioNet.h"
 
@@ -103,6 +104,59 @@ VirtioNetUninitRing (
   VirtioRingUninit (Dev->VirtIo, Ring);
 }
 
+/**
+  Notify the device of the buffers just made available in a queue, unless the
+  device asked not to be notified.
+
+  virtio-0.9.5, 2.4.1.4 Notifying the Device: the host sets
+  VRING_USED_F_NO_NOTIFY while it is still processing the queue, in which case
+  it picks up the new buffers without the (expensive) notification. The flag
+  may only be read after the store to the available index is globally visible,
+  otherwise the host may clear the flag and go idle without seeing the new
+  index. MemoryFence() doesn't order a store before a later load on every
+  architecture (on IA32 and X64 it only constrains the compiler), hence the
+  locked read-modify-write, which is a full barrier everywhere.
+
+  @param[in] Dev         The VNET_DEV driver instance owning the queue.
+  @param[in] Ring        The virtio ring whose available index was updated.
+  @param[in] QueueIndex  The index of the queue to notify.
+  @param[out] Notified   Set to TRUE if the device was notified successfully,
+                         to FALSE otherwise.
+
+  @return  Status codes returned by VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+           EFI_SUCCESS if the device was not notified.
+*/
+EFI_STATUS
+EFIAPI
+VirtioNetNotifyQueue (
+  IN  VNET_DEV  *Dev,
+  IN  VRING     *Ring,
+  IN  UINT16    QueueIndex,
+  OUT BOOLEAN   *Notified
+  )
+{
+  volatile UINT32  Fence;
+  EFI_STATUS       Status;
+
+  *Notified = FALSE;
+
+  Fence = 0;
+  MemoryFence ();
+  InterlockedIncrement (&Fence);
+  MemoryFence ();
+
+  if ((*Ring->Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, QueueIndex);
+  if (!EFI_ERROR (Status)) {
+    *Notified = TRUE;
+  }
+
+  return Status;
+}
+
 /**
   Map Caller-supplied TxBuf buffer to the device-mapped address
 
@@ -72,6 +72,7 @@ VirtioNetTransmit (
   UINT16                DescIdx;
   UINT16                AvailIdx;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  BOOLEAN               Notified;
 
   if ((This == NULL) || (BufferSize == 0) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -173,8 +174,7 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
-  MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  Status = VirtioNetNotifyQueue (Dev, &Dev->TxRing, VIRTIO_NET_Q_TX, &Notified);
 
 Exit:
   gBS->RestoreTPL (OldTpl);
@@ -29,6 +29,12 @@
 //
 #define VNET_MAX_PENDING  64
 
+//
+// maximum number of recycled RX buffers made available to the host before it
+// is notified; the host is notified sooner when the used ring is drained
+//
+#define VNET_RX_KICK_BATCH  16
+
 //
 // State diagram:
 //
@@ -82,6 +88,7 @@ typedef struct {
                                                   // VirtioNetInitRing
   UINT8                          *RxBuf;          // VirtioNetInitRx
   UINT16                         RxLastUsed;      // VirtioNetInitRx
+  UINT16                         RxUnkicked;      // VirtioNetInitRx
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
@@ -275,6 +282,15 @@ VirtioNetUninitRing (
   IN     VOID      *RingMap
   );
 
+EFI_STATUS
+EFIAPI
+VirtioNetNotifyQueue (
+  IN  VNET_DEV  *Dev,
+  IN  VRING     *Ring,
+  IN  UINT16    QueueIndex,
+  OUT BOOLEAN   *Notified
+  );
+
 //
 // utility functions to map caller-supplied Tx buffer system physical address
 // to a device address and vice versa
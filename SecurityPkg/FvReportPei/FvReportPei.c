@@ -8,10 +8,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "FvReportPei.h"
 
+//
+// Size of the pieces in which an FV is copied and hashed. Each piece is hashed
+// with all the algorithms while it is still in the cache.
+//
+#define FV_HASH_CHUNK_SIZE  SIZE_32KB
+
 STATIC CONST HASH_ALG_INFO  mHashAlgInfo[] = {
-  { TPM_ALG_SHA256, SHA256_DIGEST_SIZE, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll }, // 000B
-  { TPM_ALG_SHA384, SHA384_DIGEST_SIZE, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll }, // 000C
-  { TPM_ALG_SHA512, SHA512_DIGEST_SIZE, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll }, // 000D
+  { TPM_ALG_SHA256, HASH_ALG_SHA256, SHA256_DIGEST_SIZE, Sha256GetContextSize, Sha256Init, Sha256Update, Sha256Final, Sha256HashAll }, // 000B
+  { TPM_ALG_SHA384, HASH_ALG_SHA384, SHA384_DIGEST_SIZE, Sha384GetContextSize, Sha384Init, Sha384Update, Sha384Final, Sha384HashAll }, // 000C
+  { TPM_ALG_SHA512, HASH_ALG_SHA512, SHA512_DIGEST_SIZE, Sha512GetContextSize, Sha512Init, Sha512Update, Sha512Final, Sha512HashAll }, // 000D
 };
 
 /**
@@ -46,18 +52,16 @@ FindHashAlgInfo (
 
   @param[in]  FvBuffer            Buffer containing the whole FV.
   @param[in]  FvLength            Length of the FV.
-  @param[in]  HashAlgoId          Hash algorithm type id.
-  @param[in]  HashSize            Hash size.
-  @param[in]  HashValue           Hash value buffer.
+  @param[in]  HashMask            Bitmap (HASH_ALG_*) of the algorithms of the digests.
+  @param[in]  Digest              Digests of the FV, in the order of mHashAlgInfo.
 **/
 STATIC
 VOID
 InstallPreHashFvPpi (
-  IN VOID    *FvBuffer,
-  IN UINTN   FvLength,
-  IN UINT16  HashAlgoId,
-  IN UINT16  HashSize,
-  IN UINT8   *HashValue
+  IN VOID     *FvBuffer,
+  IN UINTN    FvLength,
+  IN UINT32   HashMask,
+  IN TPMU_HA  *Digest
   )
 {
   EFI_STATUS                                       Status;
@@ -65,22 +69,35 @@ InstallPreHashFvPpi (
   EDKII_PEI_FIRMWARE_VOLUME_INFO_PREHASHED_FV_PPI  *PreHashedFvPpi;
   UINTN                                            PpiSize;
   HASH_INFO                                        *HashInfo;
+  UINTN                                            Index;
 
-  PpiSize = sizeof (EDKII_PEI_FIRMWARE_VOLUME_INFO_PREHASHED_FV_PPI)
-            + sizeof (HASH_INFO)
-            + HashSize;
+  PpiSize = sizeof (EDKII_PEI_FIRMWARE_VOLUME_INFO_PREHASHED_FV_PPI);
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    if ((mHashAlgInfo[Index].HashMask & HashMask) != 0) {
+      PpiSize += sizeof (HASH_INFO) + mHashAlgInfo[Index].HashSize;
+    }
+  }
 
   PreHashedFvPpi = AllocatePool (PpiSize);
   ASSERT (PreHashedFvPpi != NULL);
 
   PreHashedFvPpi->FvBase   = (UINT32)(UINTN)FvBuffer;
   PreHashedFvPpi->FvLength = (UINT32)FvLength;
-  PreHashedFvPpi->Count    = 1;
+  PreHashedFvPpi->Count    = 0;
+
+  HashInfo = HASH_INFO_PTR (PreHashedFvPpi);
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    if ((mHashAlgInfo[Index].HashMask & HashMask) == 0) {
+      continue;
+    }
+
+    HashInfo->HashAlgoId = mHashAlgInfo[Index].HashAlgId;
+    HashInfo->HashSize   = (UINT16)mHashAlgInfo[Index].HashSize;
+    CopyMem (HASH_VALUE_PTR (HashInfo), &Digest[Index], HashInfo->HashSize);
 
-  HashInfo             = HASH_INFO_PTR (PreHashedFvPpi);
-  HashInfo->HashAlgoId = HashAlgoId;
-  HashInfo->HashSize   = HashSize;
-  CopyMem (HASH_VALUE_PTR (HashInfo), HashValue, HashSize);
+    HashInfo = (HASH_INFO *)((UINT8 *)HASH_VALUE_PTR (HashInfo) + HashInfo->HashSize);
+    PreHashedFvPpi->Count++;
+  }
 
   FvInfoPpiDescriptor = AllocatePool (sizeof (EFI_PEI_PPI_DESCRIPTOR));
   ASSERT (FvInfoPpiDescriptor != NULL);
@@ -93,9 +110,90 @@ InstallPreHashFvPpi (
   ASSERT_EFI_ERROR (Status);
 }
 
+/**
+  Copy a FV to memory and hash it with several algorithms in a single pass.
+
+  If the FV shadow PPI succeeds in copying the FV, the copy is hashed piece by
+  piece with all the algorithms. Otherwise each piece of the FV is hashed
+  right after it is copied, while it is still in the cache.
+
+  @param[in]   FvBase             Base address of the FV.
+  @param[out]  FvBuffer           Buffer receiving the copy of the FV.
+  @param[in]   FvLength           Length of the FV.
+  @param[in]   FvShadowPpi        Pointer to the FV shadow PPI, or NULL.
+  @param[in]   HashMask           Bitmap (HASH_ALG_*) of the algorithms to use.
+  @param[in]   HashContext        Hash contexts, in the order of mHashAlgInfo.
+  @param[out]  Digest             Digests of the FV, in the order of mHashAlgInfo.
+
+  @retval TRUE   The FV is copied and hashed.
+  @retval FALSE  The hash computation failed.
+**/
+STATIC
+BOOLEAN
+CopyAndHashFv (
+  IN  EFI_PHYSICAL_ADDRESS                  FvBase,
+  OUT VOID                                  *FvBuffer,
+  IN  UINTN                                 FvLength,
+  IN  EDKII_PEI_FIRMWARE_VOLUME_SHADOW_PPI  *FvShadowPpi,
+  IN  UINT32                                HashMask,
+  IN  VOID                                  **HashContext,
+  OUT TPMU_HA                               *Digest
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Shadowed;
+  UINTN       Offset;
+  UINTN       Size;
+  UINT8       *Piece;
+  UINTN       Index;
+
+  Shadowed = FALSE;
+  if (FvShadowPpi != NULL) {
+    Status   = FvShadowPpi->FirmwareVolumeShadow (FvBase, FvBuffer, FvLength);
+    Shadowed = (BOOLEAN) !EFI_ERROR (Status);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    if (((mHashAlgInfo[Index].HashMask & HashMask) != 0) &&
+        !mHashAlgInfo[Index].HashInit (HashContext[Index]))
+    {
+      return FALSE;
+    }
+  }
+
+  for (Offset = 0; Offset < FvLength; Offset += Size) {
+    Size  = MIN (FvLength - Offset, FV_HASH_CHUNK_SIZE);
+    Piece = (UINT8 *)FvBuffer + Offset;
+    if (!Shadowed) {
+      CopyMem (Piece, (CONST UINT8 *)(UINTN)FvBase + Offset, Size);
+    }
+
+    for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+      if (((mHashAlgInfo[Index].HashMask & HashMask) != 0) &&
+          !mHashAlgInfo[Index].HashUpdate (HashContext[Index], Piece, Size))
+      {
+        return FALSE;
+      }
+    }
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    if (((mHashAlgInfo[Index].HashMask & HashMask) != 0) &&
+        !mHashAlgInfo[Index].HashFinal (HashContext[Index], (UINT8 *)&Digest[Index]))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Calculate and verify hash value for given FV.
 
+  The FVs to be measured are also hashed with the algorithms of the active PCR
+  banks in the same pass, so that the TCG driver doesn't need to hash them again.
+
   @param[in]  HashInfo            Hash information of the FV.
   @param[in]  FvInfo              Information of FV used for verification.
   @param[in]  FvNumber            Length of the FV.
@@ -121,6 +219,12 @@ VerifyHashedFv (
   VOID                                  *FvBuffer;
   EDKII_PEI_FIRMWARE_VOLUME_SHADOW_PPI  *FvShadowPpi;
   EFI_STATUS                            Status;
+  UINT32                                MeasureHashMask;
+  UINT32                                FvHashMask;
+  VOID                                  *HashContext[ARRAY_SIZE (mHashAlgInfo)];
+  TPMU_HA                               FvDigest[ARRAY_SIZE (mHashAlgInfo)];
+  UINTN                                 AlgIndex;
+  UINTN                                 Index;
 
   if ((HashInfo == NULL) ||
       (HashInfo->HashSize == 0) ||
@@ -150,6 +254,25 @@ VerifyHashedFv (
   HashValue = AllocateZeroPool (AlgInfo->HashSize * (FvNumber + 1));
   ASSERT (HashValue != NULL);
 
+  //
+  // Allocate the contexts of the verification algorithm and of the algorithms
+  // of the active PCR banks. PcdTpm2HashMask only describes the banks Tcg2Pei
+  // extends when the TPM instance is a TPM 2.0 device.
+  //
+  AlgIndex        = AlgInfo - mHashAlgInfo;
+  MeasureHashMask = 0;
+  if (CompareGuid (PcdGetPtr (PcdTpmInstanceGuid), &gEfiTpmDeviceInstanceTpm20DtpmGuid)) {
+    MeasureHashMask = PcdGet32 (PcdTpm2HashMask);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    HashContext[Index] = NULL;
+    if ((Index == AlgIndex) || ((mHashAlgInfo[Index].HashMask & MeasureHashMask) != 0)) {
+      HashContext[Index] = AllocatePool (mHashAlgInfo[Index].HashGetContextSize ());
+      ASSERT (HashContext[Index] != NULL);
+    }
+  }
+
   Status = PeiServicesLocatePpi (
              &gEdkiiPeiFirmwareVolumeShadowPpiGuid,
              0,
@@ -199,33 +322,34 @@ VerifyHashedFv (
       ));
 
     //
-    // Copy FV to permanent memory to avoid potential TOC/TOU.
+    // Copy FV to permanent memory to avoid potential TOC/TOU, and hash the
+    // copy while it is made.
     //
     FvBuffer = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN)FvInfo[FvIndex].Length));
 
     ASSERT (FvBuffer != NULL);
 
-    if (FvShadowPpi != NULL) {
-      Status = FvShadowPpi->FirmwareVolumeShadow (
-                              (EFI_PHYSICAL_ADDRESS)FvInfo[FvIndex].Base,
-                              FvBuffer,
-                              (UINTN)FvInfo[FvIndex].Length
-                              );
-    }
-
-    if ((FvShadowPpi == NULL) || (EFI_ERROR (Status))) {
-      CopyMem (
-        FvBuffer,
-        (CONST VOID *)(UINTN)FvInfo[FvIndex].Base,
-        (UINTN)FvInfo[FvIndex].Length
-        );
+    FvHashMask = AlgInfo->HashMask;
+    if ((FvInfo[FvIndex].Flag & HASHED_FV_FLAG_MEASURED_BOOT) != 0) {
+      FvHashMask |= MeasureHashMask;
     }
 
-    if (!AlgInfo->HashAll (FvBuffer, (UINTN)FvInfo[FvIndex].Length, FvHashValue)) {
+    if (!CopyAndHashFv (
+           (EFI_PHYSICAL_ADDRESS)FvInfo[FvIndex].Base,
+           FvBuffer,
+           (UINTN)FvInfo[FvIndex].Length,
+           FvShadowPpi,
+           FvHashMask,
+           HashContext,
+           FvDigest
+           ))
+    {
       Status = EFI_ABORTED;
       goto Done;
     }
 
+    CopyMem (FvHashValue, &FvDigest[AlgIndex], AlgInfo->HashSize);
+
     //
     // Report the FV measurement.
     //
@@ -233,9 +357,8 @@ VerifyHashedFv (
       InstallPreHashFvPpi (
         FvBuffer,
         (UINTN)FvInfo[FvIndex].Length,
-        HashInfo->HashAlgoId,
-        HashInfo->HashSize,
-        FvHashValue
+        FvHashMask,
+        FvDigest
         );
     }
 
@@ -265,6 +388,12 @@ VerifyHashedFv (
   }
 
 Done:
+  for (Index = 0; Index < ARRAY_SIZE (mHashAlgInfo); ++Index) {
+    if (HashContext[Index] != NULL) {
+      FreePool (HashContext[Index]);
+    }
+  }
+
   FreePool (HashValue);
   return Status;
 }
@@ -16,6 +16,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Ppi/FirmwareVolumeInfoStoredHashFv.h>
 #include <Ppi/FirmwareVolumeShadowPpi.h>
 
+#include <Guid/TpmInstance.h>
+
 #include <Library/PeiServicesLib.h>
 #include <Library/PcdLib.h>
 #include <Library/HobLib.h>
@@ -31,6 +33,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HASH_VALUE_PTR(HashInfo)   \
   (VOID *)((UINT8 *)(HashInfo) + sizeof (HASH_INFO))
 
+/**
+  Retrieves the size, in bytes, of the context buffer required for hash operations.
+
+  @return  The size, in bytes, of the context buffer required for hash operations.
+
+**/
+typedef
+UINTN
+(EFIAPI *HASH_GET_CONTEXT_SIZE_METHOD)(
+  VOID
+  );
+
 /**
   Computes the message digest of a input data buffer.
 
@@ -111,12 +125,14 @@ BOOLEAN
   );
 
 typedef struct {
-  UINT16                HashAlgId;
-  UINTN                 HashSize;
-  HASH_INIT_METHOD      HashInit;
-  HASH_UPDATE_METHOD    HashUpdate;
-  HASH_FINAL_METHOD     HashFinal;
-  HASH_ALL_METHOD       HashAll;
+  UINT16                          HashAlgId;
+  UINT32                          HashMask;
+  UINTN                           HashSize;
+  HASH_GET_CONTEXT_SIZE_METHOD    HashGetContextSize;
+  HASH_INIT_METHOD                HashInit;
+  HASH_UPDATE_METHOD              HashUpdate;
+  HASH_FINAL_METHOD               HashFinal;
+  HASH_ALL_METHOD                 HashAll;
 } HASH_ALG_INFO;
 
 #endif //__FV_REPORT_PEI_H__
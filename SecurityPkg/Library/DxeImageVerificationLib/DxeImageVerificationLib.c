@@ -36,6 +36,12 @@ UINT8  *mImageBase = NULL;
 UINT8  mImageDigest[MAX_DIGEST_SIZE];
 UINTN  mImageDigestSize;
 
+//
+// Authenticode digests of the current image, indexed by hash algorithm type.
+// They are discarded each time a new image is verified.
+//
+IMAGE_DIGEST_CACHE  mImageDigestCache[HASHALG_MAX];
+
 //
 // Notify string for authorization UI.
 //
@@ -71,6 +77,37 @@ HASH_TABLE  mHash[] = {
 
 EFI_STRING  mHashTypeStr;
 
+//
+// Index of the allowed (db) and forbidden (dbx) signature databases. They are
+// refreshed for each image, and only rebuilt when the database changes.
+//
+SIGNATURE_DATABASE_INDEX  mDbIndex;
+SIGNATURE_DATABASE_INDEX  mDbxIndex;
+UINT8                     *mSignatureDatabaseBuffer    = NULL;
+UINTN                     mSignatureDatabaseBufferSize = 0;
+
+//
+// PKCS#7 verification contexts of the certificates in db, created on first
+// use and released when the db index is rebuilt.
+//
+VOID   **mDbVerifyContext         = NULL;
+UINTN  mDbVerifyContextCount      = 0;
+UINTN  mDbVerifyContextGeneration = 0;
+
+//
+// Certificate hash types in the forbidden database, with their hash algorithm.
+//
+typedef struct {
+  EFI_GUID    *Guid;
+  UINT32      HashAlg;
+} CERT_HASH_TYPE;
+
+CERT_HASH_TYPE  mCertHashType[] = {
+  { &gEfiCertX509Sha256Guid, HASHALG_SHA256 },
+  { &gEfiCertX509Sha384Guid, HASHALG_SHA384 },
+  { &gEfiCertX509Sha512Guid, HASHALG_SHA512 }
+};
+
 /**
   SecureBoot Hook for processing image verification.
 
@@ -272,8 +309,49 @@ GetImageType (
 }
 
 /**
-  Calculate hash of Pe/Coff image based on the authenticode image hashing in
-  PE/COFF Specification 8.0 Appendix A
+  Feed a range of the Pe/Coff image to every hash context in use.
+
+  The range is fed in chunks, so that each chunk is still in the cache when it
+  is hashed by the next algorithm.
+
+  @param[in]    HashCtx   Hash contexts indexed by hash algorithm type, NULL if unused.
+  @param[in]    HashBase  Start of the range.
+  @param[in]    HashSize  Size of the range in bytes.
+
+  @retval TRUE            Successfully hash the range.
+  @retval FALSE           Fail in hash the range.
+
+**/
+BOOLEAN
+HashPeImageUpdate (
+  IN VOID   **HashCtx,
+  IN UINT8  *HashBase,
+  IN UINTN  HashSize
+  )
+{
+  UINTN   ChunkSize;
+  UINT32  HashAlg;
+
+  while (HashSize > 0) {
+    ChunkSize = MIN (HashSize, IMAGE_HASH_CHUNK_SIZE);
+    for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+      if ((HashCtx[HashAlg] != NULL) && !mHash[HashAlg].HashUpdate (HashCtx[HashAlg], HashBase, ChunkSize)) {
+        return FALSE;
+      }
+    }
+
+    HashBase += ChunkSize;
+    HashSize -= ChunkSize;
+  }
+
+  return TRUE;
+}
+
+/**
+  Calculate hashes of Pe/Coff image based on the authenticode image hashing in
+  PE/COFF Specification 8.0 Appendix A, for several hash algorithms in a single
+  pass over the image. The digests are kept in mImageDigestCache until the next
+  image is verified.
 
   Caution: This function may receive untrusted input.
   PE/COFF image is external input, so this function will validate its data structure
@@ -282,21 +360,22 @@ GetImageType (
   Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
   its caller function DxeImageVerificationHandler().
 
-  @param[in]    HashAlg   Hash algorithm type.
+  @param[in]    HashAlgMask   Bitmask of the hash algorithm types, BIT0 for HASHALG_SHA1.
+                              The algorithms already hashed or not supported are skipped.
 
   @retval TRUE            Successfully hash image.
   @retval FALSE           Fail in hash image.
 
 **/
 BOOLEAN
-HashPeImage (
-  IN  UINT32  HashAlg
+HashPeImageDigests (
+  IN  UINT32  HashAlgMask
   )
 {
   BOOLEAN                   Status;
   EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
+  VOID                      *HashCtx[HASHALG_MAX];
+  UINT32                    HashAlg;
   UINT8                     *HashBase;
   UINTN                     HashSize;
   UINTN                     SumOfBytesHashed;
@@ -306,61 +385,40 @@ HashPeImage (
   UINT32                    CertSize;
   UINT32                    NumberOfRvaAndSizes;
 
-  HashCtx       = NULL;
   SectionHeader = NULL;
   Status        = FALSE;
+  ZeroMem (HashCtx, sizeof (HashCtx));
 
-  if ((HashAlg >= HASHALG_MAX)) {
-    return FALSE;
-  }
-
-  //
-  // Initialize context of hash.
-  //
-  ZeroMem (mImageDigest, MAX_DIGEST_SIZE);
-
-  switch (HashAlg) {
- #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
-    case HASHALG_SHA1:
-      mImageDigestSize = SHA1_DIGEST_SIZE;
-      mCertType        = gEfiCertSha1Guid;
-      break;
- #endif
-
-    case HASHALG_SHA256:
-      mImageDigestSize = SHA256_DIGEST_SIZE;
-      mCertType        = gEfiCertSha256Guid;
-      break;
-
-    case HASHALG_SHA384:
-      mImageDigestSize = SHA384_DIGEST_SIZE;
-      mCertType        = gEfiCertSha384Guid;
-      break;
+  // 1.  Load the image header into memory.
 
-    case HASHALG_SHA512:
-      mImageDigestSize = SHA512_DIGEST_SIZE;
-      mCertType        = gEfiCertSha512Guid;
-      break;
+  // 2.  Initialize a SHA hash context for each algorithm.
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (((HashAlgMask & (1 << HashAlg)) == 0) || mImageDigestCache[HashAlg].Valid) {
+      continue;
+    }
 
-    default:
-      return FALSE;
-  }
+    if ((mHash[HashAlg].GetContextSize == NULL) || (mHash[HashAlg].HashInit == NULL) ||
+        (mHash[HashAlg].HashUpdate == NULL) || (mHash[HashAlg].HashFinal == NULL))
+    {
+      continue;
+    }
 
-  mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize      = mHash[HashAlg].GetContextSize ();
+    HashCtx[HashAlg] = AllocatePool (mHash[HashAlg].GetContextSize ());
+    if (HashCtx[HashAlg] == NULL) {
+      goto Done;
+    }
 
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
-    return FALSE;
+    Status = mHash[HashAlg].HashInit (HashCtx[HashAlg]);
+    if (!Status) {
+      goto Done;
+    }
   }
 
-  // 1.  Load the image header into memory.
-
-  // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit (HashCtx);
-
   if (!Status) {
-    goto Done;
+    //
+    // All the requested digests are already available.
+    //
+    return TRUE;
   }
 
   //
@@ -393,7 +451,7 @@ HashPeImage (
     goto Done;
   }
 
-  Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+  Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
   if (!Status) {
     goto Done;
   }
@@ -421,7 +479,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -445,7 +503,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -470,7 +528,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -545,7 +603,7 @@ HashPeImage (
     HashBase = mImageBase + Section->PointerToRawData;
     HashSize = (UINTN)Section->SizeOfRawData;
 
-    Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+    Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
     if (!Status) {
       goto Done;
     }
@@ -581,7 +639,7 @@ HashPeImage (
     if (mImageSize > CertSize + SumOfBytesHashed) {
       HashSize = (UINTN)(mImageSize - CertSize - SumOfBytesHashed);
 
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -591,11 +649,28 @@ HashPeImage (
     }
   }
 
-  Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (HashCtx[HashAlg] == NULL) {
+      continue;
+    }
+
+    Status = mHash[HashAlg].HashFinal (HashCtx[HashAlg], mImageDigestCache[HashAlg].Digest);
+    if (!Status) {
+      goto Done;
+    }
+  }
+
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (HashCtx[HashAlg] != NULL) {
+      mImageDigestCache[HashAlg].Valid = TRUE;
+    }
+  }
 
 Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (HashCtx[HashAlg] != NULL) {
+      FreePool (HashCtx[HashAlg]);
+    }
   }
 
   if (SectionHeader != NULL) {
@@ -605,6 +680,79 @@ Done:
   return Status;
 }
 
+/**
+  Calculate hash of Pe/Coff image based on the authenticode image hashing in
+  PE/COFF Specification 8.0 Appendix A
+
+  The digest is taken from mImageDigestCache if the image is already hashed
+  with the algorithm.
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
+  its caller function DxeImageVerificationHandler().
+
+  @param[in]    HashAlg   Hash algorithm type.
+
+  @retval TRUE            Successfully hash image.
+  @retval FALSE           Fail in hash image.
+
+**/
+BOOLEAN
+HashPeImage (
+  IN  UINT32  HashAlg
+  )
+{
+  if ((HashAlg >= HASHALG_MAX)) {
+    return FALSE;
+  }
+
+  //
+  // Initialize context of hash.
+  //
+  ZeroMem (mImageDigest, MAX_DIGEST_SIZE);
+
+  switch (HashAlg) {
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+    case HASHALG_SHA1:
+      mImageDigestSize = SHA1_DIGEST_SIZE;
+      mCertType        = gEfiCertSha1Guid;
+      break;
+ #endif
+
+    case HASHALG_SHA256:
+      mImageDigestSize = SHA256_DIGEST_SIZE;
+      mCertType        = gEfiCertSha256Guid;
+      break;
+
+    case HASHALG_SHA384:
+      mImageDigestSize = SHA384_DIGEST_SIZE;
+      mCertType        = gEfiCertSha384Guid;
+      break;
+
+    case HASHALG_SHA512:
+      mImageDigestSize = SHA512_DIGEST_SIZE;
+      mCertType        = gEfiCertSha512Guid;
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  mHashTypeStr = mHash[HashAlg].Name;
+
+  if (!mImageDigestCache[HashAlg].Valid) {
+    if (!HashPeImageDigests (1 << HashAlg) || !mImageDigestCache[HashAlg].Valid) {
+      return FALSE;
+    }
+  }
+
+  CopyMem (mImageDigest, mImageDigestCache[HashAlg].Digest, mImageDigestSize);
+  return TRUE;
+}
+
 /**
   Recognize the Hash algorithm in PE/COFF Authenticode and calculate hash of
   Pe/Coff image based on the authenticode image hashing in PE/COFF Specification
@@ -826,13 +974,84 @@ AddImageExeInfo (
   }
 }
 
+/**
+  Refresh the index of a signature database from its variable.
+
+  The variable is read into a buffer kept between the calls, and the index is
+  only rebuilt when the content differs from the one it was built from.
+
+  @param[in]       VariableName   Name of the database variable.
+  @param[in, out]  Index          Pointer to the index of the database.
+
+  @retval EFI_SUCCESS             The index is up to date.
+  @retval EFI_NOT_FOUND           The database doesn't exist.
+  @retval Others                  Failed to read or index the database.
+
+**/
+EFI_STATUS
+RefreshSignatureDatabase (
+  IN     CHAR16                    *VariableName,
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       DataSize;
+  UINT8       *Data;
+
+  DataSize = mSignatureDatabaseBufferSize;
+  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, mSignatureDatabaseBuffer);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    if (mSignatureDatabaseBuffer != NULL) {
+      FreePool (mSignatureDatabaseBuffer);
+    }
+
+    mSignatureDatabaseBufferSize = 0;
+    mSignatureDatabaseBuffer     = AllocatePool (DataSize);
+    if (mSignatureDatabaseBuffer == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      mSignatureDatabaseBufferSize = DataSize;
+      Status                       = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, mSignatureDatabaseBuffer);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (Index->Status != Status) {
+      SignatureIndexReset (Index, Status);
+    }
+
+    return Status;
+  }
+
+  if (SignatureIndexIsCurrent (Index, mSignatureDatabaseBuffer, DataSize)) {
+    return EFI_SUCCESS;
+  }
+
+  Data = AllocateCopyPool (DataSize, mSignatureDatabaseBuffer);
+  if (Data == NULL) {
+    SignatureIndexReset (Index, EFI_OUT_OF_RESOURCES);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SignatureIndexBuild (Index, Data, DataSize);
+  DEBUG ((
+    DEBUG_INFO,
+    "DxeImageVerificationLib: Indexed %s: %r, %d hashes, %d certificates.\n",
+    VariableName,
+    Status,
+    Index->HashCount,
+    Index->CertCount
+    ));
+
+  return Status;
+}
+
 /**
   Check whether the hash of an given X.509 certificate is in forbidden database (DBX).
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
+  @param[in]  DbxIndex          Pointer to the index of the forbidden database.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
   @param[out] IsFound           Search result. Only valid if EFI_SUCCESS returned.
 
@@ -842,36 +1061,31 @@ AddImageExeInfo (
 **/
 EFI_STATUS
 IsCertHashFoundInDbx (
-  IN  UINT8               *Certificate,
-  IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
-  OUT EFI_TIME            *RevocationTime,
-  OUT BOOLEAN             *IsFound
+  IN  UINT8                           *Certificate,
+  IN  UINTN                           CertSize,
+  IN  CONST SIGNATURE_DATABASE_INDEX  *DbxIndex,
+  OUT EFI_TIME                        *RevocationTime,
+  OUT BOOLEAN                         *IsFound
   )
 {
-  EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
-  EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
-  UINTN               Index;
-  UINT32              HashAlg;
-  VOID                *HashCtx;
-  UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
-  UINT8               *TBSCert;
-  UINTN               TBSCertSize;
-
-  Status   = EFI_ABORTED;
-  *IsFound = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
-  HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
-
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  EFI_STATUS                   Status;
+  CONST SIGNATURE_INDEX_ENTRY  *Entry;
+  CONST SIGNATURE_INDEX_ENTRY  *Match;
+  UINTN                        Index;
+  UINT32                       HashAlg;
+  VOID                         *HashCtx;
+  UINT8                        CertDigest[MAX_DIGEST_SIZE];
+  UINTN                        DigestLength;
+  UINT8                        *TBSCert;
+  UINTN                        TBSCertSize;
+
+  Status       = EFI_ABORTED;
+  *IsFound     = FALSE;
+  HashCtx      = NULL;
+  Match        = NULL;
+  DigestLength = 0;
+
+  if ((RevocationTime == NULL) || (DbxIndex == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -882,25 +1096,18 @@ IsCertHashFoundInDbx (
     return Status;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
+  for (Index = 0; Index < ARRAY_SIZE (mCertHashType); Index++) {
     //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
+    // Only hash the certificate with the algorithms used in the forbidden database.
     //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+    if (!SignatureIndexHasType (DbxIndex, mCertHashType[Index].Guid)) {
       continue;
     }
 
     //
     // Calculate the hash value of current TBSCertificate for comparision.
     //
+    HashAlg = mCertHashType[Index].HashAlg;
     if (mHash[HashAlg].GetContextSize == NULL) {
       goto Done;
     }
@@ -926,33 +1133,26 @@ IsCertHashFoundInDbx (
     FreePool (HashCtx);
     HashCtx = NULL;
 
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *)((UINT8 *)DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
-      //
-      // Iterate each Signature Data Node within this CertList for verify.
-      //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        Status   = EFI_SUCCESS;
-        *IsFound = TRUE;
-
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
-      }
-
-      CertHash = (EFI_SIGNATURE_DATA *)((UINT8 *)CertHash + DbxList->SignatureSize);
+    //
+    // Keep the match which comes first in the forbidden database.
+    //
+    Entry = SignatureIndexFindHash (DbxIndex, mCertHashType[Index].Guid, CertDigest, mHash[HashAlg].DigestLength);
+    if ((Entry != NULL) && ((Match == NULL) || ((UINTN)Entry->Data < (UINTN)Match->Data))) {
+      Match        = Entry;
+      DigestLength = mHash[HashAlg].DigestLength;
     }
+  }
 
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+  if (Match != NULL) {
+    //
+    // Hash of Certificate is found in forbidden database. Return the revocation
+    // time, or a zero time (revoked at any time) if the entry has none.
+    //
+    *IsFound = TRUE;
+    ZeroMem (RevocationTime, sizeof (EFI_TIME));
+    if (Match->List->SignatureSize >= sizeof (EFI_GUID) + DigestLength + sizeof (EFI_TIME)) {
+      CopyMem (RevocationTime, Match->Data->SignatureData + DigestLength, sizeof (EFI_TIME));
+    }
   }
 
   Status = EFI_SUCCESS;
@@ -987,84 +1187,45 @@ IsSignatureFoundInDatabase (
   OUT BOOLEAN   *IsFound
   )
 {
-  EFI_STATUS          Status;
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
+  SIGNATURE_DATABASE_INDEX     *Index;
+  CONST SIGNATURE_INDEX_ENTRY  *Entry;
 
-  //
-  // Read signature database variable.
-  //
   *IsFound = FALSE;
-  Data     = NULL;
-  DataSize = 0;
-  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status == EFI_NOT_FOUND) {
-      //
-      // No database, no need to search.
-      //
-      Status = EFI_SUCCESS;
-    }
 
-    return Status;
+  if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    Index = &mDbIndex;
+  } else if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE1) == 0) {
+    Index = &mDbxIndex;
+  } else {
+    return EFI_UNSUPPORTED;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  if (Index->Status == EFI_NOT_FOUND) {
+    //
+    // No database, no need to search.
+    //
+    return EFI_SUCCESS;
   }
 
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
+  if (EFI_ERROR (Index->Status)) {
+    return Index->Status;
   }
 
-  //
-  // Enumerate all signature data in SigDB to check if signature exists for executable.
-  //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          *IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-      }
-
-      if (*IsFound) {
-        break;
-      }
+  Entry = SignatureIndexFindHash (Index, CertType, Signature, SignatureSize);
+  if (Entry != NULL) {
+    //
+    // Find the signature in database.
+    //
+    *IsFound = TRUE;
+    //
+    // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+    //
+    if (Index == &mDbIndex) {
+      SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, Entry->List->SignatureSize, Entry->Data);
     }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
-  }
-
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1248,37 +1409,25 @@ IsForbiddenByDbx (
   IN UINTN  AuthDataSize
   )
 {
-  EFI_STATUS          Status;
-  BOOLEAN             IsForbidden;
-  BOOLEAN             IsFound;
-  UINT8               *Data;
-  UINTN               DataSize;
-  EFI_SIGNATURE_LIST  *CertList;
-  UINTN               CertListSize;
-  EFI_SIGNATURE_DATA  *CertData;
-  UINT8               *RootCert;
-  UINTN               RootCertSize;
-  UINTN               CertCount;
-  UINTN               Index;
-  UINT8               *CertBuffer;
-  UINTN               BufferLength;
-  UINT8               *TrustedCert;
-  UINTN               TrustedCertLength;
-  UINT8               CertNumber;
-  UINT8               *CertPtr;
-  UINT8               *Cert;
-  UINTN               CertSize;
-  EFI_TIME            RevocationTime;
+  EFI_STATUS            Status;
+  BOOLEAN               IsForbidden;
+  BOOLEAN               IsFound;
+  SIGNATURE_INDEX_CERT  *DbxCert;
+  UINTN                 Index;
+  UINT8                 *CertBuffer;
+  UINTN                 BufferLength;
+  UINT8                 *TrustedCert;
+  UINTN                 TrustedCertLength;
+  UINT8                 CertNumber;
+  UINT8                 *CertPtr;
+  UINT8                 *Cert;
+  UINTN                 CertSize;
+  EFI_TIME              RevocationTime;
 
   //
   // Variable Initialization
   //
   IsForbidden       = TRUE;
-  Data              = NULL;
-  CertList          = NULL;
-  CertData          = NULL;
-  RootCert          = NULL;
-  RootCertSize      = 0;
   Cert              = NULL;
   CertBuffer        = NULL;
   BufferLength      = 0;
@@ -1288,11 +1437,8 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status == EFI_NOT_FOUND) {
+  if (mDbxIndex.Status != EFI_SUCCESS) {
+    if (mDbxIndex.Status == EFI_NOT_FOUND) {
       //
       // Evidently not in dbx if the database doesn't exist.
       //
@@ -1302,56 +1448,28 @@ IsForbiddenByDbx (
     return IsForbidden;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
   // Verify image signature with RAW X509 certificates in DBX database.
   // If passed, the image will be forbidden.
   //
-  CertList     = (EFI_SIGNATURE_LIST *)Data;
-  CertListSize = DataSize;
-  while ((CertListSize > 0) && (CertListSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
-        //
-        // Iterate each Signature Data Node within this CertList for verify.
-        //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
-
-        //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
-        //
-        IsForbidden = AuthenticodeVerify (
-                        AuthData,
-                        AuthDataSize,
-                        RootCert,
-                        RootCertSize,
-                        mImageDigest,
-                        mImageDigestSize
-                        );
-        if (IsForbidden) {
-          DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
-          goto Done;
-        }
+  for (Index = 0; Index < mDbxIndex.CertCount; Index++) {
+    DbxCert = &mDbxIndex.Certs[Index];
 
-        CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertData + CertList->SignatureSize);
-      }
+    //
+    // Call AuthenticodeVerify library to Verify Authenticode struct.
+    //
+    IsForbidden = AuthenticodeVerify (
+                    AuthData,
+                    AuthDataSize,
+                    DbxCert->Cert,
+                    DbxCert->CertSize,
+                    mImageDigest,
+                    mImageDigestSize
+                    );
+    if (IsForbidden) {
+      DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed but signature is forbidden by DBX.\n"));
+      goto Done;
     }
-
-    CertListSize -= CertList->SignatureListSize;
-    CertList      = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
   }
 
   //
@@ -1389,7 +1507,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    Status = IsCertHashFoundInDbx (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime, &IsFound);
+    Status = IsCertHashFoundInDbx (Cert, CertSize, &mDbxIndex, &RevocationTime, &IsFound);
     if (EFI_ERROR (Status)) {
       //
       // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1418,16 +1536,69 @@ IsForbiddenByDbx (
   IsForbidden = FALSE;
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
   return IsForbidden;
 }
 
+/**
+  Get the PKCS#7 verification context of a certificate in db.
+
+  The contexts keep the parsed certificate and the certificate chains already
+  verified up to it, so that images signed by the same signer don't repeat
+  this work. They are released when the db index is rebuilt.
+
+  @param[in]  CertIndex     Index of the certificate in the db index.
+
+  @return  The PKCS#7 verification context, or NULL if it can't be created.
+
+**/
+VOID *
+GetDbVerifyContext (
+  IN UINTN  CertIndex
+  )
+{
+  UINTN  Index;
+
+  if ((mDbVerifyContext != NULL) && (mDbVerifyContextGeneration != mDbIndex.Generation)) {
+    for (Index = 0; Index < mDbVerifyContextCount; Index++) {
+      if (mDbVerifyContext[Index] != NULL) {
+        Pkcs7VerifyContextFree (mDbVerifyContext[Index]);
+      }
+    }
+
+    FreePool (mDbVerifyContext);
+    mDbVerifyContext      = NULL;
+    mDbVerifyContextCount = 0;
+  }
+
+  if (mDbVerifyContext == NULL) {
+    if (mDbIndex.CertCount == 0) {
+      return NULL;
+    }
+
+    mDbVerifyContext = AllocateZeroPool (mDbIndex.CertCount * sizeof (VOID *));
+    if (mDbVerifyContext == NULL) {
+      return NULL;
+    }
+
+    mDbVerifyContextCount      = mDbIndex.CertCount;
+    mDbVerifyContextGeneration = mDbIndex.Generation;
+  }
+
+  ASSERT (CertIndex < mDbVerifyContextCount);
+
+  if (mDbVerifyContext[CertIndex] == NULL) {
+    mDbVerifyContext[CertIndex] = Pkcs7VerifyContextNew (
+                                    mDbIndex.Certs[CertIndex].Cert,
+                                    mDbIndex.Certs[CertIndex].CertSize
+                                    );
+  }
+
+  return mDbVerifyContext[CertIndex];
+}
+
 /**
   Check whether the image signature can be verified by the trusted certificates in DB database.
 
@@ -1444,163 +1615,103 @@ IsAllowedByDb (
   IN UINTN  AuthDataSize
   )
 {
-  EFI_STATUS          Status;
-  BOOLEAN             VerifyStatus;
-  BOOLEAN             IsFound;
-  EFI_SIGNATURE_LIST  *CertList;
-  EFI_SIGNATURE_DATA  *CertData;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINT8               *RootCert;
-  UINTN               RootCertSize;
-  UINTN               Index;
-  UINTN               CertCount;
-  UINTN               DbxDataSize;
-  UINT8               *DbxData;
-  EFI_TIME            RevocationTime;
+  BOOLEAN               VerifyStatus;
+  SIGNATURE_INDEX_CERT  *DbCert;
+  UINTN                 Index;
+  VOID                  *VerifyContext;
 
-  Data         = NULL;
-  CertList     = NULL;
-  CertData     = NULL;
-  RootCert     = NULL;
-  DbxData      = NULL;
-  RootCertSize = 0;
+  DbCert       = NULL;
   VerifyStatus = FALSE;
 
   //
-  // Fetch 'db' content. If 'db' doesn't exist or encounters problem to get the
-  // data, return not-allowed-by-db (FALSE).
+  // If 'db' doesn't exist or encounters problem to get the data, return
+  // not-allowed-by-db (FALSE).
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  if (mDbIndex.Status != EFI_SUCCESS) {
     return VerifyStatus;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
+  //
+  // If 'dbx' doesn't exist, continue to check 'db'. If any other errors
+  // occurred, no need to check 'db' but just return not-allowed-by-db (FALSE)
+  // to avoid bypass.
+  //
+  if ((mDbxIndex.Status != EFI_SUCCESS) && (mDbxIndex.Status != EFI_NOT_FOUND)) {
     return VerifyStatus;
   }
 
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
-  // Fetch 'dbx' content. If 'dbx' doesn't exist, continue to check 'db'.
-  // If any other errors occurred, no need to check 'db' but just return
-  // not-allowed-by-db (FALSE) to avoid bypass.
+  // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
   //
-  DbxDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status != EFI_NOT_FOUND) {
-      goto Done;
-    }
+  for (Index = 0; Index < mDbIndex.CertCount; Index++) {
+    DbCert = &mDbIndex.Certs[Index];
 
     //
-    // 'dbx' does not exist. Continue to check 'db'.
+    // Call AuthenticodeVerify library to Verify Authenticode struct, with the
+    // verification context of the certificate if there is one.
     //
-  } else {
-    //
-    // 'dbx' exists. Get its content.
-    //
-    DbxData = (UINT8 *)AllocateZeroPool (DbxDataSize);
-    if (DbxData == NULL) {
-      goto Done;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *)DbxData);
-    if (EFI_ERROR (Status)) {
-      goto Done;
+    VerifyContext = GetDbVerifyContext (Index);
+    if (VerifyContext != NULL) {
+      VerifyStatus = AuthenticodeVerifyWithContext (
+                       VerifyContext,
+                       AuthData,
+                       AuthDataSize,
+                       mImageDigest,
+                       mImageDigestSize
+                       );
+    } else {
+      VerifyStatus = AuthenticodeVerify (
+                       AuthData,
+                       AuthDataSize,
+                       DbCert->Cert,
+                       DbCert->CertSize,
+                       mImageDigest,
+                       mImageDigestSize
+                       );
     }
-  }
-
-  //
-  // Find X509 certificate in Signature List to verify the signature in pkcs7 signed data.
-  //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    if (CompareGuid (&CertList->SignatureType, &gEfiCertX509Guid)) {
-      CertData  = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-      CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-
-      for (Index = 0; Index < CertCount; Index++) {
+    if (VerifyStatus) {
+      //
+      // The image is signed and its signature is found in 'db'.
+      //
+      if (mDbxIndex.Status == EFI_SUCCESS) {
         //
-        // Iterate each Signature Data Node within this CertList for verify.
+        // Here We still need to check if this RootCert's Hash is revoked. The
+        // result is kept with the certificate until dbx changes.
         //
-        RootCert     = CertData->SignatureData;
-        RootCertSize = CertList->SignatureSize - sizeof (EFI_GUID);
+        if (DbCert->DbxGeneration != mDbxIndex.Generation) {
+          DbCert->DbxStatus     = IsCertHashFoundInDbx (DbCert->Cert, DbCert->CertSize, &mDbxIndex, &DbCert->RevocationTime, &DbCert->DbxFound);
+          DbCert->DbxGeneration = mDbxIndex.Generation;
+        }
 
-        //
-        // Call AuthenticodeVerify library to Verify Authenticode struct.
-        //
-        VerifyStatus = AuthenticodeVerify (
-                         AuthData,
-                         AuthDataSize,
-                         RootCert,
-                         RootCertSize,
-                         mImageDigest,
-                         mImageDigestSize
-                         );
-        if (VerifyStatus) {
+        if (EFI_ERROR (DbCert->DbxStatus)) {
           //
-          // The image is signed and its signature is found in 'db'.
+          // Error in searching dbx. Consider it as 'found'. RevocationTime might
+          // not be valid in such situation.
           //
-          if (DbxData != NULL) {
-            //
-            // Here We still need to check if this RootCert's Hash is revoked
-            //
-            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime, &IsFound);
-            if (EFI_ERROR (Status)) {
-              //
-              // Error in searching dbx. Consider it as 'found'. RevocationTime might
-              // not be valid in such situation.
-              //
-              VerifyStatus = FALSE;
-            } else if (IsFound) {
-              //
-              // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
-              //
-              VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &RevocationTime);
-              if (!VerifyStatus) {
-                DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
-              }
-            }
-          }
-
+          VerifyStatus = FALSE;
+        } else if (DbCert->DbxFound) {
           //
-          // There's no 'dbx' to check revocation time against (must-be pass),
-          // or, there's revocation time found in 'dbx' and checked againt 'dbt'
-          // (maybe pass or fail, depending on timestamp compare result). Either
-          // way the verification job has been completed at this point.
+          // Check the timestamp signature and signing time to determine if the RootCert can be trusted.
           //
-          goto Done;
+          VerifyStatus = PassTimestampCheck (AuthData, AuthDataSize, &DbCert->RevocationTime);
+          if (!VerifyStatus) {
+            DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: Image is signed and signature is accepted by DB, but its root cert failed the timestamp check.\n"));
+          }
         }
-
-        CertData = (EFI_SIGNATURE_DATA *)((UINT8 *)CertData + CertList->SignatureSize);
       }
-    }
 
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+      //
+      // There's no 'dbx' to check revocation time against (must-be pass),
+      // or, there's revocation time found in 'dbx' and checked againt 'dbt'
+      // (maybe pass or fail, depending on timestamp compare result). Either
+      // way the verification job has been completed at this point.
+      //
+      break;
+    }
   }
 
-Done:
-
   if (VerifyStatus) {
-    SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
-  }
-
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
-  if (DbxData != NULL) {
-    FreePool (DbxData);
+    SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, DbCert->List->SignatureSize, DbCert->Data);
   }
 
   return VerifyStatus;
@@ -1777,6 +1888,7 @@ DxeImageVerificationHandler (
 
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
+  ZeroMem (mImageDigestCache, sizeof (mImageDigestCache));
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
@@ -1835,6 +1947,13 @@ DxeImageVerificationHandler (
     }
   }
 
+  //
+  // Refresh the index of db and dbx. They are only read once for the image,
+  // and only indexed again if they have changed since the previous image.
+  //
+  RefreshSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE, &mDbIndex);
+  RefreshSignatureDatabase (EFI_IMAGE_SECURITY_DATABASE1, &mDbxIndex);
+
   //
   // Start Image Validation.
   //
@@ -1842,7 +1961,10 @@ DxeImageVerificationHandler (
     //
     // This image is not signed. The hash value of the image must match a record in the security database "db",
     // and not be reflected in the security data base "dbx".
+    // The image is hashed with all supported algorithms in one pass, and
+    // HashPeImage() then picks up each digest.
     //
+    HashPeImageDigests (MAX_UINT32);
     HashAlg = sizeof (mHash) / sizeof (HASH_TABLE);
     while (HashAlg > 0) {
       HashAlg--;
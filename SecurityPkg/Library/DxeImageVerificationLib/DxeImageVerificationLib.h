@@ -32,6 +32,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AuthenticatedVariableFormat.h>
 #include <IndustryStandard/PeImage.h>
 
+#include "SignatureIndex.h"
+
 #define EFI_CERT_TYPE_RSA2048_SHA256_SIZE  256
 #define EFI_CERT_TYPE_RSA2048_SIZE         256
 #define MAX_NOTIFY_STRING_LEN              64
@@ -73,6 +75,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
 #define MAX_DIGEST_SIZE  SHA512_DIGEST_SIZE
+
+//
+// Size of the image ranges fed to each hash algorithm in turn when the image
+// is hashed with several algorithms in one pass.
+//
+#define IMAGE_HASH_CHUNK_SIZE  SIZE_64KB
 //
 //
 // PKCS7 Certificate definition
@@ -195,4 +203,12 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+//
+// Authenticode digest of the current image for one hash algorithm.
+//
+typedef struct {
+  BOOLEAN    Valid;
+  UINT8      Digest[MAX_DIGEST_SIZE];
+} IMAGE_DIGEST_CACHE;
+
 #endif
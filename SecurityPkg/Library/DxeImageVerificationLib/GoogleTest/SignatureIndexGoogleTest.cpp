@@ -0,0 +1,385 @@
+/** @file
+  Unit tests for the signature database index of DxeImageVerificationLib.
+
+  The tests build a forbidden database of the size of the published UEFI
+  revocation list: several hundred SHA256 image hashes appended by successive
+  updates, a few certificate hashes and certificates. The benchmark compares
+  the index with the linear search of the database it replaces. It only
+  reports the timings, it doesn't fail on them. It is disabled so that the
+  unit test run stays quiet, run it with --gtest_also_run_disabled_tests
+  --gtest_filter=*Benchmark.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Guid/ImageAuthentication.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/BaseCryptLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../SignatureIndex.h"
+}
+
+using namespace testing;
+
+//
+// The number of SHA256 hash entries of the forbidden database, and how many
+// signature lists they are split in.
+//
+#define TEST_DBX_HASH_COUNT     431
+#define TEST_DBX_UPDATE_COUNT   6
+#define TEST_DBX_CERT_HASHES    8
+#define TEST_DBX_CERTS          2
+#define TEST_BENCH_LOOKUPS      20000
+
+typedef std::vector<UINT8> BYTES;
+
+//
+// Append a signature list of SignatureCount entries of SignatureSize bytes,
+// filled with random data after the owner GUID.
+//
+static VOID
+AppendSignatureList (
+  BYTES           &Database,
+  const EFI_GUID  &Type,
+  UINT32          SignatureSize,
+  UINT32          SignatureCount,
+  std::mt19937    &Rng
+  )
+{
+  EFI_SIGNATURE_LIST  List;
+  UINTN               Offset;
+  UINTN               Index;
+
+  List.SignatureType       = Type;
+  List.SignatureHeaderSize = 0;
+  List.SignatureSize       = SignatureSize;
+  List.SignatureListSize   = (UINT32)(sizeof (EFI_SIGNATURE_LIST) + SignatureSize * SignatureCount);
+
+  Offset = Database.size ();
+  Database.resize (Offset + List.SignatureListSize);
+  CopyMem (&Database[Offset], &List, sizeof (List));
+  for (Index = Offset + sizeof (List); Index < Database.size (); Index++) {
+    Database[Index] = (UINT8)Rng ();
+  }
+}
+
+//
+// Get the signature data of an entry of the database.
+//
+static UINT8 *
+GetSignature (
+  BYTES   &Database,
+  UINTN   ListNumber,
+  UINTN   Entry
+  )
+{
+  EFI_SIGNATURE_LIST  *List;
+
+  List = (EFI_SIGNATURE_LIST *)&Database[0];
+  while (ListNumber-- > 0) {
+    List = (EFI_SIGNATURE_LIST *)((UINT8 *)List + List->SignatureListSize);
+  }
+
+  return ((EFI_SIGNATURE_DATA *)((UINT8 *)(List + 1) + List->SignatureHeaderSize + Entry * List->SignatureSize))->SignatureData;
+}
+
+//
+// The linear search of the database done before the index.
+//
+static BOOLEAN
+LinearSearch (
+  BYTES           &Database,
+  const EFI_GUID  &Type,
+  UINT8           *Hash,
+  UINTN           HashSize
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  EFI_SIGNATURE_DATA  *Cert;
+  UINTN               DataSize;
+  UINTN               Index;
+  UINTN               CertCount;
+
+  DataSize = Database.size ();
+  CertList = (EFI_SIGNATURE_LIST *)&Database[0];
+  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
+    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
+    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + HashSize) && (CompareGuid (&CertList->SignatureType, &Type))) {
+      for (Index = 0; Index < CertCount; Index++) {
+        if (CompareMem (Cert->SignatureData, Hash, HashSize) == 0) {
+          return TRUE;
+        }
+
+        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
+      }
+    }
+
+    DataSize -= CertList->SignatureListSize;
+    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+  }
+
+  return FALSE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+class SignatureIndexTest : public Test {
+protected:
+  std::mt19937 Rng;
+  BYTES Dbx;
+  SIGNATURE_DATABASE_INDEX Index;
+
+  void
+  SetUp (
+    ) override
+  {
+    UINTN  Update;
+    UINTN  Count;
+
+    Dbx.clear ();
+    Rng.seed (0x646278);
+    for (Update = 0; Update < TEST_DBX_UPDATE_COUNT; Update++) {
+      Count = TEST_DBX_HASH_COUNT / TEST_DBX_UPDATE_COUNT;
+      if (Update == TEST_DBX_UPDATE_COUNT - 1) {
+        Count = TEST_DBX_HASH_COUNT - Update * Count;
+      }
+
+      AppendSignatureList (Dbx, gEfiCertSha256Guid, sizeof (EFI_GUID) + SHA256_DIGEST_SIZE, (UINT32)Count, Rng);
+    }
+
+    AppendSignatureList (Dbx, gEfiCertX509Sha256Guid, sizeof (EFI_GUID) + SHA256_DIGEST_SIZE + sizeof (EFI_TIME), TEST_DBX_CERT_HASHES, Rng);
+    AppendSignatureList (Dbx, gEfiCertX509Guid, sizeof (EFI_GUID) + 800, TEST_DBX_CERTS, Rng);
+
+    ZeroMem (&Index, sizeof (Index));
+  }
+
+  void
+  TearDown (
+    ) override
+  {
+    SignatureIndexReset (&Index, EFI_NOT_FOUND);
+  }
+
+  EFI_STATUS
+  Build (
+    )
+  {
+    UINT8  *Data;
+
+    Data = (UINT8 *)AllocateCopyPool (Dbx.size (), &Dbx[0]);
+    return SignatureIndexBuild (&Index, Data, Dbx.size ());
+  }
+};
+
+TEST_F (SignatureIndexTest, IndexesEveryEntry) {
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  EXPECT_EQ (Index.Status, EFI_SUCCESS);
+  EXPECT_EQ (Index.HashCount, (UINTN)(TEST_DBX_HASH_COUNT + TEST_DBX_CERT_HASHES));
+  ASSERT_EQ (Index.CertCount, (UINTN)TEST_DBX_CERTS);
+  EXPECT_EQ (Index.Certs[0].CertSize, 800u);
+  EXPECT_EQ (Index.Certs[1].Cert, GetSignature (Dbx, TEST_DBX_UPDATE_COUNT + 1, 1) - &Dbx[0] + Index.Data);
+}
+
+TEST_F (SignatureIndexTest, FindsEveryHash) {
+  UINTN                        Update;
+  UINTN                        Entry;
+  UINT8                        *Hash;
+  CONST SIGNATURE_INDEX_ENTRY  *Found;
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  for (Update = 0; Update < TEST_DBX_UPDATE_COUNT; Update++) {
+    for (Entry = 0; Entry < TEST_DBX_HASH_COUNT / TEST_DBX_UPDATE_COUNT; Entry++) {
+      Hash  = GetSignature (Dbx, Update, Entry);
+      Found = SignatureIndexFindHash (&Index, &gEfiCertSha256Guid, Hash, SHA256_DIGEST_SIZE);
+      ASSERT_NE (Found, nullptr);
+      EXPECT_EQ (CompareMem (Found->Data->SignatureData, Hash, SHA256_DIGEST_SIZE), 0);
+      EXPECT_EQ (Found->List->SignatureSize, sizeof (EFI_GUID) + SHA256_DIGEST_SIZE);
+    }
+  }
+}
+
+TEST_F (SignatureIndexTest, DoesNotFindOtherHashes) {
+  UINT8  Hash[SHA512_DIGEST_SIZE];
+  UINTN  Iteration;
+  UINTN  Byte;
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  for (Iteration = 0; Iteration < 1000; Iteration++) {
+    for (Byte = 0; Byte < sizeof (Hash); Byte++) {
+      Hash[Byte] = (UINT8)Rng ();
+    }
+
+    EXPECT_EQ (SignatureIndexFindHash (&Index, &gEfiCertSha256Guid, Hash, SHA256_DIGEST_SIZE), nullptr);
+  }
+
+  //
+  // A hash of the database is not found with another type or size.
+  //
+  CopyMem (Hash, GetSignature (Dbx, 0, 0), SHA256_DIGEST_SIZE);
+  EXPECT_EQ (SignatureIndexFindHash (&Index, &gEfiCertSha384Guid, Hash, SHA256_DIGEST_SIZE), nullptr);
+  EXPECT_EQ (SignatureIndexFindHash (&Index, &gEfiCertSha256Guid, Hash, SHA384_DIGEST_SIZE), nullptr);
+  EXPECT_EQ (SignatureIndexFindHash (&Index, &gEfiCertX509Guid, Hash, SHA256_DIGEST_SIZE), nullptr);
+}
+
+TEST_F (SignatureIndexTest, FindsCertHashWithRevocationTime) {
+  UINT8                        *Hash;
+  CONST SIGNATURE_INDEX_ENTRY  *Found;
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  EXPECT_TRUE (SignatureIndexHasType (&Index, &gEfiCertX509Sha256Guid));
+  EXPECT_FALSE (SignatureIndexHasType (&Index, &gEfiCertX509Sha384Guid));
+  EXPECT_FALSE (SignatureIndexHasType (&Index, &gEfiCertX509Guid));
+
+  //
+  // Only the hash is the key, the revocation time follows it.
+  //
+  Hash  = GetSignature (Dbx, TEST_DBX_UPDATE_COUNT, 3);
+  Found = SignatureIndexFindHash (&Index, &gEfiCertX509Sha256Guid, Hash, SHA256_DIGEST_SIZE);
+  ASSERT_NE (Found, nullptr);
+  EXPECT_EQ (CompareMem (Found->Data->SignatureData + SHA256_DIGEST_SIZE, Hash + SHA256_DIGEST_SIZE, sizeof (EFI_TIME)), 0);
+}
+
+TEST_F (SignatureIndexTest, FindsFirstDuplicate) {
+  CONST SIGNATURE_INDEX_ENTRY  *Found;
+  UINT8                        *Hash;
+
+  //
+  // Revoke the same certificate hash twice with different times.
+  //
+  CopyMem (GetSignature (Dbx, TEST_DBX_UPDATE_COUNT, 6), GetSignature (Dbx, TEST_DBX_UPDATE_COUNT, 2), SHA256_DIGEST_SIZE);
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+
+  Hash  = GetSignature (Dbx, TEST_DBX_UPDATE_COUNT, 2);
+  Found = SignatureIndexFindHash (&Index, &gEfiCertX509Sha256Guid, Hash, SHA256_DIGEST_SIZE);
+  ASSERT_NE (Found, nullptr);
+  EXPECT_EQ ((UINT8 *)Found->Data->SignatureData - Index.Data, Hash - &Dbx[0]);
+}
+
+TEST_F (SignatureIndexTest, SkipsEntriesOfWrongSize) {
+  BYTES  Db;
+  UINT8  *Data;
+
+  AppendSignatureList (Db, gEfiCertSha256Guid, sizeof (EFI_GUID) + SHA384_DIGEST_SIZE, 4, Rng);
+  Data = (UINT8 *)AllocateCopyPool (Db.size (), &Db[0]);
+  ASSERT_EQ (SignatureIndexBuild (&Index, Data, Db.size ()), EFI_SUCCESS);
+  EXPECT_EQ (Index.HashCount, 0u);
+  EXPECT_EQ (SignatureIndexFindHash (&Index, &gEfiCertSha256Guid, GetSignature (Db, 0, 0), SHA256_DIGEST_SIZE), nullptr);
+}
+
+TEST_F (SignatureIndexTest, RejectsMalformedLists) {
+  EFI_SIGNATURE_LIST  *List;
+
+  //
+  // A list which runs past the end of the database.
+  //
+  Dbx.resize (Dbx.size () - 1);
+  EXPECT_EQ (Build (), EFI_VOLUME_CORRUPTED);
+  EXPECT_EQ (Index.Status, EFI_VOLUME_CORRUPTED);
+  EXPECT_EQ (Index.HashCount, 0u);
+
+  //
+  // A list of zero size, which would never end the walk.
+  //
+  SetUp ();
+  List                    = (EFI_SIGNATURE_LIST *)&Dbx[0];
+  List->SignatureListSize = 0;
+  EXPECT_EQ (Build (), EFI_VOLUME_CORRUPTED);
+
+  //
+  // Entries smaller than their owner GUID.
+  //
+  SetUp ();
+  List                = (EFI_SIGNATURE_LIST *)&Dbx[0];
+  List->SignatureSize = 0;
+  EXPECT_EQ (Build (), EFI_VOLUME_CORRUPTED);
+
+  //
+  // A header larger than the list.
+  //
+  SetUp ();
+  List                      = (EFI_SIGNATURE_LIST *)&Dbx[0];
+  List->SignatureHeaderSize = List->SignatureListSize;
+  EXPECT_EQ (Build (), EFI_VOLUME_CORRUPTED);
+}
+
+TEST_F (SignatureIndexTest, DetectsChanges) {
+  UINTN  Generation;
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  Generation = Index.Generation;
+  EXPECT_TRUE (SignatureIndexIsCurrent (&Index, &Dbx[0], Dbx.size ()));
+
+  Dbx[Dbx.size () / 2] ^= 1;
+  EXPECT_FALSE (SignatureIndexIsCurrent (&Index, &Dbx[0], Dbx.size ()));
+  EXPECT_FALSE (SignatureIndexIsCurrent (&Index, &Dbx[0], Dbx.size () - 1));
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  EXPECT_NE (Index.Generation, Generation);
+  EXPECT_TRUE (SignatureIndexIsCurrent (&Index, &Dbx[0], Dbx.size ()));
+
+  SignatureIndexReset (&Index, EFI_NOT_FOUND);
+  EXPECT_FALSE (SignatureIndexIsCurrent (&Index, &Dbx[0], Dbx.size ()));
+}
+
+TEST_F (SignatureIndexTest, DISABLED_Benchmark) {
+  std::vector<UINT8 *>  Hashes;
+  UINT8                 Absent[SHA256_DIGEST_SIZE];
+  UINTN                 Iteration;
+  UINTN                 Found;
+
+  //
+  // Look up hashes of the database, and absent hashes as for most images.
+  //
+  for (Iteration = 0; Iteration < TEST_DBX_HASH_COUNT / TEST_DBX_UPDATE_COUNT; Iteration++) {
+    Hashes.push_back (GetSignature (Dbx, Iteration % TEST_DBX_UPDATE_COUNT, Iteration));
+    Hashes.push_back (Absent);
+  }
+
+  for (Iteration = 0; Iteration < sizeof (Absent); Iteration++) {
+    Absent[Iteration] = (UINT8)Rng ();
+  }
+
+  auto  Start = std::chrono::steady_clock::now ();
+
+  Found = 0;
+  for (Iteration = 0; Iteration < TEST_BENCH_LOOKUPS; Iteration++) {
+    Found += LinearSearch (Dbx, gEfiCertSha256Guid, Hashes[Iteration % Hashes.size ()], SHA256_DIGEST_SIZE);
+  }
+
+  auto  Linear = std::chrono::steady_clock::now ();
+
+  ASSERT_EQ (Build (), EFI_SUCCESS);
+  auto  Built = std::chrono::steady_clock::now ();
+
+  for (Iteration = 0; Iteration < TEST_BENCH_LOOKUPS; Iteration++) {
+    Found -= (SignatureIndexFindHash (&Index, &gEfiCertSha256Guid, Hashes[Iteration % Hashes.size ()], SHA256_DIGEST_SIZE) != NULL);
+  }
+
+  auto  End = std::chrono::steady_clock::now ();
+
+  EXPECT_EQ (Found, 0u);
+  std::cout << "[ BENCH    ] " << TEST_BENCH_LOOKUPS << " lookups in a dbx of " << Dbx.size () << " bytes: linear "
+            << std::chrono::duration_cast<std::chrono::microseconds>(Linear - Start).count ()
+            << " us, index build "
+            << std::chrono::duration_cast<std::chrono::microseconds>(Built - Linear).count ()
+            << " us, indexed "
+            << std::chrono::duration_cast<std::chrono::microseconds>(End - Built).count ()
+            << " us" << std::endl;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
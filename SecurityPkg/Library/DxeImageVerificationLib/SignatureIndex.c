@@ -0,0 +1,459 @@
+/** @file
+  Index of the signature databases for image verification.
+
+  Caution: This file requires additional review when modified.
+  The signature databases are read from variables. Their signature lists must
+  be validated before use.
+
+  SignatureIndexBuild() walks the signature lists once, and sorts their hash
+  entries so that SignatureIndexFindHash() is a binary search instead of a
+  scan of the whole database.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseCryptLib.h>
+
+#include "SignatureIndex.h"
+
+typedef struct {
+  EFI_GUID    *Guid;
+  UINT32      HashSize;
+  //
+  // The signature data of a certificate hash is followed by the revocation
+  // time, so only the hash part is the key.
+  //
+  BOOLEAN     IsCertHash;
+} SIGNATURE_INDEX_TYPE;
+
+STATIC CONST SIGNATURE_INDEX_TYPE  mSignatureIndexTypes[] = {
+  { &gEfiCertSha1Guid,       SHA1_DIGEST_SIZE,   FALSE },
+  { &gEfiCertSha256Guid,     SHA256_DIGEST_SIZE, FALSE },
+  { &gEfiCertSha384Guid,     SHA384_DIGEST_SIZE, FALSE },
+  { &gEfiCertSha512Guid,     SHA512_DIGEST_SIZE, FALSE },
+  { &gEfiCertX509Sha256Guid, SHA256_DIGEST_SIZE, TRUE  },
+  { &gEfiCertX509Sha384Guid, SHA384_DIGEST_SIZE, TRUE  },
+  { &gEfiCertX509Sha512Guid, SHA512_DIGEST_SIZE, TRUE  }
+};
+
+/**
+  Get the index of a signature type in mSignatureIndexTypes.
+
+  @param[in]  SignatureType       Pointer to the signature type GUID.
+
+  @return  The index of the type, or ARRAY_SIZE (mSignatureIndexTypes) if the
+           type is not indexed.
+
+**/
+STATIC
+UINT32
+SignatureIndexGetType (
+  IN CONST EFI_GUID  *SignatureType
+  )
+{
+  UINT32  Type;
+
+  for (Type = 0; Type < ARRAY_SIZE (mSignatureIndexTypes); Type++) {
+    if (CompareGuid (SignatureType, mSignatureIndexTypes[Type].Guid)) {
+      break;
+    }
+  }
+
+  return Type;
+}
+
+/**
+  Compare a hash entry with a search key.
+
+  @param[in]  Entry               Pointer to the hash entry.
+  @param[in]  Type                Signature type of the key.
+  @param[in]  Key                 Pointer to the key.
+  @param[in]  KeySize             Size of the key in bytes, 0 to compare the type only.
+
+  @retval 0                       The entry matches the key.
+  @return <0                      The entry is sorted before the key.
+  @return >0                      The entry is sorted after the key.
+
+**/
+STATIC
+INTN
+SignatureIndexCompareKey (
+  IN CONST SIGNATURE_INDEX_ENTRY  *Entry,
+  IN       UINT32                 Type,
+  IN CONST UINT8                  *Key,
+  IN       UINTN                  KeySize
+  )
+{
+  if (Entry->Type != Type) {
+    return (Entry->Type < Type) ? -1 : 1;
+  }
+
+  return CompareMem (Entry->Data->SignatureData, Key, KeySize);
+}
+
+/**
+  Compare two hash entries for QuickSort().
+
+  @param[in]  Buffer1             Pointer to the first SIGNATURE_INDEX_ENTRY.
+  @param[in]  Buffer2             Pointer to the second SIGNATURE_INDEX_ENTRY.
+
+  @retval 0                       Buffer1 equal to Buffer2.
+  @return <0                      Buffer1 is less than Buffer2.
+  @return >0                      Buffer1 is greater than Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+SignatureIndexCompareEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST SIGNATURE_INDEX_ENTRY  *Entry1;
+  CONST SIGNATURE_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST SIGNATURE_INDEX_ENTRY *)Buffer2;
+
+  Result = SignatureIndexCompareKey (Entry1, Entry2->Type, Entry2->Data->SignatureData, Entry2->KeySize);
+  if (Result != 0) {
+    return Result;
+  }
+
+  //
+  // Keep the duplicates in database order, so that a search finds the first.
+  //
+  if (Entry1->Data == Entry2->Data) {
+    return 0;
+  }
+
+  return ((UINTN)Entry1->Data < (UINTN)Entry2->Data) ? -1 : 1;
+}
+
+/**
+  Find the first hash entry which is not sorted before a search key.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  Type                Signature type of the key.
+  @param[in]  Key                 Pointer to the key.
+  @param[in]  KeySize             Size of the key in bytes, 0 to search the type only.
+
+  @return  The matching entry, or NULL if there is none.
+
+**/
+STATIC
+CONST SIGNATURE_INDEX_ENTRY *
+SignatureIndexSearch (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN       UINT32                    Type,
+  IN CONST UINT8                     *Key,
+  IN       UINTN                     KeySize
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  Low  = 0;
+  High = Index->HashCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (SignatureIndexCompareKey (&Index->Hashes[Middle], Type, Key, KeySize) < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->HashCount) && (SignatureIndexCompareKey (&Index->Hashes[Low], Type, Key, KeySize) == 0)) {
+    return &Index->Hashes[Low];
+  }
+
+  return NULL;
+}
+
+/**
+  Walk the signature lists of the database, to count or to record its entries.
+
+  @param[in, out]  Index          Pointer to the index. Data and DataSize are input.
+  @param[in]       Record         FALSE to count the entries, TRUE to record them in
+                                  the Hashes and Certs arrays allocated from the counts.
+
+  @retval EFI_SUCCESS             The signature lists are walked.
+  @retval EFI_VOLUME_CORRUPTED    The signature lists are malformed.
+
+**/
+STATIC
+EFI_STATUS
+SignatureIndexWalk (
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index,
+  IN     BOOLEAN                   Record
+  )
+{
+  EFI_SIGNATURE_LIST  *List;
+  EFI_SIGNATURE_DATA  *Data;
+  UINTN               Remaining;
+  UINTN               Count;
+  UINTN               Entry;
+  UINT32              Type;
+  UINT32              MinSize;
+  UINTN               HashCount;
+  UINTN               CertCount;
+
+  HashCount = 0;
+  CertCount = 0;
+  List      = (EFI_SIGNATURE_LIST *)Index->Data;
+  Remaining = Index->DataSize;
+
+  while (Remaining > 0) {
+    if ((Remaining < sizeof (EFI_SIGNATURE_LIST)) ||
+        (List->SignatureListSize > Remaining) ||
+        (List->SignatureListSize < sizeof (EFI_SIGNATURE_LIST)) ||
+        (List->SignatureHeaderSize > List->SignatureListSize - sizeof (EFI_SIGNATURE_LIST)) ||
+        (List->SignatureSize < sizeof (EFI_GUID)))
+    {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Count = (List->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - List->SignatureHeaderSize) / List->SignatureSize;
+    Data  = (EFI_SIGNATURE_DATA *)((UINT8 *)List + sizeof (EFI_SIGNATURE_LIST) + List->SignatureHeaderSize);
+
+    if (CompareGuid (&List->SignatureType, &gEfiCertX509Guid)) {
+      if (List->SignatureSize > sizeof (EFI_GUID)) {
+        for (Entry = 0; Entry < Count; Entry++) {
+          if (Record) {
+            Index->Certs[CertCount].List     = List;
+            Index->Certs[CertCount].Data     = Data;
+            Index->Certs[CertCount].Cert     = Data->SignatureData;
+            Index->Certs[CertCount].CertSize = List->SignatureSize - sizeof (EFI_GUID);
+          }
+
+          CertCount++;
+          Data = (EFI_SIGNATURE_DATA *)((UINT8 *)Data + List->SignatureSize);
+        }
+      }
+    } else {
+      //
+      // A hash entry is indexed only if it is large enough for the hash, as
+      // the linear search of the database required.
+      //
+      Type = SignatureIndexGetType (&List->SignatureType);
+      if (Type < ARRAY_SIZE (mSignatureIndexTypes)) {
+        MinSize = sizeof (EFI_GUID) + mSignatureIndexTypes[Type].HashSize;
+        if ((List->SignatureSize == MinSize) ||
+            (mSignatureIndexTypes[Type].IsCertHash && (List->SignatureSize > MinSize)))
+        {
+          for (Entry = 0; Entry < Count; Entry++) {
+            if (Record) {
+              Index->Hashes[HashCount].List    = List;
+              Index->Hashes[HashCount].Data    = Data;
+              Index->Hashes[HashCount].Type    = Type;
+              Index->Hashes[HashCount].KeySize = mSignatureIndexTypes[Type].HashSize;
+            }
+
+            HashCount++;
+            Data = (EFI_SIGNATURE_DATA *)((UINT8 *)Data + List->SignatureSize);
+          }
+        }
+      }
+    }
+
+    Remaining -= List->SignatureListSize;
+    List       = (EFI_SIGNATURE_LIST *)((UINT8 *)List + List->SignatureListSize);
+  }
+
+  Index->HashCount = HashCount;
+  Index->CertCount = CertCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  Release the content of the index, and record why it is empty.
+
+  @param[in, out]  Index          Pointer to the index.
+  @param[in]       Status         EFI_NOT_FOUND if the database doesn't exist,
+                                  or the error in reading it.
+
+**/
+VOID
+SignatureIndexReset (
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index,
+  IN     EFI_STATUS                Status
+  )
+{
+  if (Index->Data != NULL) {
+    FreePool (Index->Data);
+  }
+
+  if (Index->Hashes != NULL) {
+    FreePool (Index->Hashes);
+  }
+
+  if (Index->Certs != NULL) {
+    FreePool (Index->Certs);
+  }
+
+  Index->Data      = NULL;
+  Index->DataSize  = 0;
+  Index->Hashes    = NULL;
+  Index->HashCount = 0;
+  Index->Certs     = NULL;
+  Index->CertCount = 0;
+  Index->Status    = Status;
+  Index->Generation++;
+}
+
+/**
+  Build the index of a signature database.
+
+  The index takes the ownership of Data, which is freed when the index is
+  rebuilt or released. The previous content of the index is released.
+
+  @param[in, out]  Index          Pointer to the index.
+  @param[in]       Data           Pointer to the signature database, allocated from pool.
+  @param[in]       DataSize       Size of the signature database in bytes.
+
+  @retval EFI_SUCCESS             The index is built.
+  @retval EFI_VOLUME_CORRUPTED    The signature lists are malformed.
+  @retval EFI_OUT_OF_RESOURCES    Failed to allocate memory for the index.
+
+**/
+EFI_STATUS
+SignatureIndexBuild (
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index,
+  IN     UINT8                     *Data,
+  IN     UINTN                     DataSize
+  )
+{
+  EFI_STATUS             Status;
+  SIGNATURE_INDEX_ENTRY  Swap;
+
+  SignatureIndexReset (Index, EFI_NOT_FOUND);
+  Index->Data     = Data;
+  Index->DataSize = DataSize;
+
+  Status = SignatureIndexWalk (Index, FALSE);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (Index->HashCount > 0) {
+    Index->Hashes = AllocatePool (Index->HashCount * sizeof (SIGNATURE_INDEX_ENTRY));
+    if (Index->Hashes == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ON_EXIT;
+    }
+  }
+
+  if (Index->CertCount > 0) {
+    Index->Certs = AllocateZeroPool (Index->CertCount * sizeof (SIGNATURE_INDEX_CERT));
+    if (Index->Certs == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ON_EXIT;
+    }
+  }
+
+  Status = SignatureIndexWalk (Index, TRUE);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (Index->HashCount > 1) {
+    QuickSort (Index->Hashes, Index->HashCount, sizeof (SIGNATURE_INDEX_ENTRY), SignatureIndexCompareEntry, &Swap);
+  }
+
+  Index->Status = EFI_SUCCESS;
+
+ON_EXIT:
+  if (EFI_ERROR (Status)) {
+    SignatureIndexReset (Index, Status);
+  }
+
+  return Status;
+}
+
+/**
+  Check whether the index has the same content as a signature database.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  Data                Pointer to the signature database.
+  @param[in]  DataSize            Size of the signature database in bytes.
+
+  @retval TRUE                    The index is built from the same content.
+  @retval FALSE                   The index needs to be rebuilt.
+
+**/
+BOOLEAN
+SignatureIndexIsCurrent (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST UINT8                     *Data,
+  IN       UINTN                     DataSize
+  )
+{
+  return (BOOLEAN)((Index->Status == EFI_SUCCESS) &&
+                   (Index->DataSize == DataSize) &&
+                   (CompareMem (Index->Data, Data, DataSize) == 0));
+}
+
+/**
+  Check whether the index has any hash entry of the given signature type.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  SignatureType       Pointer to the signature type GUID.
+
+  @retval TRUE                    There is at least one entry of the type.
+  @retval FALSE                   There isn't any entry of the type.
+
+**/
+BOOLEAN
+SignatureIndexHasType (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST EFI_GUID                  *SignatureType
+  )
+{
+  UINT32  Type;
+
+  Type = SignatureIndexGetType (SignatureType);
+  if (Type >= ARRAY_SIZE (mSignatureIndexTypes)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(SignatureIndexSearch (Index, Type, NULL, 0) != NULL);
+}
+
+/**
+  Search the index for a hash.
+
+  Only the hash types of image digests (SHA1, SHA256, SHA384 and SHA512) and
+  of X.509 certificates (X509_SHA256, X509_SHA384 and X509_SHA512) are
+  indexed. If the hash is in the database several times, the entry which is
+  first in the database is returned.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  SignatureType       Pointer to the signature type GUID.
+  @param[in]  Hash                Pointer to the hash.
+  @param[in]  HashSize            Size of the hash in bytes.
+
+  @return  The entry of the hash, or NULL if it is not found.
+
+**/
+CONST SIGNATURE_INDEX_ENTRY *
+SignatureIndexFindHash (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST EFI_GUID                  *SignatureType,
+  IN CONST UINT8                     *Hash,
+  IN       UINTN                     HashSize
+  )
+{
+  UINT32  Type;
+
+  Type = SignatureIndexGetType (SignatureType);
+  if ((Type >= ARRAY_SIZE (mSignatureIndexTypes)) || (HashSize != mSignatureIndexTypes[Type].HashSize)) {
+    return NULL;
+  }
+
+  return SignatureIndexSearch (Index, Type, Hash, HashSize);
+}
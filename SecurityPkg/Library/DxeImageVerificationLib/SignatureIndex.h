@@ -0,0 +1,166 @@
+/** @file
+  The internal header file of the signature database index used by
+  ImageVerificationLib.
+
+  The index keeps a copy of a signature database variable (db or dbx), the
+  hash entries of the database sorted for binary search, and the X.509
+  certificate entries in database order. It is rebuilt only when the content
+  of the variable changes.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __SIGNATURE_INDEX_H__
+#define __SIGNATURE_INDEX_H__
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Guid/ImageAuthentication.h>
+
+//
+// A hash entry of the database. The entries are sorted by Type, then by the
+// first KeySize bytes of the signature data, then by their position in the
+// database.
+//
+typedef struct {
+  EFI_SIGNATURE_LIST    *List;
+  EFI_SIGNATURE_DATA    *Data;
+  UINT32                Type;
+  UINT32                KeySize;
+} SIGNATURE_INDEX_ENTRY;
+
+//
+// An X.509 certificate entry of the database.
+//
+typedef struct {
+  EFI_SIGNATURE_LIST    *List;
+  EFI_SIGNATURE_DATA    *Data;
+  UINT8                 *Cert;
+  UINTN                 CertSize;
+  //
+  // Result of the search of the certificate hash in dbx. It is only valid
+  // while DbxGeneration matches the generation of the dbx index.
+  //
+  UINTN                 DbxGeneration;
+  EFI_STATUS            DbxStatus;
+  BOOLEAN               DbxFound;
+  EFI_TIME              RevocationTime;
+} SIGNATURE_INDEX_CERT;
+
+typedef struct {
+  //
+  // EFI_SUCCESS if the database is indexed, EFI_NOT_FOUND if the variable
+  // doesn't exist, or the error in reading the variable.
+  //
+  EFI_STATUS               Status;
+  //
+  // Incremented on each change of the index.
+  //
+  UINTN                    Generation;
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  SIGNATURE_INDEX_ENTRY    *Hashes;
+  UINTN                    HashCount;
+  SIGNATURE_INDEX_CERT     *Certs;
+  UINTN                    CertCount;
+} SIGNATURE_DATABASE_INDEX;
+
+/**
+  Build the index of a signature database.
+
+  The index takes the ownership of Data, which is freed when the index is
+  rebuilt or released. The previous content of the index is released.
+
+  @param[in, out]  Index          Pointer to the index.
+  @param[in]       Data           Pointer to the signature database, allocated from pool.
+  @param[in]       DataSize       Size of the signature database in bytes.
+
+  @retval EFI_SUCCESS             The index is built.
+  @retval EFI_VOLUME_CORRUPTED    The signature lists are malformed.
+  @retval EFI_OUT_OF_RESOURCES    Failed to allocate memory for the index.
+
+**/
+EFI_STATUS
+SignatureIndexBuild (
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index,
+  IN     UINT8                     *Data,
+  IN     UINTN                     DataSize
+  );
+
+/**
+  Release the content of the index, and record why it is empty.
+
+  @param[in, out]  Index          Pointer to the index.
+  @param[in]       Status         EFI_NOT_FOUND if the database doesn't exist,
+                                  or the error in reading it.
+
+**/
+VOID
+SignatureIndexReset (
+  IN OUT SIGNATURE_DATABASE_INDEX  *Index,
+  IN     EFI_STATUS                Status
+  );
+
+/**
+  Check whether the index has the same content as a signature database.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  Data                Pointer to the signature database.
+  @param[in]  DataSize            Size of the signature database in bytes.
+
+  @retval TRUE                    The index is built from the same content.
+  @retval FALSE                   The index needs to be rebuilt.
+
+**/
+BOOLEAN
+SignatureIndexIsCurrent (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST UINT8                     *Data,
+  IN       UINTN                     DataSize
+  );
+
+/**
+  Check whether the index has any hash entry of the given signature type.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  SignatureType       Pointer to the signature type GUID.
+
+  @retval TRUE                    There is at least one entry of the type.
+  @retval FALSE                   There isn't any entry of the type.
+
+**/
+BOOLEAN
+SignatureIndexHasType (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST EFI_GUID                  *SignatureType
+  );
+
+/**
+  Search the index for a hash.
+
+  Only the hash types of image digests (SHA1, SHA256, SHA384 and SHA512) and
+  of X.509 certificates (X509_SHA256, X509_SHA384 and X509_SHA512) are
+  indexed. If the hash is in the database several times, the entry which is
+  first in the database is returned.
+
+  @param[in]  Index               Pointer to the index.
+  @param[in]  SignatureType       Pointer to the signature type GUID.
+  @param[in]  Hash                Pointer to the hash.
+  @param[in]  HashSize            Size of the hash in bytes.
+
+  @return  The entry of the hash, or NULL if it is not found.
+
+**/
+CONST SIGNATURE_INDEX_ENTRY *
+SignatureIndexFindHash (
+  IN CONST SIGNATURE_DATABASE_INDEX  *Index,
+  IN CONST EFI_GUID                  *SignatureType,
+  IN CONST UINT8                     *Hash,
+  IN       UINTN                     HashSize
+  );
+
+#endif
@@ -66,6 +66,7 @@ FmpAuthenticatedHandlerPkcs7 (
   BOOLEAN        CryptoStatus;
   VOID           *P7Data;
   UINTN          P7Length;
+  VOID           *Pkcs7VerifyStream;
   VOID           *TempBuffer;
 
   DEBUG ((DEBUG_INFO, "FmpAuthenticatedHandlerPkcs7 - Image: 0x%08x - 0x%08x\n", (UINTN)Image, (UINTN)ImageSize));
@@ -73,33 +74,65 @@ FmpAuthenticatedHandlerPkcs7 (
   P7Length = Image->AuthInfo.Hdr.dwLength - (OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData));
   P7Data   = Image->AuthInfo.CertData;
 
+  //
   // It is a signature across the variable data and the Monotonic Count value.
-  TempBuffer = AllocatePool (ImageSize - Image->AuthInfo.Hdr.dwLength);
-  if (TempBuffer == NULL) {
-    DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerPkcs7: TempBuffer == NULL\n"));
-    Status = RETURN_OUT_OF_RESOURCES;
-    goto Done;
+  //
+  Pkcs7VerifyStream = Pkcs7VerifyStreamNew (P7Data, P7Length, PublicKeyData, PublicKeyDataLength);
+  if (Pkcs7VerifyStream != NULL) {
+    //
+    // Both are provided in place, so the payload is not copied.
+    //
+    CryptoStatus = Pkcs7VerifyStreamUpdate (
+                     Pkcs7VerifyStream,
+                     (UINT8 *)Image + sizeof (Image->MonotonicCount) + Image->AuthInfo.Hdr.dwLength,
+                     ImageSize - sizeof (Image->MonotonicCount) - Image->AuthInfo.Hdr.dwLength
+                     );
+    if (CryptoStatus) {
+      CryptoStatus = Pkcs7VerifyStreamUpdate (
+                       Pkcs7VerifyStream,
+                       (UINT8 *)&Image->MonotonicCount,
+                       sizeof (Image->MonotonicCount)
+                       );
+    }
+
+    if (CryptoStatus) {
+      CryptoStatus = Pkcs7VerifyStreamFinal (Pkcs7VerifyStream);
+    }
+
+    Pkcs7VerifyStreamFree (Pkcs7VerifyStream);
+  } else {
+    //
+    // The streaming interface is not available, e.g. when the Crypto protocol
+    // service is not enabled by the platform. Verify a contiguous copy.
+    //
+    TempBuffer = AllocatePool (ImageSize - Image->AuthInfo.Hdr.dwLength);
+    if (TempBuffer == NULL) {
+      DEBUG ((DEBUG_ERROR, "FmpAuthenticatedHandlerPkcs7: TempBuffer == NULL\n"));
+      Status = RETURN_OUT_OF_RESOURCES;
+      goto Done;
+    }
+
+    CopyMem (
+      TempBuffer,
+      (UINT8 *)Image + sizeof (Image->MonotonicCount) + Image->AuthInfo.Hdr.dwLength,
+      ImageSize - sizeof (Image->MonotonicCount) - Image->AuthInfo.Hdr.dwLength
+      );
+    CopyMem (
+      (UINT8 *)TempBuffer + ImageSize - sizeof (Image->MonotonicCount) - Image->AuthInfo.Hdr.dwLength,
+      &Image->MonotonicCount,
+      sizeof (Image->MonotonicCount)
+      );
+    CryptoStatus = Pkcs7Verify (
+                     P7Data,
+                     P7Length,
+                     PublicKeyData,
+                     PublicKeyDataLength,
+                     (UINT8 *)TempBuffer,
+                     ImageSize - Image->AuthInfo.Hdr.dwLength
+                     );
+    FreePool (TempBuffer);
   }
 
-  CopyMem (
-    TempBuffer,
-    (UINT8 *)Image + sizeof (Image->MonotonicCount) + Image->AuthInfo.Hdr.dwLength,
-    ImageSize - sizeof (Image->MonotonicCount) - Image->AuthInfo.Hdr.dwLength
-    );
-  CopyMem (
-    (UINT8 *)TempBuffer + ImageSize - sizeof (Image->MonotonicCount) - Image->AuthInfo.Hdr.dwLength,
-    &Image->MonotonicCount,
-    sizeof (Image->MonotonicCount)
-    );
-  CryptoStatus = Pkcs7Verify (
-                   P7Data,
-                   P7Length,
-                   PublicKeyData,
-                   PublicKeyDataLength,
-                   (UINT8 *)TempBuffer,
-                   ImageSize - Image->AuthInfo.Hdr.dwLength
-                   );
-  FreePool (TempBuffer);
   if (!CryptoStatus) {
     //
     // If PKCS7 signature verification fails, AUTH tested failed bit is set.
@@ -15,6 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID    Guid;
   UINT32      Mask;
@@ -72,3 +74,59 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count++;
 }
+
+/**
+  The function updates the hash sequence of each hash interface enabled in HashMask.
+
+  The data is fed in chunks of HASH_UPDATE_CHUNK_SIZE bytes, and each chunk is
+  hashed by all the enabled interfaces before the next one, so that the data is
+  read from memory only once whatever the number of active PCR banks.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each hash interface.
+  @param HashMask           Mask of the enabled hash algorithms.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  UINT8   *Chunk;
+  UINTN   ChunkSize;
+  UINTN   Index;
+  UINT32  EnabledIndexes;
+
+  ASSERT (HashInterfaceCount <= 32);
+
+  //
+  // Look up the algorithm of each interface once, not for every chunk.
+  //
+  EnabledIndexes = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & HashMask) != 0) {
+      EnabledIndexes |= (UINT32)1 << Index;
+    }
+  }
+
+  Chunk = DataToHash;
+  while (DataToHashLen > 0) {
+    ChunkSize = MIN (DataToHashLen, HASH_UPDATE_CHUNK_SIZE);
+    for (Index = 0; Index < HashInterfaceCount; Index++) {
+      if ((EnabledIndexes & ((UINT32)1 << Index)) != 0) {
+        HashInterface[Index].HashUpdate (HashCtx[Index], Chunk, ChunkSize);
+      }
+    }
+
+    Chunk         += ChunkSize;
+    DataToHashLen -= ChunkSize;
+  }
+}
@@ -9,6 +9,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// Size of the chunks in which data is fed to the hash interfaces, small enough
+// for a chunk to stay in the CPU cache while every PCR bank hashes it.
+//
+#define HASH_UPDATE_CHUNK_SIZE  SIZE_32KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +41,29 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES      *Digest
   );
 
+/**
+  The function updates the hash sequence of each hash interface enabled in HashMask.
+
+  The data is fed in chunks of HASH_UPDATE_CHUNK_SIZE bytes, and each chunk is
+  hashed by all the enabled interfaces before the next one, so that the data is
+  read from memory only once whatever the number of active PCR banks.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash context of each hash interface.
+  @param HashMask           Mask of the enabled hash algorithms.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+Tpm2HashUpdateInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
@@ -45,6 +45,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PerformanceLib.h>
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/Tcg2PhysicalPresenceLib.h>
+#include <Library/TimerLib.h>
+#include <Library/ElapsedTicksLib.h>
 
 #define PERF_ID_TCG2_DXE  0x3120
 
@@ -116,6 +118,84 @@ VARIABLE_TYPE  mVariableType[] = {
 
 EFI_HANDLE  mImageHandle;
 
+//
+// Time spent in each phase of the measurements, reported at ReadyToBoot and
+// ExitBootServices. HashExtend includes the hash of the data and the PCR
+// extend command, LogEvent the construction of the event log entries, and
+// SubmitCommand the commands sent through EFI_TCG2_PROTOCOL.
+//
+// The event log entries are built when the event is measured, they are not
+// deferred. The event data of the caller would have to be copied anyway, and
+// the log must be complete whenever GetEventLog() is called or the final
+// events table is read. The LogEvent counter measures that cost against
+// HashExtend.
+//
+typedef enum {
+  Tcg2LatencyHashExtend,
+  Tcg2LatencyLogEvent,
+  Tcg2LatencySubmitCommand,
+  Tcg2LatencyMax
+} TCG2_LATENCY_PHASE;
+
+typedef struct {
+  UINT64    Count;
+  UINT64    Ticks;
+} TCG2_LATENCY_COUNTER;
+
+TCG2_LATENCY_COUNTER  mTcg2Latency[Tcg2LatencyMax];
+CHAR8                 *mTcg2LatencyName[Tcg2LatencyMax] = {
+  "HashExtend",
+  "LogEvent",
+  "SubmitCommand",
+};
+
+/**
+  Add the time elapsed since Start to the latency counter of a phase.
+
+  The performance counter may wrap around once during the phase.
+
+  @param[in]  Phase  The phase of the measurement.
+  @param[in]  Start  The performance counter value at the start of the phase.
+
+**/
+VOID
+Tcg2LatencyRecord (
+  IN TCG2_LATENCY_PHASE  Phase,
+  IN UINT64              Start
+  )
+{
+  mTcg2Latency[Phase].Count++;
+  mTcg2Latency[Phase].Ticks += GetElapsedTicks (&Start);
+}
+
+/**
+  Report the latency counters of the measurements.
+
+  @param[in]  When  The boot phase at which the counters are reported.
+
+**/
+VOID
+Tcg2LatencyDump (
+  IN CONST CHAR8  *When
+  )
+{
+  UINTN  Phase;
+
+  DEBUG_CODE_BEGIN ();
+  for (Phase = 0; Phase < Tcg2LatencyMax; Phase++) {
+    DEBUG ((
+      DEBUG_INFO,
+      "Tcg2Dxe latency at %a - %a: %ld calls, %ld us\n",
+      When,
+      mTcg2LatencyName[Phase],
+      mTcg2Latency[Phase].Count,
+      DivU64x32 (GetTimeInNanoSecond (mTcg2Latency[Phase].Ticks), 1000)
+      ));
+  }
+
+  DEBUG_CODE_END ();
+}
+
 /**
   Measure PE image into TPM log based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A.
@@ -1131,9 +1211,11 @@ TcgDxeLogHashEvent (
   TCG_PCR_EVENT2  TcgPcrEvent2;
   UINT8           *DigestBuffer;
   UINT32          *EventSizePtr;
+  UINT64          Start;
 
   DEBUG ((DEBUG_INFO, "SupportedEventLogs - 0x%08x\n", mTcgDxeData.BsCap.SupportedEventLogs));
 
+  Start     = GetPerformanceCounter ();
   RetStatus = EFI_SUCCESS;
   for (Index = 0; Index < sizeof (mTcg2EventInfo)/sizeof (mTcg2EventInfo[0]); Index++) {
     if ((mTcgDxeData.BsCap.SupportedEventLogs & mTcg2EventInfo[Index].LogFormat) != 0) {
@@ -1196,6 +1278,7 @@ TcgDxeLogHashEvent (
     }
   }
 
+  Tcg2LatencyRecord (Tcg2LatencyLogEvent, Start);
   return RetStatus;
 }
 
@@ -1227,6 +1310,7 @@ TcgDxeHashLogExtendEvent (
   EFI_STATUS          Status;
   TPML_DIGEST_VALUES  DigestList;
   TCG_PCR_EVENT2_HDR  NoActionEvent;
+  UINT64              Start;
 
   if (!mTcgDxeData.BsCap.TPMPresentFlag) {
     return EFI_DEVICE_ERROR;
@@ -1246,12 +1330,14 @@ TcgDxeHashLogExtendEvent (
       //
       // Extend to NvIndex
       //
+      Start  = GetPerformanceCounter ();
       Status = HashAndExtend (
                  NewEventHdr->PCRIndex,
                  HashData,
                  (UINTN)HashDataLen,
                  &DigestList
                  );
+      Tcg2LatencyRecord (Tcg2LatencyHashExtend, Start);
       if (!EFI_ERROR (Status)) {
         Status = TcgDxeLogHashEvent (&DigestList, NewEventHdr, NewEventData);
       }
@@ -1260,12 +1346,14 @@ TcgDxeHashLogExtendEvent (
     return Status;
   }
 
+  Start  = GetPerformanceCounter ();
   Status = HashAndExtend (
              NewEventHdr->PCRIndex,
              HashData,
              (UINTN)HashDataLen,
              &DigestList
              );
+  Tcg2LatencyRecord (Tcg2LatencyHashExtend, Start);
   if (!EFI_ERROR (Status)) {
     if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
       Status = TcgDxeLogHashEvent (&DigestList, NewEventHdr, NewEventData);
@@ -1316,6 +1404,7 @@ Tcg2HashLogExtendEvent (
   EFI_STATUS          Status;
   TCG_PCR_EVENT_HDR   NewEventHdr;
   TPML_DIGEST_VALUES  DigestList;
+  UINT64              Start;
 
   DEBUG ((DEBUG_VERBOSE, "Tcg2HashLogExtendEvent ...\n"));
 
@@ -1346,12 +1435,14 @@ Tcg2HashLogExtendEvent (
   NewEventHdr.EventType = Event->Header.EventType;
   NewEventHdr.EventSize = Event->Size - sizeof (UINT32) - Event->Header.HeaderSize;
   if ((Flags & PE_COFF_IMAGE) != 0) {
+    Start  = GetPerformanceCounter ();
     Status = MeasurePeImageAndExtend (
                NewEventHdr.PCRIndex,
                DataToHash,
                (UINTN)DataToHashLen,
                &DigestList
                );
+    Tcg2LatencyRecord (Tcg2LatencyHashExtend, Start);
     if (!EFI_ERROR (Status)) {
       if ((Flags & EFI_TCG2_EXTEND_ONLY) == 0) {
         Status = TcgDxeLogHashEvent (&DigestList, &NewEventHdr, Event->Event);
@@ -1405,6 +1496,7 @@ Tcg2SubmitCommand (
   )
 {
   EFI_STATUS  Status;
+  UINT64      Start;
 
   DEBUG ((DEBUG_INFO, "Tcg2SubmitCommand ...\n"));
 
@@ -1427,12 +1519,14 @@ Tcg2SubmitCommand (
     return EFI_INVALID_PARAMETER;
   }
 
+  Start  = GetPerformanceCounter ();
   Status = Tpm2SubmitCommand (
              InputParameterBlockSize,
              InputParameterBlock,
              &OutputParameterBlockSize,
              OutputParameterBlock
              );
+  Tcg2LatencyRecord (Tcg2LatencySubmitCommand, Start);
   DEBUG ((DEBUG_INFO, "Tcg2SubmitCommand - %r\n", Status));
   return Status;
 }
@@ -2549,6 +2643,7 @@ OnReadyToBoot (
   }
 
   DEBUG ((DEBUG_INFO, "TPM2 Tcg2Dxe Measure Data when ReadyToBoot\n"));
+  Tcg2LatencyDump ("ReadyToBoot");
   //
   // Increase boot attempt counter.
   //
@@ -2595,6 +2690,8 @@ OnExitBootServices (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a not Measured. Error!\n", EFI_EXIT_BOOT_SERVICES_SUCCEEDED));
   }
+
+  Tcg2LatencyDump ("ExitBootServices");
 }
 
 /**